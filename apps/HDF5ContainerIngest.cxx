@@ -0,0 +1,223 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerSliceIngester.h"
+#include "itkMetaImageIOFactory.h"
+#include "itkPNGImageIOFactory.h"
+#include "itkRawImageIO.h"
+#include "itkTIFFImageIOFactory.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+void
+PrintUsage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [options] output slice-directory" << std::endl
+            << "Write the slice files of a directory, in name order, as an HDF5 container dataset." << std::endl
+            << std::endl
+            << "  --extension <.ext>       Only read files with this extension, e.g. .tif" << std::endl
+            << "  --path <path>            HDF5 group of the dataset, / by default" << std::endl
+            << "  --dataset <name>         Dataset name, /data by default" << std::endl
+            << "  --chunk <x,y,z>          Chunk size, fastest moving first, single slices by default" << std::endl
+            << "  --codec <none|deflate|zstd>  Compression, deflate by default" << std::endl
+            << "  --level <n>              Compression level, 5 by default" << std::endl
+            << "  --shuffle                Shuffle the bytes of each element before compression" << std::endl
+            << "  --slice-spacing <s>      Spacing between slices, 1 by default" << std::endl
+            << "  --threads <n>            Number of worker threads, the ITK default by default" << std::endl
+            << "  --overwrite              Replace an existing dataset" << std::endl
+            << "  --raw <x,y>              Read headerless raw slices of this size" << std::endl
+            << "  --raw-type <uint8|int16|uint16|float32>  Raw pixel type, uint16 by default" << std::endl
+            << "  --raw-header <bytes>     Bytes to skip at the start of each raw slice" << std::endl
+            << "  --big-endian             Raw slices are big endian" << std::endl;
+}
+
+std::vector<unsigned int>
+ParseSize(const std::string & text)
+{
+  std::vector<unsigned int> size;
+  std::stringstream         stream(text);
+  std::string               item;
+  while (std::getline(stream, item, ','))
+    size.push_back(static_cast<unsigned int>(std::stoul(item)));
+  return size;
+}
+
+// Reads raw slices of a fixed size and pixel type
+template <typename TPixel>
+itk::HDF5ContainerSliceIngester::SliceImageIOFunctionType
+MakeRawSliceImageIOFunction(const std::vector<unsigned int> & size, unsigned long headerSize, bool bigEndian)
+{
+  return [size, headerSize, bigEndian](const std::string &) {
+    using RawImageIOType = itk::RawImageIO<TPixel, 2>;
+    typename RawImageIOType::Pointer io = RawImageIOType::New();
+    io->SetDimensions(0, size[0]);
+    io->SetDimensions(1, size[1]);
+    io->SetHeaderSize(headerSize);
+    if (bigEndian)
+      io->SetByteOrderToBigEndian();
+    else
+      io->SetByteOrderToLittleEndian();
+    return itk::ImageIOBase::Pointer(io);
+  };
+}
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  // The ImageIOs slices are read with, as the tool is not built with the
+  // factory registration of an ITK application
+  itk::TIFFImageIOFactory::RegisterOneFactory();
+  itk::PNGImageIOFactory::RegisterOneFactory();
+  itk::MetaImageIOFactory::RegisterOneFactory();
+
+  itk::HDF5ContainerImageIO::Pointer output = itk::HDF5ContainerImageIO::New();
+  output->UseCompressionOn();
+
+  itk::HDF5ContainerSliceIngester::Pointer ingester = itk::HDF5ContainerSliceIngester::New();
+
+  std::vector<std::string>  arguments;
+  std::string               extension, rawType("uint16");
+  std::vector<unsigned int> rawSize;
+  unsigned long             rawHeader(0);
+  bool                      bigEndian(false);
+  try
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      const std::string arg(argv[i]);
+      const bool        hasValue(i + 1 < argc);
+
+      if (arg == "--extension" && hasValue)
+        extension = argv[++i];
+      else if (arg == "--path" && hasValue)
+        output->SetPath(argv[++i]);
+      else if (arg == "--dataset" && hasValue)
+        output->SetDataSetName(argv[++i]);
+      else if (arg == "--chunk" && hasValue)
+      {
+        output->UseChunkSizeOn();
+        output->GetChunkSize() = ParseSize(argv[++i]);
+      }
+      else if (arg == "--codec" && hasValue)
+      {
+        const std::string codec(argv[++i]);
+        if (codec == "none")
+          output->UseCompressionOff();
+        else if (codec == "zstd")
+          output->UseZstdDictionaryOn();
+        else if (codec != "deflate")
+        {
+          std::cerr << "Unknown codec: " << codec << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      else if (arg == "--level" && hasValue)
+        output->SetCompressionLevel(std::stoi(argv[++i]));
+      else if (arg == "--shuffle")
+        output->UseShuffleOn();
+      else if (arg == "--slice-spacing" && hasValue)
+        ingester->SetSliceSpacing(std::stod(argv[++i]));
+      else if (arg == "--threads" && hasValue)
+        ingester->SetNumberOfWorkUnits(static_cast<unsigned int>(std::stoul(argv[++i])));
+      else if (arg == "--overwrite")
+        output->OverwriteOn();
+      else if (arg == "--raw" && hasValue)
+        rawSize = ParseSize(argv[++i]);
+      else if (arg == "--raw-type" && hasValue)
+        rawType = argv[++i];
+      else if (arg == "--raw-header" && hasValue)
+        rawHeader = std::stoul(argv[++i]);
+      else if (arg == "--big-endian")
+        bigEndian = true;
+      else if (!arg.empty() && arg[0] != '-')
+        arguments.push_back(arg);
+      else
+      {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (const std::exception &)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (arguments.size() != 2 || (!rawSize.empty() && rawSize.size() != 2))
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (!rawSize.empty())
+  {
+    if (rawType == "uint8")
+      ingester->SetSliceImageIOFunction(MakeRawSliceImageIOFunction<unsigned char>(rawSize, rawHeader, bigEndian));
+    else if (rawType == "int16")
+      ingester->SetSliceImageIOFunction(MakeRawSliceImageIOFunction<short>(rawSize, rawHeader, bigEndian));
+    else if (rawType == "uint16")
+      ingester->SetSliceImageIOFunction(MakeRawSliceImageIOFunction<unsigned short>(rawSize, rawHeader, bigEndian));
+    else if (rawType == "float32")
+      ingester->SetSliceImageIOFunction(MakeRawSliceImageIOFunction<float>(rawSize, rawHeader, bigEndian));
+    else
+    {
+      std::cerr << "Unknown raw type: " << rawType << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Slices are ordered by file name
+  std::vector<std::string> fileNames;
+  std::error_code          error;
+  for (const auto & entry : std::filesystem::directory_iterator(arguments[1], error))
+  {
+    if (entry.is_regular_file(error) && (extension.empty() || entry.path().extension() == extension))
+      fileNames.push_back(entry.path().string());
+  }
+  if (error || fileNames.empty())
+  {
+    std::cerr << "No slices found in " << arguments[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::sort(fileNames.begin(), fileNames.end());
+
+  output->SetFileName(arguments[0]);
+  ingester->SetFileNames(fileNames);
+  ingester->SetOutputImageIO(output);
+  try
+  {
+    ingester->Ingest();
+  }
+  catch (const itk::ExceptionObject & exception)
+  {
+    std::cerr << "Unable to ingest " << arguments[1] << ": " << exception.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Wrote " << fileNames.size() << " slices to " << arguments[0] << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerLayoutAdvisor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+void
+PrintUsage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [options] trace" << std::endl
+            << "Recommend a chunk layout from a trace recorded with SetAccessTraceFileName()." << std::endl
+            << std::endl
+            << "  --chunk <x,y,z,...>  Candidate chunk size, fastest moving first, may be repeated" << std::endl
+            << "  --cache <bytes>      Candidate chunk cache size, may be repeated" << std::endl
+            << "  --overhead <bytes>   Cost charged per chunk read, 65536 by default" << std::endl
+            << "  --cache-cost <c>     Cost charged per byte of chunk cache, 1 by default" << std::endl
+            << "  --memory <bytes>     Largest chunk cache size tried, unlimited by default" << std::endl
+            << "  --top <n>            Number of layouts listed, 10 by default" << std::endl;
+}
+
+std::vector<unsigned int>
+ParseChunkSize(const std::string & text)
+{
+  std::vector<unsigned int> size;
+  std::stringstream         stream(text);
+  std::string               item;
+  while (std::getline(stream, item, ','))
+    size.push_back(static_cast<unsigned int>(std::stoul(item)));
+  return size;
+}
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  itk::HDF5ContainerLayoutAdvisor::Pointer advisor = itk::HDF5ContainerLayoutAdvisor::New();
+
+  std::vector<std::string> fileNames;
+  size_t                   top(10);
+  try
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      const std::string arg(argv[i]);
+      const bool        hasValue(i + 1 < argc);
+
+      if (arg == "--chunk" && hasValue)
+        advisor->AddCandidateChunkSize(ParseChunkSize(argv[++i]));
+      else if (arg == "--cache" && hasValue)
+        advisor->AddCandidateCacheSize(std::stoull(argv[++i]));
+      else if (arg == "--overhead" && hasValue)
+        advisor->SetChunkOverhead(std::stoull(argv[++i]));
+      else if (arg == "--cache-cost" && hasValue)
+        advisor->SetCacheCost(std::stod(argv[++i]));
+      else if (arg == "--memory" && hasValue)
+        advisor->SetMemoryBudget(std::stoull(argv[++i]));
+      else if (arg == "--top" && hasValue)
+        top = std::stoul(argv[++i]);
+      else if (!arg.empty() && arg[0] != '-')
+        fileNames.push_back(arg);
+      else
+      {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (const std::exception &)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (fileNames.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  advisor->SetTraceFileName(fileNames[0]);
+  try
+  {
+    advisor->Evaluate();
+  }
+  catch (const itk::ExceptionObject & error)
+  {
+    std::cerr << "Unable to evaluate " << fileNames[0] << ": " << error.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto & evaluations(advisor->GetEvaluations());
+  std::cout << advisor->GetNumberOfAccesses() << " accesses replayed against " << evaluations.size() << " layouts"
+            << std::endl
+            << std::setw(20) << "chunk" << std::setw(14) << "cache" << std::setw(14) << "touched" << std::setw(14)
+            << "read" << std::setw(18) << "decompressed" << std::setw(10) << "hit rate" << std::endl;
+  for (size_t i = 0; i < std::min(top, evaluations.size()); i++)
+  {
+    const auto & evaluation(evaluations[i]);
+    std::cout << std::setw(20) << itk::HDF5ContainerLayoutAdvisor::FormatChunkSize(evaluation.ChunkSize)
+              << std::setw(14) << evaluation.CacheSize << std::setw(14) << evaluation.ChunksTouched << std::setw(14)
+              << evaluation.ChunksRead << std::setw(18) << evaluation.BytesDecompressed << std::setw(10)
+              << std::fixed << std::setprecision(3) << evaluation.HitRate << std::endl;
+  }
+
+  // Given as is to HDF5ContainerRepack
+  std::cout << "Recommended: --chunk "
+            << itk::HDF5ContainerLayoutAdvisor::FormatChunkSize(advisor->GetRecommendedChunkSize())
+            << " with a chunk cache of " << advisor->GetRecommendedCacheSize() << " bytes" << std::endl;
+
+  return EXIT_SUCCESS;
+}
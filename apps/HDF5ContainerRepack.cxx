@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerRepacker.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+void
+PrintUsage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [options] input output" << std::endl
+            << "Rewrite an HDF5 container dataset with another chunk layout or codec." << std::endl
+            << std::endl
+            << "  --path <path>            HDF5 group of the input dataset, / by default" << std::endl
+            << "  --dataset <name>         Input dataset name, /data by default" << std::endl
+            << "  --output-path <path>     HDF5 group of the output dataset, that of the input by default" << std::endl
+            << "  --output-dataset <name>  Output dataset name, that of the input by default" << std::endl
+            << "  --chunk <x,y,z,...>      Chunk size, fastest moving first, that of the input by default"
+            << std::endl
+            << "  --codec <none|deflate|zstd>  Compression, deflate by default" << std::endl
+            << "  --level <n>              Compression level, 5 by default" << std::endl
+            << "  --shuffle                Shuffle the bytes of each element before compression" << std::endl
+            << "  --threads <n>            Number of worker threads, the ITK default by default" << std::endl
+            << "  --overwrite              Replace an existing output dataset" << std::endl;
+}
+
+std::vector<unsigned int>
+ParseChunkSize(const std::string & text)
+{
+  std::vector<unsigned int> size;
+  std::stringstream         stream(text);
+  std::string               item;
+  while (std::getline(stream, item, ','))
+    size.push_back(static_cast<unsigned int>(std::stoul(item)));
+  return size;
+}
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  itk::HDF5ContainerImageIO::Pointer input = itk::HDF5ContainerImageIO::New();
+  itk::HDF5ContainerImageIO::Pointer output = itk::HDF5ContainerImageIO::New();
+  output->UseCompressionOn();
+
+  itk::HDF5ContainerRepacker::Pointer repacker = itk::HDF5ContainerRepacker::New();
+
+  std::vector<std::string> fileNames;
+  std::string              outputPath, outputDataSet;
+  try
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      const std::string arg(argv[i]);
+      const bool        hasValue(i + 1 < argc);
+
+      if (arg == "--path" && hasValue)
+        input->SetPath(argv[++i]);
+      else if (arg == "--dataset" && hasValue)
+        input->SetDataSetName(argv[++i]);
+      else if (arg == "--output-path" && hasValue)
+        outputPath = argv[++i];
+      else if (arg == "--output-dataset" && hasValue)
+        outputDataSet = argv[++i];
+      else if (arg == "--chunk" && hasValue)
+      {
+        output->UseChunkSizeOn();
+        output->GetChunkSize() = ParseChunkSize(argv[++i]);
+      }
+      else if (arg == "--codec" && hasValue)
+      {
+        const std::string codec(argv[++i]);
+        if (codec == "none")
+          output->UseCompressionOff();
+        else if (codec == "zstd")
+          output->UseZstdDictionaryOn();
+        else if (codec != "deflate")
+        {
+          std::cerr << "Unknown codec: " << codec << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      else if (arg == "--level" && hasValue)
+        output->SetCompressionLevel(std::stoi(argv[++i]));
+      else if (arg == "--shuffle")
+        output->UseShuffleOn();
+      else if (arg == "--threads" && hasValue)
+        repacker->SetNumberOfWorkUnits(static_cast<unsigned int>(std::stoul(argv[++i])));
+      else if (arg == "--overwrite")
+        output->OverwriteOn();
+      else if (!arg.empty() && arg[0] != '-')
+        fileNames.push_back(arg);
+      else
+      {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (const std::exception &)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (fileNames.size() != 2)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  input->SetFileName(fileNames[0]);
+  output->SetFileName(fileNames[1]);
+  output->SetPath(outputPath.empty() ? input->GetPath() : outputPath.c_str());
+  output->SetDataSetName(outputDataSet.empty() ? input->GetDataSetName() : outputDataSet.c_str());
+
+  repacker->SetInputImageIO(input);
+  repacker->SetOutputImageIO(output);
+  try
+  {
+    repacker->Repack();
+  }
+  catch (const itk::ExceptionObject & error)
+  {
+    std::cerr << "Unable to repack " << fileNames[0] << ": " << error.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(HDF5Container_USE_MPI)
+#  include <mpi.h>
+#endif
+
+namespace
+{
+using FileDriverEnum = itk::HDF5ContainerImageIO::FileDriverEnum;
+
+void
+PrintUsage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [options] output" << std::endl
+            << "Write a synthetic volume with each file driver and report the aggregate bandwidth." << std::endl
+            << "Each driver writes its own container, named after output, which is left in place." << std::endl
+            << std::endl
+            << "  --size <x,y,z>           Volume size, 1024,1024,1024 by default" << std::endl
+            << "  --chunk <x,y,z>          Chunk size, fastest moving first, x,y,16 by default" << std::endl
+            << "  --slab <n>               Slices written by each Write(), the chunk depth by default" << std::endl
+            << "  --drivers <list>         Comma separated drivers among sec2, family, split and subfiling,"
+            << std::endl
+            << "                           sec2,family by default" << std::endl
+            << "  --member-size <bytes>    Size of the family member files, 1GB by default" << std::endl
+            << "  --compress               Compress the chunks with deflate" << std::endl
+#if defined(HDF5Container_USE_MPI)
+            << "  --mpi                    Write collectively from all the MPI processes, each writing" << std::endl
+            << "                           its own block of slabs" << std::endl
+#endif
+      ;
+}
+
+std::vector<std::string>
+Split(const std::string & text)
+{
+  std::vector<std::string> items;
+  std::stringstream        stream(text);
+  std::string              item;
+  while (std::getline(stream, item, ','))
+    items.push_back(item);
+  return items;
+}
+
+std::vector<unsigned int>
+ParseSize(const std::string & text)
+{
+  std::vector<unsigned int> size;
+  for (const auto & item : Split(text))
+    size.push_back(static_cast<unsigned int>(std::stoul(item)));
+  return size;
+}
+
+// Each driver writes a container of its own, e.g. volume-family.h5
+std::string
+DriverOutputFileName(const std::string & fileName, const std::string & driver)
+{
+  const std::filesystem::path path(fileName);
+  return ((path.parent_path() / path.stem()).string() + '-' + driver + path.extension().string());
+}
+
+double
+GetSeconds()
+{
+#if defined(HDF5Container_USE_MPI)
+  return MPI_Wtime();
+#else
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void
+Barrier(bool useMPIIO)
+{
+#if defined(HDF5Container_USE_MPI)
+  if (useMPIIO)
+    MPI_Barrier(MPI_COMM_WORLD);
+#else
+  (void)useMPIIO;
+#endif
+}
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  int rank(0), processes(1);
+#if defined(HDF5Container_USE_MPI)
+  // The subfiling driver drives its I/O concentrators from threads
+  int provided(0);
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &processes);
+#endif
+
+  std::vector<unsigned int> size{ 1024, 1024, 1024 };
+  std::vector<unsigned int> chunk;
+  unsigned int              slab(0);
+  std::vector<std::string>  drivers{ "sec2", "family" };
+  itk::SizeValueType        memberSize(itk::SizeValueType(1) << 30);
+  bool                      compress(false);
+  bool                      useMPIIO(false);
+  std::string               fileName;
+  int                       result(EXIT_SUCCESS);
+  try
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      const std::string arg(argv[i]);
+      const bool        hasValue(i + 1 < argc);
+
+      if (arg == "--size" && hasValue)
+        size = ParseSize(argv[++i]);
+      else if (arg == "--chunk" && hasValue)
+        chunk = ParseSize(argv[++i]);
+      else if (arg == "--slab" && hasValue)
+        slab = static_cast<unsigned int>(std::stoul(argv[++i]));
+      else if (arg == "--drivers" && hasValue)
+        drivers = Split(argv[++i]);
+      else if (arg == "--member-size" && hasValue)
+        memberSize = std::stoull(argv[++i]);
+      else if (arg == "--compress")
+        compress = true;
+#if defined(HDF5Container_USE_MPI)
+      else if (arg == "--mpi")
+        useMPIIO = true;
+#endif
+      else if (!arg.empty() && arg[0] != '-' && fileName.empty())
+        fileName = arg;
+      else
+        result = EXIT_FAILURE;
+    }
+  }
+  catch (const std::exception &)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  if (chunk.empty())
+    chunk = { size.size() > 0 ? size[0] : 0, size.size() > 1 ? size[1] : 0, 16 };
+  if (slab == 0 && chunk.size() == 3)
+    slab = chunk[2];
+  if (!useMPIIO)
+    processes = 1;
+
+  // Each process writes a block of whole slabs
+  if (result == EXIT_SUCCESS &&
+      (fileName.empty() || size.size() != 3 || chunk.size() != 3 || slab == 0 || size[2] % (slab * processes) != 0))
+    result = EXIT_FAILURE;
+
+  if (result != EXIT_SUCCESS && rank == 0)
+    PrintUsage(argv[0]);
+
+  const itk::SizeValueType    slabPixels(result == EXIT_SUCCESS ? itk::SizeValueType(size[0]) * size[1] * slab : 0);
+  const itk::SizeValueType    slabsPerProcess(result == EXIT_SUCCESS ? size[2] / slab / processes : 0);
+  std::vector<unsigned short> buffer(slabPixels);
+  const itk::SizeValueType    volumeBytes(slabPixels * slabsPerProcess * processes * sizeof(unsigned short));
+  for (itk::SizeValueType i = 0; i < buffer.size(); i++)
+    buffer[i] = static_cast<unsigned short>(i % 4093);
+
+  for (const auto & driverName : drivers)
+  {
+    if (result != EXIT_SUCCESS)
+      break;
+
+    FileDriverEnum driver(FileDriverEnum::SEC2);
+    if (driverName == "family")
+      driver = FileDriverEnum::Family;
+    else if (driverName == "subfiling")
+      driver = FileDriverEnum::Subfiling;
+    else if (driverName == "split")
+      driver = FileDriverEnum::Split;
+    else if (driverName != "sec2")
+    {
+      if (rank == 0)
+        std::cerr << "Unknown driver: " << driverName << std::endl;
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    try
+    {
+      itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+      io->SetFileName(DriverOutputFileName(fileName, driverName));
+      io->SetFileDriver(driver);
+      io->SetFamilyMemberSize(memberSize);
+      io->SetUseMPIIO(useMPIIO);
+      io->ReCreateOn();
+      io->OverwriteOn();
+      io->SetNumberOfDimensions(3);
+      for (unsigned int i = 0; i < 3; i++)
+        io->SetDimensions(i, size[i]);
+      io->SetComponentType(itk::IOComponentEnum::USHORT);
+      io->SetPixelType(itk::IOPixelEnum::SCALAR);
+      io->SetNumberOfComponents(1);
+      io->SetUseCompression(compress);
+      io->UseChunkSizeOn();
+      io->GetChunkSize() = chunk;
+
+      Barrier(useMPIIO);
+      const double start(GetSeconds());
+
+      io->WriteImageInformation();
+      for (itk::SizeValueType i = 0; i < slabsPerProcess; i++)
+      {
+        itk::ImageIORegion region(3);
+        region.SetIndex(2, static_cast<itk::IndexValueType>((rank * slabsPerProcess + i) * slab));
+        region.SetSize(0, size[0]);
+        region.SetSize(1, size[1]);
+        region.SetSize(2, slab);
+        io->SetIORegion(region);
+        io->Write(buffer.data());
+      }
+
+      // Closing the file flushes what libhdf5 still holds
+      io = itk::HDF5ContainerImageIO::Pointer();
+      Barrier(useMPIIO);
+      const double seconds(GetSeconds() - start);
+
+      if (rank == 0)
+        std::cout << std::left << std::setw(10) << driverName << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << seconds << " s " << std::setw(10)
+                  << static_cast<double>(volumeBytes) / (1024.0 * 1024.0) / seconds << " MB/s" << std::endl;
+    }
+    catch (const itk::ExceptionObject & error)
+    {
+      std::cerr << "Unable to write with the " << driverName << " driver: " << error.GetDescription() << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+
+#if defined(HDF5Container_USE_MPI)
+  MPI_Finalize();
+#endif
+
+  return result;
+}
@@ -0,0 +1,119 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerChunkProcessor_h
+#define itkHDF5ContainerChunkProcessor_h
+#include "HDF5ContainerExport.h"
+
+#include "itkHDF5ContainerImageIO.h"
+
+#include <functional>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerChunkProcessor
+ *
+ * \brief Apply a function to each chunk of a dataset on a thread pool.
+ *
+ * The chunks of the input dataset are read and decoded by the worker
+ * threads and passed to the chunk function, which fills the matching
+ * chunk of the output, if any. The output dataset takes the geometry and
+ * chunking of the input, and the input component type unless the output
+ * ImageIO sets one. Memory use scales with the number of threads times
+ * the chunk size, rather than with the image size. The calls the worker
+ * threads make into libhdf5, through the input and output alike, are
+ * serialized by HDF5ContainerImageIO::GetLibraryMutex().
+ *
+ * A non-zero Halo extends the input region passed to the function by that
+ * many pixels along each dimension, clipped to the image, for
+ * neighbourhood operations. Chunks with a halo are read through libhdf5,
+ * which decodes them one at a time.
+ *
+ * The output should be a different file from the input.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5Container_EXPORT HDF5ContainerChunkProcessor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HDF5ContainerChunkProcessor);
+
+  /** Standard class type aliases. */
+  using Self = HDF5ContainerChunkProcessor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HDF5ContainerChunkProcessor, Object);
+
+  /** Called with the input pixels of inputRegion, which holds the chunk
+   * region and its halo, and the output pixels of the chunk region.
+   * output is nullptr when there is no output ImageIO. Pixel components
+   * are interleaved, fastest moving dimension first */
+  using ChunkFunctionType = std::function<
+    void(const ImageIORegion & inputRegion, const void * input, const ImageIORegion & region, void * output)>;
+
+  /** Set/Get the ImageIO the input dataset is read from. Its FileName and
+   * DataSetName select the dataset, which must be chunked */
+  itkSetObjectMacro(InputImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(InputImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the ImageIO the output dataset is written to, optional */
+  itkSetObjectMacro(OutputImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(OutputImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the halo, in pixels */
+  itkSetMacro(Halo, unsigned int);
+  itkGetConstMacro(Halo, unsigned int);
+
+  /** Set/Get the number of worker threads, 0 uses the ITK default */
+  itkSetMacro(NumberOfWorkUnits, unsigned int);
+  itkGetConstMacro(NumberOfWorkUnits, unsigned int);
+
+  void
+  SetChunkFunction(const ChunkFunctionType & function)
+  {
+    this->m_ChunkFunction = function;
+    this->Modified();
+  }
+
+  /** Process every chunk of the input */
+  void
+  Process();
+
+protected:
+  HDF5ContainerChunkProcessor() = default;
+  ~HDF5ContainerChunkProcessor() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  HDF5ContainerImageIO::Pointer m_InputImageIO;
+  HDF5ContainerImageIO::Pointer m_OutputImageIO;
+  unsigned int                  m_Halo{ 0 };
+  unsigned int                  m_NumberOfWorkUnits{ 0 };
+  ChunkFunctionType             m_ChunkFunction;
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerChunkProcessor_h
@@ -28,9 +28,16 @@
 #include "HDF5ContainerExport.h"
 #include "itkMetaDataDictionary.h"
 #include "itkMetaDataObjectBase.h"
+#include <cstdint>
 #include <ctime>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #define MCT_METADATA_ATTR_CHAR '@'
 #define MCT_METADATA_TIMESTAMP_ATTR "timestamp"
@@ -46,10 +53,20 @@ class DataSpace;
 class DataSet;
 class Group;
 class FileAccPropList;
+class DSetMemXferPropList;
 class H5Object;
 
 } // namespace H5
 
+namespace itk
+{
+class HDF5ContainerAccessTrace;
+class HDF5ContainerChunkCodec;
+class HDF5ContainerChunkGrid;
+class HDF5ContainerHistogram;
+class HDF5ContainerProjections;
+} // namespace itk
+
 #include "itkStreamingImageIOBase.h"
 
 namespace itk
@@ -110,6 +127,345 @@ public:
   itkGetMacro(UseDataSetStride, bool);
   itkSetMacro(UseDataSetStride, bool);
   itkBooleanMacro(UseDataSetStride);
+  itkGetMacro(UseChunkSize, bool);
+  itkSetMacro(UseChunkSize, bool);
+  itkBooleanMacro(UseChunkSize);
+
+  /** Set/Get update mode. If the dataset already exists, and ReCreate is
+   * off, WriteImageInformation() opens it rather than creating it, after
+   * checking that its component type, number of components and
+   * dimensions match those set. Write() then changes only the pixels of
+   * the IORegion, so only the chunks it touches are rewritten, as
+   * ImageFileWriter does when pasting a region with SetIORegion(). The
+   * options applied when a dataset is created (sparse, statistics,
+   * projections, write combining) are not, and the statistics,
+   * fingerprints, chunk statistics, projections and thumbnails stored
+   * with the dataset are removed rather than left stale. A dataset that
+   * does not exist yet is created as usual */
+  itkGetMacro(UseUpdate, bool);
+  itkSetMacro(UseUpdate, bool);
+  itkBooleanMacro(UseUpdate);
+
+  /** Set/Get checkpointed writing. The chunks completed by Write() are
+   * recorded in an attribute of the dataset, after flushing the file, at
+   * most every CheckpointInterval seconds, once the image is complete
+   * and when the file is closed. Regions are expected to be written once.
+   * If the writer is interrupted, writing the same dataset again with
+   * checkpoints on, and ReCreate off, resumes it: the dataset is opened
+   * as in update mode and Write() skips regions whose chunks were all
+   * completed. Resuming is refused with UseChunkStatistics,
+   * UseImageStatistics or UseProjections, which would miss the regions
+   * written before the interruption. The checkpoint is removed once
+   * every chunk is complete, a complete dataset is not resumed but
+   * written again, which needs Overwrite. The dataset is always chunked */
+  itkGetMacro(UseCheckpoints, bool);
+  itkSetMacro(UseCheckpoints, bool);
+  itkBooleanMacro(UseCheckpoints);
+
+  /** Set/Get the time in seconds between checkpoints, 60 by default */
+  itkGetMacro(CheckpointInterval, double);
+  itkSetMacro(CheckpointInterval, double);
+
+  /** Read the checkpoint of the dataset of FileName, before writing it
+   * again. Returns false if there is none, e.g. the dataset does not
+   * exist or was completed. IsRegionCompleted() then tells which regions need not be
+   * produced again */
+  bool
+  ReadCheckpoint();
+
+  /** True if every chunk of the region was completed according to the
+   * checkpoint read, or the chunks written since */
+  bool
+  IsRegionCompleted(const ImageIORegion & region);
+
+  /** Set/Get chunk content hashes. A 64 bit hash of every chunk a region
+   * written covers whole is stored beside the dataset. In update mode,
+   * Write() hashes the chunks the region covers whole and skips those
+   * whose hash matches the one stored, so writing unchanged data again
+   * costs hashing only. Chunks written partly lose their hash, regions
+   * should follow chunk boundaries. The dataset is always chunked */
+  itkGetMacro(UseChunkHashes, bool);
+  itkSetMacro(UseChunkHashes, bool);
+  itkBooleanMacro(UseChunkHashes);
+
+  /** Number of chunks Write() skipped as unchanged since the dataset was
+   * opened */
+  itkGetConstMacro(NumberOfChunksSkipped, SizeValueType);
+
+  /** Set/Get chunk checksums. When writing, a 64 bit checksum of the
+   * stored (compressed) bytes of every chunk written is kept in a dataset
+   * beside the image. They are computed by a pool of threads when the
+   * file is closed, or by the caller of WriteRawChunk(). When reading,
+   * ReadChunk() and Read() verify the stored bytes of each chunk they
+   * read against its checksum, and throw if they differ. Read() then
+   * assembles the region from chunks as with UseSharedChunkCache. Unlike
+   * the Fletcher32 filter, libhdf5 is not involved. The dataset is always
+   * chunked */
+  itkGetMacro(UseChunkChecksums, bool);
+  itkSetMacro(UseChunkChecksums, bool);
+  itkBooleanMacro(UseChunkChecksums);
+
+  /** Verify the stored bytes of every chunk of the dataset against the
+   * checksums written with UseChunkChecksums, without decoding them.
+   * Chunks are read one at a time and checked by a pool of threads.
+   * Returns the regions of the chunks found corrupt, empty if there are
+   * none. ReadImageInformation() must be called first */
+  std::vector<ImageIORegion>
+  VerifyDataSet();
+
+  /** Set/Get whether compressed datasets use Zstandard with a dictionary
+   * trained from the chunks of the first region written. This improves
+   * the compression ratio of small chunks, which are otherwise compressed
+   * in isolation. Compression levels range up to the Zstandard maximum
+   * when the module is built with HDF5Container_USE_ZSTD, which this
+   * requires. Deflate uses at most level 9 */
+  itkGetMacro(UseZstdDictionary, bool);
+  itkSetMacro(UseZstdDictionary, bool);
+  itkBooleanMacro(UseZstdDictionary);
+
+  /** Set/Get whether compressed datasets apply the shuffle filter before
+   * compression, storing the bytes of each element together, which
+   * usually improves the ratio for multi-byte components */
+  itkGetMacro(UseShuffle, bool);
+  itkSetMacro(UseShuffle, bool);
+  itkBooleanMacro(UseShuffle);
+
+  /** Set/Get the maximum size in bytes of a trained Zstandard dictionary */
+  itkGetMacro(ZstdDictionaryCapacity, unsigned int);
+  itkSetMacro(ZstdDictionaryCapacity, unsigned int);
+
+  /** Train the Zstandard dictionary from the pixels of a region, each
+   * chunk's share of it being one sample. Write() trains it from the
+   * first region written; writers which create the dataset themselves,
+   * e.g. HDF5ContainerRegionWriter, call this before
+   * WriteImageInformation() instead, ideally with a layer of whole
+   * chunks. Does nothing unless UseCompression and UseZstdDictionary are
+   * on, and throws once the image information is written */
+  void
+  TrainZstdDictionary(const ImageIORegion & region, const void * buffer);
+
+  /** Set/Get sparse mode. Chunks whose contents all equal the fill value
+   * are not written, the dataset is created with incremental allocation
+   * and a fill time of never, and Read() fills unallocated chunks with a
+   * memset rather than passing them through the filter pipeline */
+  itkGetMacro(UseSparse, bool);
+  itkSetMacro(UseSparse, bool);
+  itkBooleanMacro(UseSparse);
+
+  /** Set/Get whether Write() gathers regions that cover chunks only
+   * partly, e.g. single slices streamed into cubic chunks, and writes each
+   * chunk once it is complete. libhdf5 otherwise reads, decompresses,
+   * merges and compresses such chunks again for every region. Regions are
+   * expected to be disjoint, and with slabs along the slowest axis at most
+   * one row of chunks is held. Chunks still incomplete are written, the
+   * rest filled with the fill value, by FlushWriteCombining() or when the
+   * file is closed */
+  itkGetMacro(UseWriteCombining, bool);
+  itkSetMacro(UseWriteCombining, bool);
+  itkBooleanMacro(UseWriteCombining);
+
+  /** Write the chunks held by the write combining buffer */
+  void
+  FlushWriteCombining();
+
+  /** Set/Get the fill value of the dataset, held by the parts of chunks
+   * never written and, with UseSparse, by the chunks never allocated. This
+   * is also the background value of the chunk statistics */
+  itkGetMacro(FillValue, double);
+  itkSetMacro(FillValue, double);
+
+  /** Set/Get whether Write() computes the statistics of each chunk while
+   * it holds the pixel data, and stores them in a dataset beside the
+   * image. Each region is expected to be written once, as ImageFileWriter
+   * does. Vector image components are pooled */
+  itkGetMacro(UseChunkStatistics, bool);
+  itkSetMacro(UseChunkStatistics, bool);
+  itkBooleanMacro(UseChunkStatistics);
+
+  /** Set/Get whether Write() accumulates the minimum, maximum, mean,
+   * standard deviation and histogram of the image. They are stored as
+   * attributes of the dataset once the whole image has been written, and
+   * ReadImageInformation() adds them to the metadata dictionary */
+  itkGetMacro(UseImageStatistics, bool);
+  itkSetMacro(UseImageStatistics, bool);
+  itkBooleanMacro(UseImageStatistics);
+
+  /** Set/Get the number of histogram bins. The histogram is stored as an
+   * attribute, which limits it to 4096 bins */
+  itkGetMacro(NumberOfHistogramBins, unsigned int);
+  itkSetClampMacro(NumberOfHistogramBins, unsigned int, 2, 4096);
+
+  /** Set/Get whether Write() accumulates the maximum intensity projection
+   * along each axis, and a thumbnail of the central slice. Once the whole
+   * image has been written they are stored as small datasets beside the
+   * image, named after it with the suffixes _MaximumProjection<axis>,
+   * _MaximumProjectionThumbnail<axis> and _Thumbnail. They carry Spacing,
+   * Origin and Dimension attributes, so can be read by this class by
+   * setting DataSetName */
+  itkGetMacro(UseProjections, bool);
+  itkSetMacro(UseProjections, bool);
+  itkBooleanMacro(UseProjections);
+
+  /** Set/Get whether mean projections (_MeanProjection<axis>, float) are
+   * stored along with the maximum projections */
+  itkGetMacro(UseMeanProjections, bool);
+  itkSetMacro(UseMeanProjections, bool);
+  itkBooleanMacro(UseMeanProjections);
+
+  /** Set/Get the largest dimension of the thumbnails */
+  itkGetMacro(ThumbnailSize, unsigned int);
+  itkSetClampMacro(ThumbnailSize, unsigned int, 1, 65535);
+
+  /** Set/Get whether chunks are read through the cache of decoded chunks
+   * shared by all instances in the process. Read() then assembles the
+   * region from decoded chunks, unless a dataset offset or stride is used,
+   * and ReadChunk() returns cached chunks. Only chunked datasets whose
+   * filters can be decoded outside of libhdf5 are cached, and only while
+   * their file is open read-only: chunks rewritten in place may keep
+   * their address and size, which identify them in the cache */
+  itkGetMacro(UseSharedChunkCache, bool);
+  itkSetMacro(UseSharedChunkCache, bool);
+  itkBooleanMacro(UseSharedChunkCache);
+
+  /** Counters and memory use of the shared chunk cache. CompressedHits
+   * are chunks found in their stored form, which still need decoding */
+  struct SharedChunkCacheStatisticsType
+  {
+    SizeValueType Hits{ 0 };
+    SizeValueType CompressedHits{ 0 };
+    SizeValueType Misses{ 0 };
+    SizeValueType DecodedBytes{ 0 };
+    SizeValueType CompressedBytes{ 0 };
+  };
+
+  /** Set the byte budgets of the decoded chunks held by the shared cache,
+   * and of the stored (compressed) chunks evicted from it */
+  static void
+  SetSharedChunkCacheCapacity(SizeValueType decodedBytes, SizeValueType compressedBytes);
+
+  static SharedChunkCacheStatisticsType
+  GetSharedChunkCacheStatistics();
+
+  /** Drop every chunk held by the shared cache and reset its counters */
+  static void
+  ClearSharedChunkCache();
+
+  /** Set/Get a directory on local storage in which stored (compressed)
+   * chunks read from the file are kept, for containers on network or
+   * parallel filesystems. Later reads, by this or any other process, take
+   * the chunks from there. Entries are keyed by the path, size and
+   * modification time of the file and the location of the chunk within
+   * it, so a modified file does not match. Read() assembles the region
+   * from chunks as with UseSharedChunkCache. Empty, the default, disables
+   * the cache */
+  itkGetStringMacro(LocalChunkCacheDirectory);
+  itkSetStringMacro(LocalChunkCacheDirectory);
+
+  /** Set/Get the size the local chunk cache directory is kept under, the
+   * least recently used entries are removed beyond it. The default is
+   * 10GB */
+  itkGetMacro(LocalChunkCacheCapacity, SizeValueType);
+  itkSetMacro(LocalChunkCacheCapacity, SizeValueType);
+
+  /** Set/Get the file the regions read are recorded to, for
+   * HDF5ContainerLayoutAdvisor. Once ReadImageInformation() is called,
+   * every region read by Read(), ReadRegion() and ReadChunk() is appended
+   * to it, and a trace recorded for an image of other dimensions is
+   * replaced. Empty, the default, records nothing */
+  itkGetStringMacro(AccessTraceFileName);
+  itkSetStringMacro(AccessTraceFileName);
+
+  /** Set/Get whether the file is accessed through MPI-IO by all the
+   * processes of MPI_COMM_WORLD together, each writing or reading its own
+   * IORegion of the same dataset. WriteImageInformation(), Write() and
+   * Read() are then collective, every process must call them the same
+   * number of times with the same image information. Options keeping
+   * state gathered from the regions written, e.g. UseSparse or
+   * UseChunkStatistics, are refused, and reads bypass the chunk caches.
+   * Requires the module to be built with HDF5Container_USE_MPI against a
+   * parallel HDF5, and MPI_Init() to have been called */
+  itkGetMacro(UseMPIIO, bool);
+  itkSetMacro(UseMPIIO, bool);
+  itkBooleanMacro(UseMPIIO);
+
+  /** Return whether the module was built with MPI-IO support */
+  static bool
+  IsMPIIOAvailable();
+
+  /** File drivers a container can be written with */
+  enum class FileDriverEnum : uint8_t
+  {
+    /** A single file, the default */
+    SEC2,
+    /** Member files of FamilyMemberSize bytes named after FileName, with
+     * the index of the member before the extension, e.g. image-00000.h5
+     * for image.h5. Each member is locked and striped on its own */
+    Family,
+    /** Subfiles striped across the nodes of the MPI processes, beside a
+     * stub FileName. Requires UseMPIIO, MPI initialized with
+     * MPI_THREAD_MULTIPLE and a parallel HDF5 with the subfiling driver */
+    Subfiling,
+    /** The metadata in FileName.meta and the chunks in FileName.raw. The
+     * metadata file is small, it is read whole when the container is
+     * opened and may be moved to fast storage behind a symbolic link */
+    Split
+  };
+
+  /** Set/Get the file driver new containers are written with, SEC2 by
+   * default. Existing containers are opened with the driver they were
+   * written with, found from the files present, so ReadImageInformation()
+   * and writes adding to a container need not set it */
+  itkSetEnumMacro(FileDriver, FileDriverEnum);
+  itkGetEnumMacro(FileDriver, FileDriverEnum);
+
+  /** Set/Get the size in bytes of the member files of Family containers,
+   * 1GB by default */
+  itkGetMacro(FamilyMemberSize, SizeValueType);
+  itkSetMacro(FamilyMemberSize, SizeValueType);
+
+  /** Return whether containers can be written with the Subfiling driver */
+  static bool
+  IsSubfilingAvailable();
+
+  /** Set/Get whether single file containers keep out of the page cache,
+   * so streaming a large volume does not evict the pages of other
+   * processes. Only with a libhdf5 providing the direct driver, see
+   * IsDirectIOAvailable(), is this direct I/O: the file is opened with
+   * O_DIRECT, objects of at least a block are aligned to the block size
+   * of the filesystem and unaligned transfers are copied through an
+   * aligned buffer. Otherwise, IsDirectIOAvailable() being false,
+   * transfers still go through the page cache and nothing is aligned:
+   * after each Write() and Read() the pages of the chunks, or of the span
+   * of a contiguous dataset, just transferred are dropped from the cache
+   * with posix_fadvise(), where the platform has it. The file is not
+   * synchronised, dirty pages are dropped once written back. Ignored with
+   * UseMPIIO */
+  itkGetMacro(UseDirectIO, bool);
+  itkSetMacro(UseDirectIO, bool);
+  itkBooleanMacro(UseDirectIO);
+
+  /** Return whether UseDirectIO opens files with the direct driver,
+   * rather than dropping their pages from the cache after each transfer */
+  static bool
+  IsDirectIOAvailable();
+
+  /** Statistics of the pixels of a chunk, or of the whole image.
+   * ForegroundCount is the number of components differing from the
+   * background (fill) value */
+  struct ChunkStatisticsType
+  {
+    double        Minimum{ std::numeric_limits<double>::max() };
+    double        Maximum{ std::numeric_limits<double>::lowest() };
+    double        Sum{ 0.0 };
+    SizeValueType Count{ 0 };
+    SizeValueType ForegroundCount{ 0 };
+
+    double
+    GetMean() const
+    {
+      return Count > 0 ? Sum / static_cast<double>(Count) : 0.0;
+    }
+  };
 
   std::vector<unsigned int> &
   GetDataSetOffset()
@@ -129,6 +485,14 @@ public:
     return m_DataSetStride;
   }
 
+  /** Chunk dimensions (fastest moving first) used when UseChunkSize is
+   * on, otherwise chunks are a single N-1 dimension slab */
+  std::vector<unsigned int> &
+  GetChunkSize()
+  {
+    return m_ChunkSize;
+  }
+
   /*-------- This part of the interfaces deals with reading data. ----- */
 
   /** Determine if the file can be read with this ImageIO implementation.
@@ -177,6 +541,146 @@ public:
   virtual void
   WriteImageMetaDataOnly(const MetaDataDictionary & metaDict);
 
+  /** One entry per chunk of the dataset, true if the chunk has been
+   * allocated in the file. Chunks are ordered with the fastest moving
+   * dimension varying fastest, see GetChunkGridSize() */
+  std::vector<bool>
+  GetAllocatedChunkMap();
+
+  /** Number of chunks along each dimension (fastest moving first) */
+  std::vector<SizeValueType>
+  GetChunkGridSize();
+
+  /** Lock held around every call into libhdf5 made from worker threads.
+   * libhdf5 is not built thread safe, and a lock per instance would still
+   * let two instances, e.g. the input and output of a chunk processor,
+   * enter it at once. Callers driving libhdf5 from their own threads
+   * should hold it too */
+  static std::recursive_mutex &
+  GetLibraryMutex();
+
+  /** Image region covered by a chunk */
+  ImageIORegion
+  GetChunkRegion(SizeValueType chunk);
+
+  /** Read the pixels of the region given by GetChunkRegion() into
+   * buffer. When the chunk filters allow it the chunk is read raw and
+   * decoded by the calling thread, so ReadChunk(), ReadRegion() and
+   * WriteChunk() may be called from several threads, only access to
+   * libhdf5 is serialized, across all instances through
+   * GetLibraryMutex(). ReadImageInformation() must be called first */
+  void
+  ReadChunk(SizeValueType chunk, void * buffer);
+
+  /** Read a region into buffer, safe to call along with ReadChunk() */
+  void
+  ReadRegion(const ImageIORegion & region, void * buffer);
+
+  /** Write the pixels of the region given by GetChunkRegion(), safe to
+   * call along with ReadChunk(). WriteImageInformation() must be called
+   * first */
+  void
+  WriteChunk(SizeValueType chunk, const void * buffer);
+
+  /** Apply the filter pipeline of the dataset to a full (unclipped) chunk
+   * of chunkBytes in the calling thread, giving the bytes WriteRawChunk()
+   * stores. Returns false if the pipeline can only be run by libhdf5 */
+  bool
+  EncodeChunk(const void * chunk, SizeValueType chunkBytes, std::vector<unsigned char> & stored);
+
+  /** Store a chunk encoded by EncodeChunk() as it is, with
+   * H5Dwrite_chunk. The options applied by Write() are not */
+  void
+  WriteRawChunk(SizeValueType chunk, const std::vector<unsigned char> & stored);
+
+  /** Reopen the file of the dataset read by ReadImageInformation() for
+   * writing. Write() and WriteChunk() then update the existing dataset in
+   * place, without the options that apply when a dataset is created
+   * (sparse, statistics, projections), and the data derived from its
+   * content is removed as with UseUpdate. ReadImageInformation() ends
+   * it */
+  void
+  OpenForUpdate();
+
+  /** Statistics of each chunk, ordered as GetAllocatedChunkMap(). They
+   * are read from the statistics dataset, no pixel data is accessed */
+  std::vector<ChunkStatisticsType>
+  GetChunkStatistics();
+
+  /** Statistics of the whole image, merged from the chunk statistics */
+  ChunkStatisticsType
+  GetStatistics();
+
+  /** Chunks that may hold values within [lower, upper], all others can be
+   * skipped when thresholding */
+  std::vector<SizeValueType>
+  GetChunksInIntensityRange(double lower, double upper);
+
+  /** Bounding region of the chunks holding non-background values, aligned
+   * to chunk boundaries. The region has a zero size if there are none */
+  ImageIORegion
+  GetForegroundRegion();
+
+  /** Compute the statistics of an existing dataset, for example one
+   * written without UseImageStatistics. Chunks are read one at a time and
+   * decoded and reduced by a pool of threads, so memory use is bounded by
+   * the number of threads. The results are cached as attributes of the
+   * dataset with a fingerprint of its storage, later calls return them
+   * without reading pixel data until the dataset is rewritten. Opening
+   * the dataset for update removes them, as chunks rewritten in place
+   * with the same size leave the storage fingerprint unchanged. The
+   * minimum, maximum, mean and standard deviation are also added to the
+   * metadata dictionary. ReadImageInformation() must be called first */
+  ChunkStatisticsType
+  ComputeStatistics();
+
+  /** Compute a fingerprint of the pixel data of an existing dataset. It
+   * depends on the dimensions, component type and pixel values only, not
+   * on the chunking, filters or fill value, so the same image stored
+   * differently has the same fingerprint. Chunks are decoded by a pool of
+   * threads as by ComputeStatistics(), and the result is cached as an
+   * attribute of the dataset with a fingerprint of its storage.
+   * ReadImageInformation() must be called first */
+  uint64_t
+  ComputeFingerprint();
+
+  /** True if the pixel data of the dataset equals that of the dataset of
+   * other, ReadImageInformation() having been called on both. Datasets
+   * with the same chunking and filters are compared on the stored bytes
+   * of their chunks, with H5Dread_chunk, decoding only the chunks whose
+   * bytes differ. Others are compared with ComputeFingerprint() */
+  bool
+  CompareDataSets(HDF5ContainerImageIO * other);
+
+  /** Copy the dataset to the path and dataset name of destination, in
+   * another file, with H5Ocopy so no chunk is decoded. Its geometry
+   * attributes, the datasets stored beside it (dictionary, statistics,
+   * projections, thumbnail, hashes and checksums) and the metadata group
+   * are copied with it, the metadata group only if the destination path
+   * has none. Copying several datasets to one file merges them in a
+   * container. An existing destination dataset is replaced if destination
+   * has Overwrite on. ReadImageInformation() must be called first */
+  void
+  CopyDataSet(HDF5ContainerImageIO * destination);
+
+  /** Copy a region of the dataset to a new dataset of destination, in
+   * another file, with the same chunking and filters and the origin of
+   * the region. When the region starts on chunk boundaries every chunk of
+   * the copy is a chunk of the dataset, and its stored bytes are moved
+   * with H5Dread_chunk and H5Dwrite_chunk. Otherwise the chunks are
+   * decoded and encoded by a pool of threads. The datasets stored beside
+   * the dataset describe all of it and are not copied, other than the
+   * dictionary. ReadImageInformation() must be called first */
+  void
+  CopyRegion(const ImageIORegion & region, HDF5ContainerImageIO * destination);
+
+  /** Copy the metadata group of the path of the dataset to the path of
+   * destination, whose file is open for writing, unless that path already
+   * has one. Used when a dataset is rewritten rather than copied, as by
+   * HDF5ContainerRepacker. ReadImageInformation() must be called first */
+  void
+  CopyMetaData(HDF5ContainerImageIO * destination);
+
 protected:
   HDF5ContainerImageIO();
   ~HDF5ContainerImageIO() override;
@@ -270,7 +774,24 @@ private:
   CloseH5File();
 
   void
-  ResetH5File(const H5::FileAccPropList fapl);
+  ResetH5File(H5::FileAccPropList fapl);
+  void
+  OpenH5File(unsigned int flags);
+  void
+  SetupFileAccess(H5::FileAccPropList & fapl, FileDriverEnum driver, bool create);
+  bool
+  FindFileDriver(FileDriverEnum & driver);
+
+  /** Offset and length of bytes of the file */
+  using PageCacheRangeType = std::pair<SizeValueType, SizeValueType>;
+
+  void
+  DropPageCache(const H5::DataSet & ds, const H5::DataSpace & space);
+  void
+  DropPageCache();
+
+  H5::DSetMemXferPropList
+  GetTransferPropList() const;
   std::vector<std::string>
   GetPathElements(const std::string & path);
   bool
@@ -301,21 +822,165 @@ private:
   void
   ReadImageMetaData(MetaDataDictionary & metaDict);
 
-  std::unique_ptr<H5::H5File> m_H5File{ nullptr };
-  bool                        m_ImageInformationWritten{ false };
-  std::string                 m_Path{ "/" };
-  std::string                 m_DataSetName{ "/data" };
-  bool                        m_Overwrite{ false };
-  bool                        m_ReCreate{ false };
-  bool                        m_UseChunking{ false };
-  bool                        m_UseMetaData{ false };
-  std::vector<unsigned int>   m_DataSetOffset;
-  std::vector<unsigned int>   m_DataSetSize;
-  std::vector<unsigned int>   m_DataSetStride;
-  bool                        m_UseDataSetOffset{ false };
-  bool                        m_UseDataSetSize{ false };
-  bool                        m_UseDataSetStride{ false };
-  bool                        m_UseInferredDimensions{ false };
+  HDF5ContainerChunkGrid
+  GetChunkGrid() const;
+
+  void
+  WriteSparse(const void * buffer, H5::DataSet & ds);
+
+  /** A chunk gathered by the write combining buffer */
+  struct WriteCombiningChunkType
+  {
+    std::vector<unsigned char> Data;
+    SizeValueType              NumberOfElementsWritten{ 0 };
+  };
+
+  bool
+  CombineWrite(const void * buffer, const H5::DataSet & ds);
+  void
+  FlushWriteCombiningChunk(SizeValueType chunk);
+
+  void
+  AccumulateChunkStatistics(const void * buffer, const H5::DataSet & ds);
+  void
+  WriteChunkStatistics();
+  void
+  AccumulateImageStatistics(const void * buffer);
+  void
+  WriteImageStatistics(H5::DataSet & ds);
+  void
+  ReadImageStatistics(const H5::DataSet & ds, MetaDataDictionary & metaDict);
+  void
+  CacheStatistics(const ChunkStatisticsType & statistics, double squaredDeviations, uint64_t fingerprint);
+  bool
+  OpenForCaching(bool & reopened);
+  H5::Group
+  OpenForCopy();
+
+  void
+  UpdateChunkCacheKey();
+  bool
+  ReadThroughChunkCache(void * buffer);
+  void
+  ReadChunk(SizeValueType chunk, void * buffer, bool recordAccess);
+  void
+  EraseFromSharedChunkCache();
+
+  void
+  AccumulateProjections(const void * buffer);
+  void
+  WriteProjections();
+  void
+  WriteProjectionDataSet(const std::string &                name,
+                         const std::vector<double> &        data,
+                         const std::vector<SizeValueType> & dims,
+                         const std::vector<double> &        spacing,
+                         const std::vector<double> &        origin,
+                         IOComponentEnum                    componentType,
+                         unsigned int                       numComponents);
+
+  void
+  ReleaseZstdDictionary();
+  void
+  LoadZstdDictionary(const H5::DataSet & ds);
+  void
+  OpenDataSetForUpdate();
+  void
+  RemoveDerivedData(H5::DataSet & ds);
+
+  void
+  LoadCheckpoint(const H5::DataSet & ds);
+  void
+  AccumulateCheckpoint(const H5::DataSet & ds);
+  void
+  WriteCheckpoint();
+
+  void
+  LoadChunkHashes(const H5::DataSet & ds, bool created);
+  void
+  AccumulateChunkHashes(const void * buffer, const H5::DataSet & ds);
+  void
+  WriteChangedChunks(const void * buffer, H5::DataSet & ds);
+  void
+  WriteChunkHashes();
+
+  void
+  LoadChunkChecksums(const H5::DataSet & ds, bool created);
+  void
+  MarkChunkChecksumsDirty(const H5::DataSet & ds);
+  void
+  WriteChunkChecksums();
+
+  std::unique_ptr<H5::H5File>                      m_H5File{ nullptr };
+  bool                                             m_ImageInformationWritten{ false };
+  std::string                                      m_Path{ "/" };
+  std::string                                      m_DataSetName{ "/data" };
+  bool                                             m_Overwrite{ false };
+  bool                                             m_ReCreate{ false };
+  bool                                             m_UseChunking{ false };
+  bool                                             m_UseMetaData{ false };
+  std::vector<unsigned int>                        m_DataSetOffset;
+  std::vector<unsigned int>                        m_DataSetSize;
+  std::vector<unsigned int>                        m_DataSetStride;
+  bool                                             m_UseDataSetOffset{ false };
+  bool                                             m_UseDataSetSize{ false };
+  bool                                             m_UseDataSetStride{ false };
+  bool                                             m_UseInferredDimensions{ false };
+  std::vector<unsigned int>                        m_ChunkSize;
+  bool                                             m_UseChunkSize{ false };
+  bool                                             m_UseZstdDictionary{ false };
+  bool                                             m_UseShuffle{ false };
+  unsigned int                                     m_ZstdDictionaryCapacity{ 112640 };
+  std::vector<unsigned char>                       m_ZstdDictionary;
+  unsigned int                                     m_ZstdDictionaryId{ 0 };
+  bool                                             m_UseSparse{ false };
+  double                                           m_FillValue{ 0.0 };
+  std::vector<bool>                                m_SparseWrittenChunks;
+  bool                                             m_UseChunkStatistics{ false };
+  std::vector<ChunkStatisticsType>                 m_ChunkStatistics;
+  bool                                             m_ChunkStatisticsModified{ false };
+  bool                                             m_UseImageStatistics{ false };
+  unsigned int                                     m_NumberOfHistogramBins{ 256 };
+  ChunkStatisticsType                              m_ImageStatistics;
+  double                                           m_ImageSquaredDeviations{ 0.0 };
+  std::unique_ptr<HDF5ContainerHistogram>          m_Histogram;
+  SizeValueType                                    m_NumberOfPixelsWritten{ 0 };
+  bool                                             m_UseProjections{ false };
+  bool                                             m_UseMeanProjections{ false };
+  unsigned int                                     m_ThumbnailSize{ 256 };
+  std::unique_ptr<HDF5ContainerProjections>        m_Projections;
+  bool                                             m_Updating{ false };
+  bool                                             m_UseSharedChunkCache{ false };
+  uint64_t                                         m_ChunkCacheFile{ 0 };
+  uint64_t                                         m_ChunkCacheDataSet{ 0 };
+  std::string                                      m_LocalChunkCacheDirectory;
+  SizeValueType                                    m_LocalChunkCacheCapacity{ SizeValueType(10) << 30 };
+  std::string                                      m_AccessTraceFileName;
+  std::unique_ptr<HDF5ContainerAccessTrace>        m_AccessTrace;
+  bool                                             m_UseMPIIO{ false };
+  FileDriverEnum                                   m_FileDriver{ FileDriverEnum::SEC2 };
+  SizeValueType                                    m_FamilyMemberSize{ SizeValueType(1) << 30 };
+  bool                                             m_UseDirectIO{ false };
+  std::vector<PageCacheRangeType>                  m_PageCacheRanges;
+  bool                                             m_UseWriteCombining{ false };
+  bool                                             m_WriteCombining{ false };
+  std::map<SizeValueType, WriteCombiningChunkType> m_WriteCombiningChunks;
+  std::shared_ptr<const HDF5ContainerChunkCodec>   m_ChunkEncoder;
+  bool                                             m_UseUpdate{ false };
+  bool                                             m_UseCheckpoints{ false };
+  double                                           m_CheckpointInterval{ 60.0 };
+  std::vector<SizeValueType>                       m_CheckpointElementsWritten;
+  SizeValueType                                    m_NumberOfChunksCompleted{ 0 };
+  bool                                             m_CheckpointModified{ false };
+  double                                           m_LastCheckpointTime{ 0.0 };
+  bool                                             m_UseChunkHashes{ false };
+  std::vector<uint64_t>                            m_ChunkHashes;
+  bool                                             m_ChunkHashesModified{ false };
+  SizeValueType                                    m_NumberOfChunksSkipped{ 0 };
+  bool                                             m_UseChunkChecksums{ false };
+  std::vector<uint64_t>                            m_ChunkChecksums;
+  std::vector<bool>                                m_DirtyChunkChecksums;
+  bool                                             m_ChunkChecksumsModified{ false };
 };
 } // end namespace itk
 
@@ -0,0 +1,217 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerImageProxy_h
+#define itkHDF5ContainerImageProxy_h
+
+#include "itkHDF5ContainerImageIO.h"
+#include "itkIndex.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerImageProxy
+ *
+ * \brief Random access to the pixels of a dataset larger than memory.
+ *
+ * The dataset selected by the ImageIO (FileName, Path and DataSetName) is
+ * paged in a chunk at a time. Decoded chunks are kept in a least recently
+ * used cache limited to MemoryBudget bytes, at least one chunk is always
+ * held. With Writable on, SetPixel() and SetRegion() modify cached chunks,
+ * which are written back when evicted, on Flush() and on destruction.
+ *
+ * The dataset must be chunked, and its component type and number of
+ * components must match TPixel. Not thread safe.
+ *
+ * \ingroup CSIROCT
+ */
+template <typename TPixel, unsigned int VImageDimension = 3>
+class ITK_TEMPLATE_EXPORT HDF5ContainerImageProxy : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HDF5ContainerImageProxy);
+
+  /** Standard class type aliases. */
+  using Self = HDF5ContainerImageProxy;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HDF5ContainerImageProxy, Object);
+
+  static constexpr unsigned int ImageDimension = VImageDimension;
+
+  using PixelType = TPixel;
+  using IndexType = Index<VImageDimension>;
+
+  /** Set/Get the ImageIO selecting the dataset, one is created by default */
+  itkSetObjectMacro(ImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(ImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the most memory used by cached chunks, in bytes */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
+  /** Set/Get whether pixels may be written, set before Open() */
+  itkSetMacro(Writable, bool);
+  itkGetConstMacro(Writable, bool);
+  itkBooleanMacro(Writable);
+
+  /** Open the dataset, dropping any cached chunks */
+  void
+  Open();
+
+  /** Write back modified chunks and drop all cached chunks */
+  void
+  Close();
+
+  /** Write back modified chunks, which stay cached */
+  void
+  Flush();
+
+  /** Size of the image, fastest moving dimension first */
+  SizeValueType
+  GetSize(unsigned int i) const
+  {
+    return m_Size[i];
+  }
+
+  PixelType
+  GetPixel(const IndexType & index)
+  {
+    const SizeValueType chunk(this->GetChunkContaining(index));
+    return this->GetChunk(chunk).Pixels[this->GetOffsetInChunk(index)];
+  }
+
+  void
+  SetPixel(const IndexType & index, const PixelType & value);
+
+  /** Copy the pixels of a region into buffer, fastest moving dimension
+   * first */
+  void
+  GetRegion(const ImageIORegion & region, PixelType * buffer);
+
+  /** Copy buffer into the pixels of a region */
+  void
+  SetRegion(const ImageIORegion & region, const PixelType * buffer);
+
+  /** Number of chunks and bytes held by the cache */
+  SizeValueType
+  GetNumberOfCachedChunks() const
+  {
+    return m_Chunks.size();
+  }
+  SizeValueType
+  GetCachedBytes() const
+  {
+    return m_CachedBytes;
+  }
+
+  /** Number of chunk reads and write backs since Open() */
+  SizeValueType
+  GetNumberOfChunkReads() const
+  {
+    return m_NumberOfChunkReads;
+  }
+  SizeValueType
+  GetNumberOfChunkWrites() const
+  {
+    return m_NumberOfChunkWrites;
+  }
+
+protected:
+  HDF5ContainerImageProxy();
+  ~HDF5ContainerImageProxy() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  struct ChunkType
+  {
+    std::vector<PixelType>             Pixels;
+    ImageIORegion                      Region;
+    bool                               Modified{ false };
+    std::list<SizeValueType>::iterator Position;
+  };
+
+  SizeValueType
+  GetChunkContaining(const IndexType & index) const
+  {
+    SizeValueType chunk(0), stride(1);
+    for (unsigned int i = 0; i < VImageDimension; i++)
+    {
+      if (index[i] < 0 || static_cast<SizeValueType>(index[i]) >= m_Size[i])
+        itkExceptionMacro(<< "Index " << index << " is outside the image");
+      chunk += static_cast<SizeValueType>(index[i]) / m_ChunkSize[i] * stride;
+      stride *= m_GridSize[i];
+    }
+    return chunk;
+  }
+
+  // Offset of a pixel in the last chunk returned by GetChunk()
+  SizeValueType
+  GetOffsetInChunk(const IndexType & index) const
+  {
+    SizeValueType offset(0), stride(1);
+    for (unsigned int i = 0; i < VImageDimension; i++)
+    {
+      offset += (index[i] - m_LastChunk->Region.GetIndex(i)) * stride;
+      stride *= m_LastChunk->Region.GetSize(i);
+    }
+    return offset;
+  }
+
+  ChunkType &
+  GetChunk(SizeValueType chunk);
+
+  void
+  WriteChunk(SizeValueType chunk, ChunkType & entry);
+
+  void
+  CopyRegion(const ImageIORegion & region, PixelType * buffer, bool toChunks);
+
+  HDF5ContainerImageIO::Pointer                m_ImageIO;
+  SizeValueType                                m_MemoryBudget{ 256 << 20 };
+  bool                                         m_Writable{ false };
+  bool                                         m_Opened{ false };
+  SizeValueType                                m_Size[VImageDimension];
+  SizeValueType                                m_ChunkSize[VImageDimension];
+  SizeValueType                                m_GridSize[VImageDimension];
+  std::unordered_map<SizeValueType, ChunkType> m_Chunks;
+  std::list<SizeValueType>                     m_LeastRecentlyUsed;
+  SizeValueType                                m_LastChunkIndex{ 0 };
+  ChunkType *                                  m_LastChunk{ nullptr };
+  SizeValueType                                m_CachedBytes{ 0 };
+  SizeValueType                                m_NumberOfChunkReads{ 0 };
+  SizeValueType                                m_NumberOfChunkWrites{ 0 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkHDF5ContainerImageProxy.hxx"
+#endif
+
+#endif // itkHDF5ContainerImageProxy_h
@@ -0,0 +1,316 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerImageProxy_hxx
+#define itkHDF5ContainerImageProxy_hxx
+
+#include "itkDefaultConvertPixelTraits.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace itk
+{
+template <typename TPixel, unsigned int VImageDimension>
+HDF5ContainerImageProxy<TPixel, VImageDimension>::HDF5ContainerImageProxy()
+  : m_ImageIO(HDF5ContainerImageIO::New())
+{
+  std::fill_n(m_Size, VImageDimension, 0);
+  std::fill_n(m_ChunkSize, VImageDimension, 1);
+  std::fill_n(m_GridSize, VImageDimension, 0);
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+HDF5ContainerImageProxy<TPixel, VImageDimension>::~HDF5ContainerImageProxy()
+{
+  try
+  {
+    this->Flush();
+  }
+  catch (ExceptionObject & error)
+  {
+    itkWarningMacro(<< "Unable to write back modified chunks: " << error.GetDescription());
+  }
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ImageIO: " << this->m_ImageIO.GetPointer() << std::endl;
+  os << indent << "MemoryBudget: " << this->m_MemoryBudget << std::endl;
+  if (m_Writable)
+  {
+    os << indent << "Writable: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "Writable: Off" << std::endl;
+  }
+  os << indent << "NumberOfCachedChunks: " << this->m_Chunks.size() << std::endl;
+  os << indent << "CachedBytes: " << this->m_CachedBytes << std::endl;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::Open()
+{
+  using ComponentType = typename DefaultConvertPixelTraits<TPixel>::ComponentType;
+
+  this->Close();
+
+  HDF5ContainerImageIO * io(this->m_ImageIO);
+  io->ReadImageInformation();
+
+  if (io->GetNumberOfDimensions() != VImageDimension)
+    itkExceptionMacro(<< io->GetDataSetName() << " has " << io->GetNumberOfDimensions() << " dimensions, expected "
+                      << VImageDimension);
+  if (io->GetComponentType() != ImageIOBase::MapPixelType<ComponentType>::CType ||
+      io->GetNumberOfComponents() != DefaultConvertPixelTraits<TPixel>::GetNumberOfComponents() ||
+      io->GetComponentSize() * io->GetNumberOfComponents() != sizeof(TPixel))
+    itkExceptionMacro(<< "The pixels of " << io->GetDataSetName() << " do not match the proxy pixel type");
+
+  const std::vector<SizeValueType> gridSize(io->GetChunkGridSize());
+  const ImageIORegion              firstChunk(io->GetChunkRegion(0));
+  for (unsigned int i = 0; i < VImageDimension; i++)
+  {
+    this->m_Size[i] = io->GetDimensions(i);
+    this->m_ChunkSize[i] = firstChunk.GetSize(i);
+    this->m_GridSize[i] = gridSize[i];
+  }
+
+  if (this->m_Writable)
+    io->OpenForUpdate();
+
+  this->m_NumberOfChunkReads = 0;
+  this->m_NumberOfChunkWrites = 0;
+  this->m_Opened = true;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::Close()
+{
+  this->Flush();
+
+  this->m_Chunks.clear();
+  this->m_LeastRecentlyUsed.clear();
+  this->m_LastChunk = nullptr;
+  this->m_CachedBytes = 0;
+  this->m_Opened = false;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::Flush()
+{
+  for (auto & entry : this->m_Chunks)
+  {
+    if (entry.second.Modified)
+      this->WriteChunk(entry.first, entry.second);
+  }
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::WriteChunk(SizeValueType chunk, ChunkType & entry)
+{
+  this->m_ImageIO->WriteChunk(chunk, entry.Pixels.data());
+  entry.Modified = false;
+  this->m_NumberOfChunkWrites++;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+typename HDF5ContainerImageProxy<TPixel, VImageDimension>::ChunkType &
+HDF5ContainerImageProxy<TPixel, VImageDimension>::GetChunk(SizeValueType chunk)
+{
+  // Runs of pixels in the same chunk skip the lookup
+  if (this->m_LastChunk != nullptr && this->m_LastChunkIndex == chunk)
+    return *this->m_LastChunk;
+
+  if (!this->m_Opened)
+    itkExceptionMacro(<< "Open() must be called before accessing pixels");
+
+  auto found(this->m_Chunks.find(chunk));
+  if (found != this->m_Chunks.end())
+  {
+    // Most recently used chunks are at the front
+    this->m_LeastRecentlyUsed.splice(
+      this->m_LeastRecentlyUsed.begin(), this->m_LeastRecentlyUsed, found->second.Position);
+    this->m_LastChunkIndex = chunk;
+    this->m_LastChunk = &found->second;
+    return found->second;
+  }
+
+  ChunkType entry;
+  entry.Region = ImageIORegion(VImageDimension);
+  SizeValueType remainder(chunk);
+  for (unsigned int i = 0; i < VImageDimension; i++)
+  {
+    const SizeValueType index(remainder % this->m_GridSize[i] * this->m_ChunkSize[i]);
+    remainder /= this->m_GridSize[i];
+    entry.Region.SetIndex(i, static_cast<IndexValueType>(index));
+    entry.Region.SetSize(i, std::min(this->m_ChunkSize[i], this->m_Size[i] - index));
+  }
+  entry.Pixels.resize(entry.Region.GetNumberOfPixels());
+  this->m_ImageIO->ReadChunk(chunk, entry.Pixels.data());
+  this->m_NumberOfChunkReads++;
+
+  const SizeValueType bytes(entry.Pixels.size() * sizeof(PixelType));
+
+  // Evict the least recently used chunks until the new one fits, but
+  // always keep the chunk in use
+  while (!this->m_LeastRecentlyUsed.empty() && this->m_CachedBytes + bytes > this->m_MemoryBudget)
+  {
+    const SizeValueType evicted(this->m_LeastRecentlyUsed.back());
+    ChunkType &         evictedEntry(this->m_Chunks[evicted]);
+    if (evictedEntry.Modified)
+      this->WriteChunk(evicted, evictedEntry);
+    this->m_CachedBytes -= evictedEntry.Pixels.size() * sizeof(PixelType);
+    this->m_LeastRecentlyUsed.pop_back();
+    this->m_Chunks.erase(evicted);
+  }
+
+  this->m_LeastRecentlyUsed.push_front(chunk);
+  entry.Position = this->m_LeastRecentlyUsed.begin();
+  this->m_CachedBytes += bytes;
+
+  ChunkType & inserted(this->m_Chunks[chunk] = std::move(entry));
+  this->m_LastChunkIndex = chunk;
+  this->m_LastChunk = &inserted;
+  return inserted;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::SetPixel(const IndexType & index, const PixelType & value)
+{
+  if (!this->m_Writable)
+    itkExceptionMacro(<< "Writable must be on to set pixels");
+
+  const SizeValueType chunk(this->GetChunkContaining(index));
+  ChunkType &         entry(this->GetChunk(chunk));
+  entry.Pixels[this->GetOffsetInChunk(index)] = value;
+  entry.Modified = true;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::GetRegion(const ImageIORegion & region, PixelType * buffer)
+{
+  this->CopyRegion(region, buffer, false);
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::SetRegion(const ImageIORegion & region, const PixelType * buffer)
+{
+  if (!this->m_Writable)
+    itkExceptionMacro(<< "Writable must be on to set pixels");
+
+  this->CopyRegion(region, const_cast<PixelType *>(buffer), true);
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+HDF5ContainerImageProxy<TPixel, VImageDimension>::CopyRegion(const ImageIORegion & region,
+                                                             PixelType *           buffer,
+                                                             bool                  toChunks)
+{
+  if (region.GetImageDimension() != VImageDimension)
+    itkExceptionMacro(<< "Region has " << region.GetImageDimension() << " dimensions, expected " << VImageDimension);
+
+  // Range of chunks intersecting the region along each dimension
+  SizeValueType first[VImageDimension], last[VImageDimension], numChunks(1);
+  for (unsigned int i = 0; i < VImageDimension; i++)
+  {
+    if (region.GetIndex(i) < 0 || region.GetIndex(i) + region.GetSize(i) > this->m_Size[i])
+      itkExceptionMacro(<< "Region is outside the image");
+    if (region.GetSize(i) == 0)
+      return;
+    first[i] = region.GetIndex(i) / this->m_ChunkSize[i];
+    last[i] = (region.GetIndex(i) + region.GetSize(i) - 1) / this->m_ChunkSize[i];
+    numChunks *= last[i] - first[i] + 1;
+  }
+
+  SizeValueType chunkCoordinate[VImageDimension];
+  std::copy_n(first, VImageDimension, chunkCoordinate);
+
+  for (SizeValueType n = 0; n < numChunks; n++)
+  {
+    SizeValueType chunk(0), stride(1);
+    for (unsigned int i = 0; i < VImageDimension; i++)
+    {
+      chunk += chunkCoordinate[i] * stride;
+      stride *= this->m_GridSize[i];
+    }
+    ChunkType &           entry(this->GetChunk(chunk));
+    const ImageIORegion & chunkRegion(entry.Region);
+
+    // Copy the intersection a row at a time
+    IndexValueType start[VImageDimension], end[VImageDimension], index[VImageDimension];
+    for (unsigned int i = 0; i < VImageDimension; i++)
+    {
+      start[i] = std::max(region.GetIndex(i), chunkRegion.GetIndex(i));
+      end[i] = std::min(region.GetIndex(i) + static_cast<IndexValueType>(region.GetSize(i)),
+                        chunkRegion.GetIndex(i) + static_cast<IndexValueType>(chunkRegion.GetSize(i)));
+    }
+    std::copy_n(start, VImageDimension, index);
+
+    const size_t rowBytes((end[0] - start[0]) * sizeof(PixelType));
+    for (bool done = false; !done;)
+    {
+      SizeValueType bufferOffset(0), chunkOffset(0), bufferStride(1), chunkStride(1);
+      for (unsigned int i = 0; i < VImageDimension; i++)
+      {
+        bufferOffset += (index[i] - region.GetIndex(i)) * bufferStride;
+        chunkOffset += (index[i] - chunkRegion.GetIndex(i)) * chunkStride;
+        bufferStride *= region.GetSize(i);
+        chunkStride *= chunkRegion.GetSize(i);
+      }
+      if (toChunks)
+        std::memcpy(entry.Pixels.data() + chunkOffset, buffer + bufferOffset, rowBytes);
+      else
+        std::memcpy(buffer + bufferOffset, entry.Pixels.data() + chunkOffset, rowBytes);
+
+      done = true;
+      for (unsigned int i = 1; i < VImageDimension; i++)
+      {
+        if (++index[i] < end[i])
+        {
+          done = false;
+          break;
+        }
+        index[i] = start[i];
+      }
+    }
+    if (toChunks)
+      entry.Modified = true;
+
+    for (unsigned int i = 0; i < VImageDimension; i++)
+    {
+      if (++chunkCoordinate[i] <= last[i])
+        break;
+      chunkCoordinate[i] = first[i];
+    }
+  }
+}
+} // end namespace itk
+
+#endif // itkHDF5ContainerImageProxy_hxx
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerLayoutAdvisor_h
+#define itkHDF5ContainerLayoutAdvisor_h
+#include "HDF5ContainerExport.h"
+
+#include "itkImageIORegion.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerLayoutAdvisor
+ *
+ * \brief Recommend a chunk shape and cache size from recorded accesses.
+ *
+ * The regions recorded with HDF5ContainerImageIO::SetAccessTraceFileName()
+ * are replayed against every pair of candidate chunk size and chunk cache
+ * size. Each region touches the chunks it intersects, which are looked up
+ * in a least recently used cache holding as many whole chunks as fit in
+ * the cache size. Misses are chunks read and decompressed.
+ *
+ * Layouts are ranked by their cost, the bytes decompressed plus
+ * ChunkOverhead bytes per chunk read, which accounts for the per-chunk
+ * cost of small chunks, plus CacheCost per byte of chunk cache, so that
+ * a larger cache has to save more than it holds. Cache sizes above the
+ * MemoryBudget are not tried. Equal costs favour the smaller cache. The
+ * recommended chunk size, fastest moving dimension first, can be given to
+ * HDF5ContainerImageIO::GetChunkSize() or, formatted by
+ * FormatChunkSize(), to the --chunk option of HDF5ContainerRepack.
+ *
+ * Without candidate chunk sizes, cubes of 16 to 256 pixels and slabs of
+ * 1 to 16 slices along the slowest axis are tried. Without candidate
+ * cache sizes, 1MB (the libhdf5 default), 64MB and 1GB are tried.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5Container_EXPORT HDF5ContainerLayoutAdvisor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HDF5ContainerLayoutAdvisor);
+
+  /** Standard class type aliases. */
+  using Self = HDF5ContainerLayoutAdvisor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HDF5ContainerLayoutAdvisor, Object);
+
+  /** Set/Get the access trace to replay */
+  itkSetStringMacro(TraceFileName);
+  itkGetStringMacro(TraceFileName);
+
+  /** Set/Get the cost in bytes charged for each chunk read, 64KB by
+   * default */
+  itkSetMacro(ChunkOverhead, SizeValueType);
+  itkGetConstMacro(ChunkOverhead, SizeValueType);
+
+  /** Set/Get the cost charged for each byte of chunk cache, 1 by default:
+   * a cache pays off when it saves more bytes decompressed over the trace
+   * than it holds. Traces recording a fraction of the reads expected
+   * warrant a lower cost */
+  itkSetMacro(CacheCost, double);
+  itkGetConstMacro(CacheCost, double);
+
+  /** Set/Get the largest chunk cache size tried in bytes, 0 (the default)
+   * for no limit */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
+  /** Add a candidate chunk size, fastest moving dimension first. Sizes
+   * larger than the image are clipped to it */
+  void
+  AddCandidateChunkSize(const std::vector<unsigned int> & chunkSize);
+
+  /** Add a candidate chunk cache size in bytes */
+  void
+  AddCandidateCacheSize(SizeValueType bytes);
+
+  void
+  ClearCandidates();
+
+  /** The simulated reads of a chunk size with a cache size */
+  struct LayoutEvaluationType
+  {
+    std::vector<unsigned int> ChunkSize;
+    SizeValueType             CacheSize{ 0 };
+    SizeValueType             ChunksTouched{ 0 };
+    SizeValueType             ChunksRead{ 0 };
+    SizeValueType             BytesDecompressed{ 0 };
+    double                    HitRate{ 0.0 };
+    double                    Cost{ 0.0 };
+  };
+
+  /** Replay the trace against every candidate layout, in parallel */
+  void
+  Evaluate();
+
+  /** Evaluations of Evaluate(), best first */
+  const std::vector<LayoutEvaluationType> &
+  GetEvaluations() const
+  {
+    return this->m_Evaluations;
+  }
+
+  /** Chunk size of the best layout, fastest moving dimension first */
+  std::vector<unsigned int>
+  GetRecommendedChunkSize() const;
+
+  /** Cache size of the best layout */
+  SizeValueType
+  GetRecommendedCacheSize() const;
+
+  /** Number of regions in the trace replayed */
+  itkGetConstMacro(NumberOfAccesses, SizeValueType);
+
+  /** Format a chunk size as comma separated values, e.g. 64,64,16 */
+  static std::string
+  FormatChunkSize(const std::vector<unsigned int> & chunkSize);
+
+protected:
+  HDF5ContainerLayoutAdvisor() = default;
+  ~HDF5ContainerLayoutAdvisor() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  std::string                            m_TraceFileName;
+  SizeValueType                          m_ChunkOverhead{ SizeValueType(64) << 10 };
+  double                                 m_CacheCost{ 1.0 };
+  SizeValueType                          m_MemoryBudget{ 0 };
+  std::vector<std::vector<unsigned int>> m_CandidateChunkSizes;
+  std::vector<SizeValueType>             m_CandidateCacheSizes;
+  std::vector<LayoutEvaluationType>      m_Evaluations;
+  SizeValueType                          m_NumberOfAccesses{ 0 };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerLayoutAdvisor_h
@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerRegionWriter_h
+#define itkHDF5ContainerRegionWriter_h
+#include "HDF5ContainerExport.h"
+
+#include "itkHDF5ContainerImageIO.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerRegionWriter
+ *
+ * \brief Write a dataset from regions produced by many threads.
+ *
+ * WriteRegion() may be called concurrently with disjoint regions. The
+ * calling threads gather the regions into chunks and, as each chunk is
+ * completed, run the filter pipeline (compression) on it. A single
+ * committer thread stores the encoded chunks with H5Dwrite_chunk, as
+ * libhdf5 serialises all calls anyway. When more than MaximumQueuedBytes
+ * are waiting for the committer, WriteRegion() blocks until they have
+ * been written. Once the committer fails every following WriteRegion(),
+ * and Finish(), throws its error.
+ *
+ * Chunks are held until every pixel has been written, so producers
+ * should work through the image in an order that completes chunks,
+ * e.g. slabs along the slowest axis. Finish() writes incomplete chunks
+ * with their missing pixels set to the fill value.
+ *
+ * Chunks are stored as they are, so the options applied by Write() to
+ * each region (sparse, statistics, projections) are not. Pipelines that
+ * can only be run by libhdf5 are run by the committer instead.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5Container_EXPORT HDF5ContainerRegionWriter : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HDF5ContainerRegionWriter);
+
+  /** Standard class type aliases. */
+  using Self = HDF5ContainerRegionWriter;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HDF5ContainerRegionWriter, Object);
+
+  /** Set/Get the ImageIO the dataset is written with. Its geometry,
+   * component type, chunk size and compression are set beforehand, and
+   * with UseZstdDictionary its dictionary trained through
+   * TrainZstdDictionary(). It is only used through this writer between
+   * Start() and Finish() */
+  itkSetObjectMacro(ImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(ImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the bytes of chunks waiting for the committer beyond which
+   * WriteRegion() blocks, 256MB by default */
+  itkSetMacro(MaximumQueuedBytes, SizeValueType);
+  itkGetConstMacro(MaximumQueuedBytes, SizeValueType);
+
+  /** Create the dataset and start the committer thread */
+  void
+  Start();
+
+  /** Write the pixels of a region, components interleaved and fastest
+   * moving dimension first. Safe to call from several threads */
+  void
+  WriteRegion(const ImageIORegion & region, const void * buffer);
+
+  /** Write the remaining chunks and stop the committer thread */
+  void
+  Finish();
+
+  /** Number of chunks stored so far */
+  SizeValueType
+  GetNumberOfChunksWritten() const
+  {
+    return this->m_NumberOfChunksWritten;
+  }
+
+protected:
+  HDF5ContainerRegionWriter();
+  ~HDF5ContainerRegionWriter() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** A chunk being gathered from regions */
+  struct PendingChunkType
+  {
+    std::vector<unsigned char> Data;
+    SizeValueType              NumberOfElements{ 0 };
+    std::atomic<SizeValueType> NumberOfElementsWritten{ 0 };
+  };
+
+  /** A chunk waiting for the committer */
+  struct QueuedChunkType
+  {
+    SizeValueType              Chunk;
+    std::vector<unsigned char> Data;
+    bool                       Encoded;
+  };
+
+  void
+  SubmitChunk(SizeValueType chunk, const std::vector<unsigned char> & data);
+
+  void
+  Commit();
+
+  void
+  ThrowIfFailed();
+
+  HDF5ContainerImageIO::Pointer                              m_ImageIO;
+  SizeValueType                                              m_MaximumQueuedBytes{ SizeValueType(256) << 20 };
+  std::unique_ptr<HDF5ContainerChunkGrid>                    m_Grid;
+  size_t                                                     m_ElementSize{ 0 };
+  std::vector<unsigned char>                                 m_FillValue;
+  std::mutex                                                 m_PendingMutex;
+  std::map<SizeValueType, std::shared_ptr<PendingChunkType>> m_PendingChunks;
+  std::mutex                                                 m_QueueMutex;
+  std::condition_variable                                    m_QueueNotEmpty;
+  std::condition_variable                                    m_QueueNotFull;
+  std::deque<QueuedChunkType>                                m_Queue;
+  SizeValueType                                              m_QueuedBytes{ 0 };
+  bool                                                       m_Finishing{ false };
+  bool                                                       m_Failed{ false };
+  std::string                                                m_Error;
+  std::thread                                                m_Committer;
+  std::atomic<SizeValueType>                                 m_NumberOfChunksWritten{ 0 };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerRegionWriter_h
@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerRepacker_h
+#define itkHDF5ContainerRepacker_h
+#include "HDF5ContainerExport.h"
+
+#include "itkHDF5ContainerImageIO.h"
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerRepacker
+ *
+ * \brief Rewrite a dataset with another chunk shape, codec, compression
+ * level or shuffle setting.
+ *
+ * The input dataset is read in tiles, its chunks or, if it is
+ * contiguous, the chunks of the output. Tiles are read and decoded by
+ * worker threads one layer along the slowest axis at a time, and passed
+ * to an HDF5ContainerRegionWriter, which encodes the output chunks in the
+ * same threads as they are completed. Memory use is thus bounded by a
+ * layer of output chunks plus the queue of the region writer, rather
+ * than by the image size.
+ *
+ * The output ImageIO carries the new layout: its chunk size (the input
+ * chunking is kept unless UseChunkSize is on), compression, compression
+ * level, shuffle and Zstandard settings; a Zstandard dictionary is
+ * trained from the first layer of tiles. It takes the dimensions,
+ * spacing, origin, direction and component type of the input, which are
+ * written as the usual dataset attributes, and the metadata group of the
+ * input path is copied beside it. The datasets stored beside the input
+ * (statistics, projections, hashes and checksums) are not.
+ *
+ * The output should be a different file from the input.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5Container_EXPORT HDF5ContainerRepacker : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HDF5ContainerRepacker);
+
+  /** Standard class type aliases. */
+  using Self = HDF5ContainerRepacker;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HDF5ContainerRepacker, Object);
+
+  /** Set/Get the ImageIO the input dataset is read from. Its FileName,
+   * Path and DataSetName select the dataset */
+  itkSetObjectMacro(InputImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(InputImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the ImageIO the output dataset is written with */
+  itkSetObjectMacro(OutputImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(OutputImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the number of worker threads, 0 uses the ITK default */
+  itkSetMacro(NumberOfWorkUnits, unsigned int);
+  itkGetConstMacro(NumberOfWorkUnits, unsigned int);
+
+  /** Set/Get the bytes of encoded chunks waiting to be stored beyond
+   * which the workers wait, 256MB by default */
+  itkSetMacro(MaximumQueuedBytes, SizeValueType);
+  itkGetConstMacro(MaximumQueuedBytes, SizeValueType);
+
+  /** Rewrite the input dataset to the output */
+  void
+  Repack();
+
+protected:
+  HDF5ContainerRepacker() = default;
+  ~HDF5ContainerRepacker() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  HDF5ContainerImageIO::Pointer m_InputImageIO;
+  HDF5ContainerImageIO::Pointer m_OutputImageIO;
+  unsigned int                  m_NumberOfWorkUnits{ 0 };
+  SizeValueType                 m_MaximumQueuedBytes{ SizeValueType(256) << 20 };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerRepacker_h
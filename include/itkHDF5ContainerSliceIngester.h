@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerSliceIngester_h
+#define itkHDF5ContainerSliceIngester_h
+#include "HDF5ContainerExport.h"
+
+#include "itkHDF5ContainerImageIO.h"
+
+#include <functional>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerSliceIngester
+ *
+ * \brief Write a stack of 2D slice files as a 3D dataset.
+ *
+ * Slices are read and decoded by worker threads, each with its own
+ * ImageIO, and passed to an HDF5ContainerRegionWriter, which compresses
+ * the chunks in the same threads as they are completed. Slices are read
+ * in batches of whole chunk slabs, at least one slice per work unit, so
+ * memory use is bounded by a few slabs of chunks whatever the number of
+ * slices.
+ *
+ * The slices are read with the ImageIO returned by the SliceImageIO
+ * function, by default the one ImageIOFactory selects for the file, e.g.
+ * TIFF. Raw slices are read by a function returning a configured
+ * RawImageIO. Every slice must have the dimensions, component type and
+ * number of components of the first. The volume takes the spacing and
+ * origin of the first slice in the plane, and SliceSpacing between
+ * slices.
+ *
+ * The output ImageIO carries the chunk size and compression settings,
+ * chunks default to single slices. With UseZstdDictionary the first slab
+ * of chunks is read once more beforehand to train the dictionary.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5Container_EXPORT HDF5ContainerSliceIngester : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HDF5ContainerSliceIngester);
+
+  /** Standard class type aliases. */
+  using Self = HDF5ContainerSliceIngester;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HDF5ContainerSliceIngester, Object);
+
+  /** Returns a new ImageIO able to read a slice file, called once per
+   * slice from the worker threads */
+  using SliceImageIOFunctionType = std::function<ImageIOBase::Pointer(const std::string & fileName)>;
+
+  /** Set/Get the slice files, in order along the slowest axis */
+  void
+  SetFileNames(const std::vector<std::string> & fileNames)
+  {
+    this->m_FileNames = fileNames;
+    this->Modified();
+  }
+  const std::vector<std::string> &
+  GetFileNames() const
+  {
+    return this->m_FileNames;
+  }
+
+  void
+  SetSliceImageIOFunction(const SliceImageIOFunctionType & function)
+  {
+    this->m_SliceImageIOFunction = function;
+    this->Modified();
+  }
+
+  /** Set/Get the ImageIO the volume is written with */
+  itkSetObjectMacro(OutputImageIO, HDF5ContainerImageIO);
+  itkGetModifiableObjectMacro(OutputImageIO, HDF5ContainerImageIO);
+
+  /** Set/Get the spacing between slices, 1 by default */
+  itkSetMacro(SliceSpacing, double);
+  itkGetConstMacro(SliceSpacing, double);
+
+  /** Set/Get the number of worker threads, 0 uses the ITK default */
+  itkSetMacro(NumberOfWorkUnits, unsigned int);
+  itkGetConstMacro(NumberOfWorkUnits, unsigned int);
+
+  /** Set/Get the bytes of encoded chunks waiting to be stored beyond
+   * which the workers wait, 256MB by default */
+  itkSetMacro(MaximumQueuedBytes, SizeValueType);
+  itkGetConstMacro(MaximumQueuedBytes, SizeValueType);
+
+  /** Read every slice and write the volume */
+  void
+  Ingest();
+
+protected:
+  HDF5ContainerSliceIngester() = default;
+  ~HDF5ContainerSliceIngester() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  std::vector<std::string>      m_FileNames;
+  SliceImageIOFunctionType      m_SliceImageIOFunction;
+  HDF5ContainerImageIO::Pointer m_OutputImageIO;
+  double                        m_SliceSpacing{ 1.0 };
+  unsigned int                  m_NumberOfWorkUnits{ 0 };
+  SizeValueType                 m_MaximumQueuedBytes{ SizeValueType(256) << 20 };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerSliceIngester_h
@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerZstdFilter_h
+#define itkHDF5ContainerZstdFilter_h
+
+#include "HDF5ContainerExport.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerZstdFilter
+ *
+ * \brief HDF5 filter compressing chunks with Zstandard, optionally
+ * using a trained dictionary.
+ *
+ * Two filters are registered. Datasets compressed without a dictionary
+ * use the Zstandard filter identifier assigned by The HDF Group (32015)
+ * with the compression level as its only client data value, the layout
+ * of the standard HDF5 Zstandard plugin, so other applications can read
+ * them. Datasets compressed with a dictionary use DictionaryFilterId, an
+ * identifier from the range The HDF Group reserves for filters that are
+ * not distributed, whose client data values hold the compression level
+ * followed by the identifier of the dictionary. Other applications fail
+ * cleanly on those rather than misreading them.
+ *
+ * Dictionaries are looked up in a process wide registry, as libhdf5
+ * gives filters no access to the dataset they are applied to. Each
+ * AddDictionary() or successful AcquireDictionary() takes a reference,
+ * the dictionary is freed when ReleaseDictionary() drops the last one.
+ *
+ * Zstandard support is optional, when the module is built without
+ * HDF5Container_USE_ZSTD IsAvailable() returns false and all other
+ * methods throw.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5Container_EXPORT HDF5ContainerZstdFilter
+{
+public:
+  static constexpr unsigned int FilterId = 32015;
+  static constexpr unsigned int DictionaryFilterId = 511;
+
+  /** True if the module was built with Zstandard support */
+  static bool
+  IsAvailable();
+
+  /** Highest compression level supported, 0 without Zstandard support */
+  static int
+  GetMaximumLevel();
+
+  /** Register the filters with libhdf5, it is safe to call this more than once */
+  static void
+  Register();
+
+  /** Train a dictionary of at most capacity bytes from a set of samples
+   * stored back to back in samples. Returns an empty dictionary if there
+   * was not enough sample data for training */
+  static std::vector<unsigned char>
+  TrainDictionary(const std::vector<unsigned char> & samples,
+                  const std::vector<size_t> &        sampleSizes,
+                  size_t                             capacity);
+
+  /** Identifier stored in a dictionary, 0 if it is not a valid dictionary */
+  static unsigned int
+  GetDictionaryId(const std::vector<unsigned char> & dictionary);
+
+  /** Add a dictionary to the registry used by the filter, or take
+   * another reference to it if it is already registered */
+  static void
+  AddDictionary(const std::vector<unsigned char> & dictionary);
+
+  /** Take another reference to a registered dictionary, false if no
+   * dictionary with the given identifier is registered */
+  static bool
+  AcquireDictionary(unsigned int dictionaryId);
+
+  /** Drop a reference to a dictionary, freeing it with the last one */
+  static void
+  ReleaseDictionary(unsigned int dictionaryId);
+
+  /** True if a dictionary with the given identifier has been registered */
+  static bool
+  HasDictionary(unsigned int dictionaryId);
+
+  /** Compress a buffer with the given level and registered dictionary */
+  static void
+  Compress(const void * src, size_t nbytes, int level, unsigned int dictionaryId, std::vector<unsigned char> & dst);
+
+  /** Decompress a single Zstandard frame of at most capacity bytes into dst */
+  static size_t
+  Decompress(const void * src, size_t nbytes, unsigned int dictionaryId, void * dst, size_t capacity);
+
+  /** Decompressed size stored in a frame header */
+  static size_t
+  GetDecompressedSize(const void * src, size_t nbytes);
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerZstdFilter_h
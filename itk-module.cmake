@@ -9,9 +9,11 @@ itk_module(HDF5Container
     ITKIOImageBase
   PRIVATE_DEPENDS
     ITKHDF5
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKImageSources
+    ITKIOTIFF
   FACTORY_NAMES
     ImageIO::HDF5Container
   DESCRIPTION
@@ -0,0 +1,120 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerAccessTrace.h"
+#include "itkMacro.h"
+
+#include <cstring>
+
+namespace itk
+{
+namespace
+{
+const char     TraceMagic[4] = { 'H', 'C', 'A', 'T' };
+const uint64_t TraceVersion(1);
+
+// Header of a trace, false if the stream does not hold one
+bool
+ReadHeader(std::istream & stream, HDF5ContainerAccessTrace::DimensionsType & dimensions, uint64_t & pixelSize)
+{
+  char     magic[4];
+  uint64_t version(0), numDims(0);
+  stream.read(magic, sizeof(magic));
+  stream.read(reinterpret_cast<char *>(&version), sizeof(version));
+  stream.read(reinterpret_cast<char *>(&numDims), sizeof(numDims));
+  if (!stream || std::memcmp(magic, TraceMagic, sizeof(magic)) != 0 || version != TraceVersion || numDims == 0 ||
+      numDims > 64)
+    return false;
+
+  dimensions.resize(numDims);
+  stream.read(reinterpret_cast<char *>(dimensions.data()), numDims * sizeof(uint64_t));
+  stream.read(reinterpret_cast<char *>(&pixelSize), sizeof(pixelSize));
+  return static_cast<bool>(stream);
+}
+} // namespace
+
+HDF5ContainerAccessTrace::HDF5ContainerAccessTrace(const std::string &    fileName,
+                                                   const DimensionsType & dimensions,
+                                                   uint64_t               pixelSize)
+  : m_NumberOfDimensions(dimensions.size())
+{
+  // Regions of the same image are appended to an existing trace
+  bool append(false);
+  {
+    std::ifstream  existing(fileName, std::ios::binary);
+    DimensionsType existingDimensions;
+    uint64_t       existingPixelSize(0);
+    append = existing && ReadHeader(existing, existingDimensions, existingPixelSize) &&
+             existingDimensions == dimensions && existingPixelSize == pixelSize;
+  }
+
+  this->m_Stream.open(fileName, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+  if (!this->m_Stream)
+    itkGenericExceptionMacro(<< "Unable to open access trace " << fileName);
+  if (append)
+    return;
+
+  const uint64_t numDims(dimensions.size());
+  this->m_Stream.write(TraceMagic, sizeof(TraceMagic));
+  this->m_Stream.write(reinterpret_cast<const char *>(&TraceVersion), sizeof(TraceVersion));
+  this->m_Stream.write(reinterpret_cast<const char *>(&numDims), sizeof(numDims));
+  this->m_Stream.write(reinterpret_cast<const char *>(dimensions.data()), numDims * sizeof(uint64_t));
+  this->m_Stream.write(reinterpret_cast<const char *>(&pixelSize), sizeof(pixelSize));
+}
+
+void
+HDF5ContainerAccessTrace::Record(const ImageIORegion & region)
+{
+  if (region.GetImageDimension() != this->m_NumberOfDimensions)
+    return;
+
+  std::vector<uint64_t> record(2 * this->m_NumberOfDimensions);
+  for (size_t i = 0; i < this->m_NumberOfDimensions; i++)
+  {
+    record[i] = static_cast<uint64_t>(region.GetIndex(i));
+    record[this->m_NumberOfDimensions + i] = region.GetSize(i);
+  }
+
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  this->m_Stream.write(reinterpret_cast<const char *>(record.data()), record.size() * sizeof(uint64_t));
+}
+
+void
+HDF5ContainerAccessTrace::Read(const std::string &          fileName,
+                               DimensionsType &             dimensions,
+                               uint64_t &                   pixelSize,
+                               std::vector<ImageIORegion> & regions)
+{
+  std::ifstream stream(fileName, std::ios::binary);
+  if (!stream || !ReadHeader(stream, dimensions, pixelSize))
+    itkGenericExceptionMacro(<< fileName << " is not an access trace");
+
+  const size_t          numDims(dimensions.size());
+  std::vector<uint64_t> record(2 * numDims);
+  regions.clear();
+  while (stream.read(reinterpret_cast<char *>(record.data()), record.size() * sizeof(uint64_t)))
+  {
+    ImageIORegion region(static_cast<unsigned int>(numDims));
+    for (size_t i = 0; i < numDims; i++)
+    {
+      region.SetIndex(i, static_cast<IndexValueType>(record[i]));
+      region.SetSize(i, record[numDims + i]);
+    }
+    regions.push_back(region);
+  }
+}
+} // end namespace itk
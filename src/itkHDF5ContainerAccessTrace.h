@@ -0,0 +1,68 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerAccessTrace_h
+#define itkHDF5ContainerAccessTrace_h
+
+#include "itkImageIORegion.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerAccessTrace
+ *
+ * \brief Binary log of the regions read from a dataset.
+ *
+ * The file starts with the image dimensions and pixel size, followed by
+ * the index and size of every region read, fastest moving dimension
+ * first, as 64 bit integers. Opening a trace of the same dimensions and
+ * pixel size appends to it, any other trace is replaced.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerAccessTrace
+{
+public:
+  using DimensionsType = std::vector<uint64_t>;
+
+  HDF5ContainerAccessTrace(const std::string & fileName, const DimensionsType & dimensions, uint64_t pixelSize);
+
+  /** Append a region, safe to call from several threads */
+  void
+  Record(const ImageIORegion & region);
+
+  /** Read a trace, throws if the file is not one */
+  static void
+  Read(const std::string &          fileName,
+       DimensionsType &             dimensions,
+       uint64_t &                   pixelSize,
+       std::vector<ImageIORegion> & regions);
+
+private:
+  std::ofstream m_Stream;
+  std::mutex    m_Mutex;
+  size_t        m_NumberOfDimensions;
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerAccessTrace_h
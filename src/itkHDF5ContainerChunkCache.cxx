@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerChunkCache.h"
+#include "itkHDF5ContainerHash.h"
+
+namespace itk
+{
+HDF5ContainerChunkCache &
+HDF5ContainerChunkCache::GetInstance()
+{
+  static HDF5ContainerChunkCache instance;
+  return instance;
+}
+
+size_t
+HDF5ContainerChunkCache::KeyHash::operator()(const KeyType & key) const
+{
+  const uint64_t values[3] = { key.File, key.DataSet, key.Chunk };
+  return static_cast<size_t>(HDF5ContainerHash64(values, sizeof(values)));
+}
+
+HDF5ContainerChunkCache::ShardType &
+HDF5ContainerChunkCache::GetShard(const KeyType & key)
+{
+  // The low bits of the hash pick the bucket within the shard
+  return m_Shards[(KeyHash()(key) >> 32) % NumberOfShards];
+}
+
+void
+HDF5ContainerChunkCache::SetCapacity(size_t decodedBytes, size_t compressedBytes)
+{
+  m_DecodedCapacity = decodedBytes;
+  m_CompressedCapacity = compressedBytes;
+}
+
+HDF5ContainerChunkCache::BufferPointer
+HDF5ContainerChunkCache::FindDecoded(const KeyType & key, uint64_t version)
+{
+  ShardType &                 shard(this->GetShard(key));
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+
+  auto entry(shard.Entries.find(key));
+  if (entry == shard.Entries.end() || entry->second.Decoded == nullptr)
+    return nullptr;
+  if (entry->second.Version != version)
+  {
+    // The chunk has been rewritten since it was cached
+    this->RemoveEntry(shard, entry);
+    return nullptr;
+  }
+
+  shard.DecodedList.splice(shard.DecodedList.begin(), shard.DecodedList, entry->second.Position);
+  m_Hits++;
+  return entry->second.Decoded;
+}
+
+HDF5ContainerChunkCache::BufferPointer
+HDF5ContainerChunkCache::FindStored(const KeyType & key, uint64_t version)
+{
+  ShardType &                 shard(this->GetShard(key));
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+
+  auto entry(shard.Entries.find(key));
+  if (entry == shard.Entries.end() || entry->second.Decoded != nullptr || entry->second.Version != version)
+  {
+    if (entry != shard.Entries.end() && entry->second.Version != version)
+      this->RemoveEntry(shard, entry);
+    m_Misses++;
+    return nullptr;
+  }
+
+  // The caller decodes the chunk and inserts it back into the decoded tier
+  BufferPointer stored(entry->second.Stored);
+  this->RemoveEntry(shard, entry);
+  m_CompressedHits++;
+  return stored;
+}
+
+void
+HDF5ContainerChunkCache::Insert(const KeyType & key, uint64_t version, BufferPointer decoded, BufferPointer stored)
+{
+  ShardType &                 shard(this->GetShard(key));
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+
+  // Another thread may have inserted the chunk meanwhile
+  auto existing(shard.Entries.find(key));
+  if (existing != shard.Entries.end())
+    this->RemoveEntry(shard, existing);
+
+  // Stored chunks no smaller than decoded ones are not worth keeping
+  if (stored != nullptr && stored->size() >= decoded->size())
+    stored = nullptr;
+
+  shard.DecodedList.push_front(key);
+  shard.DecodedBytes += decoded->size() + (stored != nullptr ? stored->size() : 0);
+  shard.Entries[key] = EntryType{ version, std::move(decoded), std::move(stored), shard.DecodedList.begin() };
+  m_NumberOfEntries++;
+
+  this->Evict(shard);
+}
+
+void
+HDF5ContainerChunkCache::Erase(const KeyType & key)
+{
+  ShardType &                 shard(this->GetShard(key));
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+
+  auto entry(shard.Entries.find(key));
+  if (entry != shard.Entries.end())
+    this->RemoveEntry(shard, entry);
+}
+
+void
+HDF5ContainerChunkCache::Clear()
+{
+  for (auto & shard : m_Shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    m_NumberOfEntries -= shard.Entries.size();
+    shard.Entries.clear();
+    shard.DecodedList.clear();
+    shard.CompressedList.clear();
+    shard.DecodedBytes = 0;
+    shard.CompressedBytes = 0;
+  }
+  m_Hits = 0;
+  m_CompressedHits = 0;
+  m_Misses = 0;
+}
+
+HDF5ContainerChunkCache::StatisticsType
+HDF5ContainerChunkCache::GetStatistics() const
+{
+  StatisticsType statistics;
+  statistics.Hits = m_Hits;
+  statistics.CompressedHits = m_CompressedHits;
+  statistics.Misses = m_Misses;
+  for (auto & shard : m_Shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    statistics.DecodedBytes += shard.DecodedBytes;
+    statistics.CompressedBytes += shard.CompressedBytes;
+  }
+  return statistics;
+}
+
+void
+HDF5ContainerChunkCache::RemoveEntry(ShardType & shard, std::unordered_map<KeyType, EntryType, KeyHash>::iterator entry)
+{
+  const EntryType & value(entry->second);
+  if (value.Decoded != nullptr)
+  {
+    shard.DecodedBytes -= value.Decoded->size() + (value.Stored != nullptr ? value.Stored->size() : 0);
+    shard.DecodedList.erase(value.Position);
+  }
+  else
+  {
+    shard.CompressedBytes -= value.Stored->size();
+    shard.CompressedList.erase(value.Position);
+  }
+  shard.Entries.erase(entry);
+  m_NumberOfEntries--;
+}
+
+void
+HDF5ContainerChunkCache::Evict(ShardType & shard)
+{
+  const size_t decodedCapacity(m_DecodedCapacity / NumberOfShards);
+  const size_t compressedCapacity(m_CompressedCapacity / NumberOfShards);
+
+  // Least recently used decoded chunks drop to the compressed tier
+  while (shard.DecodedBytes > decodedCapacity && !shard.DecodedList.empty())
+  {
+    auto        entry(shard.Entries.find(shard.DecodedList.back()));
+    EntryType & value(entry->second);
+    if (value.Stored == nullptr || compressedCapacity == 0)
+    {
+      this->RemoveEntry(shard, entry);
+      continue;
+    }
+
+    shard.DecodedBytes -= value.Decoded->size() + value.Stored->size();
+    shard.DecodedList.pop_back();
+    value.Decoded = nullptr;
+
+    shard.CompressedList.push_front(entry->first);
+    shard.CompressedBytes += value.Stored->size();
+    value.Position = shard.CompressedList.begin();
+  }
+
+  while (shard.CompressedBytes > compressedCapacity && !shard.CompressedList.empty())
+    this->RemoveEntry(shard, shard.Entries.find(shard.CompressedList.back()));
+}
+} // end namespace itk
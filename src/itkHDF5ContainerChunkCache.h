@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerChunkCache_h
+#define itkHDF5ContainerChunkCache_h
+
+#include "itkHDF5ContainerImageIO.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerChunkCache
+ *
+ * \brief Process wide cache of decoded chunks, shared by all ImageIO.
+ *
+ * Chunks are keyed by file, dataset and chunk index, the file by its
+ * path, size and modification time when opened. They carry a version
+ * identifying the stored chunk (its address, size, filter mask and
+ * checksum when recorded). A chunk rewritten in place with the same size
+ * may keep its address, so only chunks of files opened read-only are
+ * inserted, and writers through HDF5ContainerImageIO erase the chunks
+ * they rewrite. The cache is split into shards with their own lock and
+ * least recently used lists, each holding its share of the byte budgets.
+ *
+ * Chunks evicted from the decoded tier move to a compressed tier when
+ * their stored (filtered) form is smaller, a hit there skips the file
+ * read but not the decoding.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerChunkCache
+{
+public:
+  using BufferType = std::vector<unsigned char>;
+  using BufferPointer = std::shared_ptr<const BufferType>;
+  using StatisticsType = HDF5ContainerImageIO::SharedChunkCacheStatisticsType;
+
+  struct KeyType
+  {
+    uint64_t File;
+    uint64_t DataSet;
+    uint64_t Chunk;
+
+    bool
+    operator==(const KeyType & other) const
+    {
+      return File == other.File && DataSet == other.DataSet && Chunk == other.Chunk;
+    }
+  };
+
+  static HDF5ContainerChunkCache &
+  GetInstance();
+
+  /** Byte budgets of the decoded and compressed tiers, shrinking them
+   * evicts chunks on the next insertion */
+  void
+  SetCapacity(size_t decodedBytes, size_t compressedBytes);
+
+  /** Decoded chunk, nullptr if it is not held in the decoded tier */
+  BufferPointer
+  FindDecoded(const KeyType & key, uint64_t version);
+
+  /** Stored form of a chunk, nullptr if it is not held in the compressed
+   * tier. A miss is counted when neither tier holds the chunk, so the
+   * decoded tier is expected to have been searched first */
+  BufferPointer
+  FindStored(const KeyType & key, uint64_t version);
+
+  /** Add a decoded chunk, stored may be nullptr if the chunk is not to be
+   * kept in the compressed tier */
+  void
+  Insert(const KeyType & key, uint64_t version, BufferPointer decoded, BufferPointer stored);
+
+  /** Drop a chunk that is being rewritten */
+  void
+  Erase(const KeyType & key);
+
+  void
+  Clear();
+
+  bool
+  IsEmpty() const
+  {
+    return m_NumberOfEntries == 0;
+  }
+
+  StatisticsType
+  GetStatistics() const;
+
+private:
+  HDF5ContainerChunkCache() = default;
+
+  struct KeyHash
+  {
+    size_t
+    operator()(const KeyType & key) const;
+  };
+
+  struct EntryType
+  {
+    uint64_t                     Version;
+    BufferPointer                Decoded;
+    BufferPointer                Stored;
+    std::list<KeyType>::iterator Position;
+  };
+
+  struct ShardType
+  {
+    mutable std::mutex                              Mutex;
+    std::unordered_map<KeyType, EntryType, KeyHash> Entries;
+    std::list<KeyType>                              DecodedList;
+    std::list<KeyType>                              CompressedList;
+    size_t                                          DecodedBytes{ 0 };
+    size_t                                          CompressedBytes{ 0 };
+  };
+
+  static constexpr size_t NumberOfShards = 16;
+
+  ShardType &
+  GetShard(const KeyType & key);
+
+  // Remove an entry from its tier, the shard lock is held
+  void
+  RemoveEntry(ShardType & shard, std::unordered_map<KeyType, EntryType, KeyHash>::iterator entry);
+
+  // Evict from both tiers until they fit their budgets, the shard lock is held
+  void
+  Evict(ShardType & shard);
+
+  ShardType             m_Shards[NumberOfShards];
+  std::atomic<size_t>   m_DecodedCapacity{ 256 << 20 };
+  std::atomic<size_t>   m_CompressedCapacity{ 256 << 20 };
+  std::atomic<size_t>   m_NumberOfEntries{ 0 };
+  std::atomic<uint64_t> m_Hits{ 0 };
+  std::atomic<uint64_t> m_CompressedHits{ 0 };
+  std::atomic<uint64_t> m_Misses{ 0 };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerChunkCache_h
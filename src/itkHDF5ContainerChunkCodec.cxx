@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerChunkCodec.h"
+#include "itkHDF5ContainerZstdFilter.h"
+#include "itkMacro.h"
+#include "itk_zlib.h"
+
+#include <cstring>
+
+namespace itk
+{
+namespace
+{
+void
+Inflate(const std::vector<unsigned char> & src, size_t capacity, std::vector<unsigned char> & dst)
+{
+  // The inflated size is the chunk size, plus any checksum added by an
+  // earlier filter, grow the buffer if it is exceeded
+  dst.resize(capacity + 64);
+  for (;;)
+  {
+    uLongf    dstLength(static_cast<uLongf>(dst.size()));
+    const int status(uncompress(dst.data(), &dstLength, src.data(), static_cast<uLong>(src.size())));
+    if (status == Z_OK)
+    {
+      dst.resize(dstLength);
+      return;
+    }
+    if (status != Z_BUF_ERROR)
+      itkGenericExceptionMacro(<< "Unable to inflate chunk, zlib error " << status);
+    dst.resize(dst.size() * 2);
+  }
+}
+
+void
+Deflate(const std::vector<unsigned char> & src, int level, std::vector<unsigned char> & dst)
+{
+  uLongf dstLength(compressBound(static_cast<uLong>(src.size())));
+  dst.resize(dstLength);
+  const int status(compress2(dst.data(), &dstLength, src.data(), static_cast<uLong>(src.size()), level));
+  if (status != Z_OK)
+    itkGenericExceptionMacro(<< "Unable to deflate chunk, zlib error " << status);
+  dst.resize(dstLength);
+}
+
+void
+Shuffle(const std::vector<unsigned char> & src, size_t elementSize, std::vector<unsigned char> & dst)
+{
+  dst.resize(src.size());
+  const size_t numElements(elementSize > 0 ? src.size() / elementSize : 0);
+
+  for (size_t b = 0; b < elementSize; b++)
+  {
+    const unsigned char * in = src.data() + b;
+    unsigned char *       out = dst.data() + b * numElements;
+    for (size_t i = 0; i < numElements; i++)
+      out[i] = in[i * elementSize];
+  }
+
+  const size_t shuffled(numElements * elementSize);
+  std::memcpy(dst.data() + shuffled, src.data() + shuffled, src.size() - shuffled);
+}
+
+void
+Unshuffle(const std::vector<unsigned char> & src, size_t elementSize, std::vector<unsigned char> & dst)
+{
+  dst.resize(src.size());
+  const size_t numElements(elementSize > 0 ? src.size() / elementSize : 0);
+
+  for (size_t b = 0; b < elementSize; b++)
+  {
+    const unsigned char * in = src.data() + b * numElements;
+    unsigned char *       out = dst.data() + b;
+    for (size_t i = 0; i < numElements; i++)
+      out[i * elementSize] = in[i];
+  }
+
+  // Trailing bytes that do not form an element are not shuffled
+  const size_t shuffled(numElements * elementSize);
+  std::memcpy(dst.data() + shuffled, src.data() + shuffled, src.size() - shuffled);
+}
+
+// Only the dictionary variant of the Zstandard filter stores a dictionary
+// identifier, after the level
+unsigned int
+DictionaryId(H5Z_filter_t id, const std::vector<unsigned int> & clientData)
+{
+  return id == static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::DictionaryFilterId) && clientData.size() > 1
+           ? clientData[1]
+           : 0;
+}
+} // namespace
+
+HDF5ContainerChunkCodec::HDF5ContainerChunkCodec(const H5::DataSet & ds)
+  : m_ElementSize(ds.getDataType().getSize())
+{
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+  const int             numFilters(plist.getNfilters());
+
+  for (int i = 0; i < numFilters; i++)
+  {
+    unsigned int              flags, filterConfig;
+    size_t                    numClientData(8);
+    std::vector<unsigned int> clientData(numClientData);
+    char                      name[64];
+
+    const H5Z_filter_t id(
+      plist.getFilter(i, flags, numClientData, clientData.data(), sizeof(name), name, filterConfig));
+    clientData.resize(numClientData);
+
+    switch (id)
+    {
+      case H5Z_FILTER_DEFLATE:
+      case H5Z_FILTER_SHUFFLE:
+        break;
+      case H5Z_FILTER_FLETCHER32:
+        m_EncodeSupported = false;
+        break;
+      default:
+        if ((id != static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::FilterId) &&
+             id != static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::DictionaryFilterId)) ||
+            !HDF5ContainerZstdFilter::IsAvailable())
+          m_Supported = false;
+    }
+    m_Filters.push_back(Filter{ id, clientData });
+  }
+  m_EncodeSupported = m_EncodeSupported && m_Supported;
+}
+
+void
+HDF5ContainerChunkCodec::Encode(const void * chunk, size_t chunkBytes, std::vector<unsigned char> & stored) const
+{
+  if (!m_EncodeSupported)
+    itkGenericExceptionMacro(<< "Chunk filter pipeline is not supported");
+
+  const auto *               bytes(static_cast<const unsigned char *>(chunk));
+  std::vector<unsigned char> scratch;
+  stored.assign(bytes, bytes + chunkBytes);
+
+  // Filters are applied in order, stored always holds the output of the
+  // previous step
+  for (const Filter & filter : m_Filters)
+  {
+    switch (filter.Id)
+    {
+      case H5Z_FILTER_DEFLATE:
+        Deflate(stored,
+                filter.ClientData.empty() ? Z_DEFAULT_COMPRESSION : static_cast<int>(filter.ClientData[0]),
+                scratch);
+        break;
+      case H5Z_FILTER_SHUFFLE:
+        Shuffle(stored, filter.ClientData.empty() ? m_ElementSize : filter.ClientData[0], scratch);
+        break;
+      default:
+        HDF5ContainerZstdFilter::Compress(stored.data(),
+                                          stored.size(),
+                                          filter.ClientData.empty() ? 3 : static_cast<int>(filter.ClientData[0]),
+                                          DictionaryId(filter.Id, filter.ClientData),
+                                          scratch);
+    }
+    stored.swap(scratch);
+  }
+}
+
+void
+HDF5ContainerChunkCodec::Decode(std::vector<unsigned char> & stored,
+                                unsigned int                 filterMask,
+                                size_t                       chunkBytes,
+                                std::vector<unsigned char> & decoded) const
+{
+  if (!m_Supported)
+    itkGenericExceptionMacro(<< "Chunk filter pipeline is not supported");
+
+  // Filters are undone in the reverse of the order they were applied,
+  // stored always holds the output of the previous step
+  for (size_t i = m_Filters.size(); i-- > 0;)
+  {
+    if (filterMask & (1u << i))
+      continue;
+
+    const Filter & filter(m_Filters[i]);
+    switch (filter.Id)
+    {
+      case H5Z_FILTER_DEFLATE:
+        Inflate(stored, chunkBytes, decoded);
+        stored.swap(decoded);
+        break;
+      case H5Z_FILTER_SHUFFLE:
+        Unshuffle(stored, filter.ClientData.empty() ? m_ElementSize : filter.ClientData[0], decoded);
+        stored.swap(decoded);
+        break;
+      case H5Z_FILTER_FLETCHER32:
+        if (stored.size() < 4)
+          itkGenericExceptionMacro(<< "Chunk is too small to hold a checksum");
+        stored.resize(stored.size() - 4);
+        break;
+      default:
+      {
+        decoded.resize(HDF5ContainerZstdFilter::GetDecompressedSize(stored.data(), stored.size()));
+        decoded.resize(HDF5ContainerZstdFilter::Decompress(
+          stored.data(), stored.size(), DictionaryId(filter.Id, filter.ClientData), decoded.data(), decoded.size()));
+        stored.swap(decoded);
+      }
+    }
+  }
+
+  if (stored.size() < chunkBytes)
+    itkGenericExceptionMacro(<< "Decoded chunk holds " << stored.size() << " bytes, expected " << chunkBytes);
+  stored.resize(chunkBytes);
+  decoded.swap(stored);
+}
+
+} // end namespace itk
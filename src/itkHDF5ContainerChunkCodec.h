@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerChunkCodec_h
+#define itkHDF5ContainerChunkCodec_h
+
+#include "itk_H5Cpp.h"
+
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerChunkCodec
+ *
+ * \brief Decodes chunks read with H5Dread_chunk outside of libhdf5, and
+ * encodes chunks for H5Dwrite_chunk.
+ *
+ * libhdf5 runs the filter pipeline of a dataset in the calling thread,
+ * and ITK builds it without thread safety, so chunks can only be
+ * inflated one at a time through it. The codec reproduces the pipeline
+ * for the filters written by this module (deflate, shuffle, fletcher32
+ * and Zstandard), letting raw chunks be read serially and decoded in
+ * parallel, and likewise compressed in parallel before being written.
+ * IsSupported() is false if the pipeline holds other filters, in which
+ * case callers read through libhdf5 instead.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerChunkCodec
+{
+public:
+  HDF5ContainerChunkCodec() = default;
+
+  /** Codec for the filter pipeline of a chunked dataset */
+  explicit HDF5ContainerChunkCodec(const H5::DataSet & ds);
+
+  /** True if every filter of the pipeline can be decoded */
+  bool
+  IsSupported() const
+  {
+    return m_Supported;
+  }
+
+  /** True if every filter of the pipeline can be applied by Encode(),
+   * checksums are left to libhdf5 */
+  bool
+  IsEncodeSupported() const
+  {
+    return m_EncodeSupported;
+  }
+
+  /** Apply the filter pipeline to a full chunk of chunkBytes, giving the
+   * bytes to store with H5Dwrite_chunk and a filter mask of 0 */
+  void
+  Encode(const void * chunk, size_t chunkBytes, std::vector<unsigned char> & stored) const;
+
+  /** Decode a chunk as stored in the file into chunkBytes of elements.
+   * Filters whose bit is set in filterMask were skipped when the chunk was
+   * written. The stored buffer is reused as scratch space. */
+  void
+  Decode(std::vector<unsigned char> & stored,
+         unsigned int                 filterMask,
+         size_t                       chunkBytes,
+         std::vector<unsigned char> & decoded) const;
+
+private:
+  struct Filter
+  {
+    H5Z_filter_t              Id;
+    std::vector<unsigned int> ClientData;
+  };
+
+  std::vector<Filter> m_Filters;
+  size_t              m_ElementSize{ 1 };
+  bool                m_Supported{ true };
+  bool                m_EncodeSupported{ true };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerChunkCodec_h
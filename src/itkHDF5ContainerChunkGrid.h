@@ -0,0 +1,321 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerChunkGrid_h
+#define itkHDF5ContainerChunkGrid_h
+
+#include "itkImageIORegion.h"
+#include "itk_H5Cpp.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerChunkGrid
+ *
+ * \brief Describes how a chunked dataset is tiled into chunks.
+ *
+ * All dimensions are in HDF5 order (slowest moving first) and include
+ * the trailing component dimension of vector images, so a chunk is
+ * always addressed exactly as libhdf5 addresses it.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerChunkGrid
+{
+public:
+  using DimensionsType = std::vector<hsize_t>;
+
+  HDF5ContainerChunkGrid() = default;
+
+  HDF5ContainerChunkGrid(const DimensionsType & dataSetDims, const DimensionsType & chunkDims)
+    : m_DataSetDimensions(dataSetDims)
+    , m_ChunkDimensions(chunkDims)
+    , m_GridDimensions(dataSetDims.size())
+  {
+    for (size_t i = 0; i < dataSetDims.size(); i++)
+    {
+      m_GridDimensions[i] = (dataSetDims[i] + chunkDims[i] - 1) / chunkDims[i];
+    }
+  }
+
+  unsigned int
+  GetRank() const
+  {
+    return static_cast<unsigned int>(m_DataSetDimensions.size());
+  }
+
+  const DimensionsType &
+  GetDataSetDimensions() const
+  {
+    return m_DataSetDimensions;
+  }
+
+  const DimensionsType &
+  GetChunkDimensions() const
+  {
+    return m_ChunkDimensions;
+  }
+
+  /** Number of chunks along each dimension */
+  const DimensionsType &
+  GetGridDimensions() const
+  {
+    return m_GridDimensions;
+  }
+
+  hsize_t
+  GetNumberOfChunks() const
+  {
+    hsize_t n(1);
+    for (auto d : m_GridDimensions)
+      n *= d;
+    return m_GridDimensions.empty() ? 0 : n;
+  }
+
+  /** Number of elements in a full (unclipped) chunk */
+  hsize_t
+  GetChunkElements() const
+  {
+    hsize_t n(1);
+    for (auto d : m_ChunkDimensions)
+      n *= d;
+    return n;
+  }
+
+  /** Grid coordinate of the chunk with the given linear index */
+  DimensionsType
+  GetChunkCoordinate(hsize_t chunkIndex) const
+  {
+    DimensionsType coord(m_GridDimensions.size());
+    for (size_t i = m_GridDimensions.size(); i-- > 0;)
+    {
+      coord[i] = chunkIndex % m_GridDimensions[i];
+      chunkIndex /= m_GridDimensions[i];
+    }
+    return coord;
+  }
+
+  /** Linear index of the chunk at the given grid coordinate */
+  hsize_t
+  GetChunkIndex(const DimensionsType & coord) const
+  {
+    hsize_t chunkIndex(0);
+    for (size_t i = 0; i < m_GridDimensions.size(); i++)
+      chunkIndex = chunkIndex * m_GridDimensions[i] + coord[i];
+    return chunkIndex;
+  }
+
+  /** Dataset element offset of the first element of a chunk, this is
+   * the offset expected by H5Dread_chunk and H5Dwrite_chunk */
+  DimensionsType
+  GetChunkOffset(hsize_t chunkIndex) const
+  {
+    DimensionsType offset(this->GetChunkCoordinate(chunkIndex));
+    for (size_t i = 0; i < offset.size(); i++)
+      offset[i] *= m_ChunkDimensions[i];
+    return offset;
+  }
+
+  /** Extent of a chunk clipped to the dataset dimensions */
+  DimensionsType
+  GetChunkExtent(hsize_t chunkIndex) const
+  {
+    DimensionsType offset(this->GetChunkOffset(chunkIndex));
+    DimensionsType extent(m_ChunkDimensions);
+    for (size_t i = 0; i < extent.size(); i++)
+      extent[i] = std::min(m_ChunkDimensions[i], m_DataSetDimensions[i] - offset[i]);
+    return extent;
+  }
+
+  /** Linear indices of all chunks intersecting a hyperslab */
+  std::vector<hsize_t>
+  GetChunksIntersecting(const DimensionsType & offset, const DimensionsType & count) const
+  {
+    std::vector<hsize_t> chunks;
+    const size_t         rank(m_GridDimensions.size());
+    DimensionsType       first(rank), last(rank), coord(rank);
+
+    for (size_t i = 0; i < rank; i++)
+    {
+      if (count[i] == 0)
+        return chunks;
+      first[i] = offset[i] / m_ChunkDimensions[i];
+      last[i] = (offset[i] + count[i] - 1) / m_ChunkDimensions[i];
+    }
+
+    coord = first;
+    for (;;)
+    {
+      chunks.push_back(this->GetChunkIndex(coord));
+
+      // Advance the fastest moving coordinate, carrying into slower ones
+      size_t i(rank);
+      while (i-- > 0)
+      {
+        if (++coord[i] <= last[i])
+          break;
+        coord[i] = first[i];
+      }
+      if (i == static_cast<size_t>(-1))
+        break;
+    }
+    return chunks;
+  }
+
+  /** Intersection of a chunk with a hyperslab, returned as the offset and
+   * count of the overlap in dataset coordinates. Returns false if they
+   * do not overlap */
+  bool
+  GetIntersection(hsize_t                chunkIndex,
+                  const DimensionsType & offset,
+                  const DimensionsType & count,
+                  DimensionsType &       overlapOffset,
+                  DimensionsType &       overlapCount) const
+  {
+    const DimensionsType chunkOffset(this->GetChunkOffset(chunkIndex));
+    const DimensionsType chunkExtent(this->GetChunkExtent(chunkIndex));
+
+    overlapOffset.resize(chunkOffset.size());
+    overlapCount.resize(chunkOffset.size());
+    for (size_t i = 0; i < chunkOffset.size(); i++)
+    {
+      const hsize_t lower(std::max(chunkOffset[i], offset[i]));
+      const hsize_t upper(std::min(chunkOffset[i] + chunkExtent[i], offset[i] + count[i]));
+      if (upper <= lower)
+        return false;
+      overlapOffset[i] = lower;
+      overlapCount[i] = upper - lower;
+    }
+    return true;
+  }
+
+  /** True if the hyperslab covers every element of the (clipped) chunk */
+  bool
+  IsChunkCovered(hsize_t chunkIndex, const DimensionsType & offset, const DimensionsType & count) const
+  {
+    DimensionsType overlapOffset, overlapCount;
+    if (!this->GetIntersection(chunkIndex, offset, count, overlapOffset, overlapCount))
+      return false;
+    return overlapCount == this->GetChunkExtent(chunkIndex);
+  }
+
+private:
+  DimensionsType m_DataSetDimensions;
+  DimensionsType m_ChunkDimensions;
+  DimensionsType m_GridDimensions;
+};
+
+/** Copy an N-D block of elements between two row-major buffers. The
+ * source and destination buffers are described by their dimensions, the
+ * block by its offset within each of them and its count. The fastest
+ * moving dimension is copied with a single memcpy per row. */
+inline void
+HDF5ContainerCopyBlock(const void *                                  src,
+                       const HDF5ContainerChunkGrid::DimensionsType & srcDims,
+                       const HDF5ContainerChunkGrid::DimensionsType & srcOffset,
+                       void *                                        dst,
+                       const HDF5ContainerChunkGrid::DimensionsType & dstDims,
+                       const HDF5ContainerChunkGrid::DimensionsType & dstOffset,
+                       const HDF5ContainerChunkGrid::DimensionsType & count,
+                       size_t                                        elementSize)
+{
+  const size_t rank(count.size());
+  if (rank == 0)
+    return;
+
+  for (size_t i = 0; i < rank; i++)
+  {
+    if (count[i] == 0)
+      return;
+  }
+
+  const size_t                           rowBytes(count[rank - 1] * elementSize);
+  HDF5ContainerChunkGrid::DimensionsType pos(rank, 0);
+
+  for (;;)
+  {
+    size_t srcIndex(0), dstIndex(0);
+    for (size_t i = 0; i < rank; i++)
+    {
+      srcIndex = srcIndex * srcDims[i] + srcOffset[i] + pos[i];
+      dstIndex = dstIndex * dstDims[i] + dstOffset[i] + pos[i];
+    }
+    std::memcpy(static_cast<char *>(dst) + dstIndex * elementSize,
+                static_cast<const char *>(src) + srcIndex * elementSize,
+                rowBytes);
+
+    // Advance over all but the fastest moving dimension
+    size_t i(rank - 1);
+    while (i-- > 0)
+    {
+      if (++pos[i] < count[i])
+        break;
+      pos[i] = 0;
+    }
+    if (i == static_cast<size_t>(-1))
+      break;
+  }
+}
+
+/** Convert an ITK IORegion into an HDF5 hyperslab offset and count. HDF5
+ * dimensions are listed slowest moving first and carry an additional
+ * trailing dimension for the components of vector images. */
+inline void
+HDF5ContainerRegionToHyperslab(const ImageIORegion &                    region,
+                               unsigned int                             numComponents,
+                               HDF5ContainerChunkGrid::DimensionsType & offset,
+                               HDF5ContainerChunkGrid::DimensionsType & count)
+{
+  const unsigned int numDims(region.GetImageDimension());
+  const unsigned int HDFDim(numDims + (numComponents > 1 ? 1 : 0));
+
+  offset.assign(HDFDim, 0);
+  count.assign(HDFDim, 1);
+  for (unsigned int i = 0; i < numDims; i++)
+  {
+    offset[numDims - i - 1] = region.GetIndex(i);
+    count[numDims - i - 1] = region.GetSize(i);
+  }
+  if (numComponents > 1)
+  {
+    count[numDims] = numComponents;
+  }
+}
+
+/** Inverse of HDF5ContainerRegionToHyperslab, the component dimension of
+ * vector images is dropped */
+inline ImageIORegion
+HDF5ContainerHyperslabToRegion(const HDF5ContainerChunkGrid::DimensionsType & offset,
+                               const HDF5ContainerChunkGrid::DimensionsType & count,
+                               unsigned int                                   numDims)
+{
+  ImageIORegion region(numDims);
+  for (unsigned int i = 0; i < numDims; i++)
+  {
+    region.SetIndex(i, static_cast<ImageIORegion::IndexValueType>(offset[numDims - i - 1]));
+    region.SetSize(i, static_cast<ImageIORegion::SizeValueType>(count[numDims - i - 1]));
+  }
+  return region;
+}
+
+} // end namespace itk
+
+#endif // itkHDF5ContainerChunkGrid_h
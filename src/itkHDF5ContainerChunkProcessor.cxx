@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerChunkProcessor.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+void
+HDF5ContainerChunkProcessor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "InputImageIO: " << this->m_InputImageIO.GetPointer() << std::endl;
+  os << indent << "OutputImageIO: " << this->m_OutputImageIO.GetPointer() << std::endl;
+  os << indent << "Halo: " << this->m_Halo << std::endl;
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+}
+
+void
+HDF5ContainerChunkProcessor::Process()
+{
+  if (this->m_InputImageIO == nullptr)
+    itkExceptionMacro(<< "InputImageIO is not set");
+  if (!this->m_ChunkFunction)
+    itkExceptionMacro(<< "ChunkFunction is not set");
+
+  HDF5ContainerImageIO * input(this->m_InputImageIO);
+  HDF5ContainerImageIO * output(this->m_OutputImageIO);
+
+  input->ReadImageInformation();
+
+  const unsigned int               numDims(input->GetNumberOfDimensions());
+  const std::vector<SizeValueType> gridSize(input->GetChunkGridSize());
+  const ImageIORegion              firstChunk(input->GetChunkRegion(0));
+  SizeValueType                    numChunks(1);
+  for (auto n : gridSize)
+    numChunks *= n;
+
+  if (output != nullptr)
+  {
+    output->SetNumberOfDimensions(numDims);
+    for (unsigned int i = 0; i < numDims; i++)
+    {
+      output->SetDimensions(i, input->GetDimensions(i));
+      output->SetSpacing(i, input->GetSpacing(i));
+      output->SetOrigin(i, input->GetOrigin(i));
+      output->SetDirection(i, input->GetDirection(i));
+    }
+    output->SetNumberOfComponents(input->GetNumberOfComponents());
+    output->SetPixelType(input->GetPixelType());
+    if (output->GetComponentType() == IOComponentEnum::UNKNOWNCOMPONENTTYPE)
+      output->SetComponentType(input->GetComponentType());
+
+    // The same chunking keeps input and output chunks in step
+    output->UseChunkingOn();
+    output->UseChunkSizeOn();
+    const ImageIORegion::SizeType chunkSize(firstChunk.GetSize());
+    output->GetChunkSize().assign(chunkSize.begin(), chunkSize.end());
+    output->WriteImageInformation();
+  }
+
+  const size_t inputPixelSize(input->GetComponentSize() * input->GetNumberOfComponents());
+  const size_t outputPixelSize(output != nullptr ? output->GetComponentSize() * output->GetNumberOfComponents() : 0);
+  const long   halo(this->m_Halo);
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  if (this->m_NumberOfWorkUnits > 0)
+  {
+    threader->SetMaximumNumberOfThreads(this->m_NumberOfWorkUnits);
+    threader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  }
+
+  // Each work unit holds one chunk of input and output at a time
+  threader->ParallelizeArray(
+    0,
+    numChunks,
+    [&](SizeValueType chunk) {
+      // Chunks are ordered with the fastest moving dimension varying
+      // fastest, edge chunks are clipped to the image
+      ImageIORegion region(numDims), inputRegion(numDims);
+      SizeValueType remainder(chunk);
+      for (unsigned int i = 0; i < numDims; i++)
+      {
+        const long dim(static_cast<long>(input->GetDimensions(i)));
+        const long index(static_cast<long>(remainder % gridSize[i] * firstChunk.GetSize(i)));
+        const long size(std::min<long>(firstChunk.GetSize(i), dim - index));
+        remainder /= gridSize[i];
+
+        region.SetIndex(i, index);
+        region.SetSize(i, size);
+
+        const long inputIndex(std::max<long>(0, index - halo));
+        inputRegion.SetIndex(i, inputIndex);
+        inputRegion.SetSize(i, std::min<long>(dim, index + size + halo) - inputIndex);
+      }
+
+      std::vector<unsigned char> inputBuffer(inputRegion.GetNumberOfPixels() * inputPixelSize);
+      std::vector<unsigned char> outputBuffer(region.GetNumberOfPixels() * outputPixelSize);
+
+      if (halo == 0)
+        input->ReadChunk(chunk, inputBuffer.data());
+      else
+        input->ReadRegion(inputRegion, inputBuffer.data());
+
+      this->m_ChunkFunction(
+        inputRegion, inputBuffer.data(), region, output != nullptr ? outputBuffer.data() : nullptr);
+
+      if (output != nullptr)
+        output->WriteChunk(chunk, outputBuffer.data());
+    },
+    nullptr);
+}
+} // end namespace itk
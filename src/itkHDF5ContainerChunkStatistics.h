@@ -0,0 +1,203 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerChunkStatistics_h
+#define itkHDF5ContainerChunkStatistics_h
+
+#include "itkHDF5ContainerChunkGrid.h"
+#include "itkHDF5ContainerImageIO.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace itk
+{
+/** Accumulate the statistics of a contiguous run of components. The loop
+ * has no branches and keeps independent partial sums, so the compiler
+ * vectorizes it: integer sums are exact 64 bit sums and floating point
+ * sums are spread over eight lanes, as a single double accumulator would
+ * serialise the additions. */
+template <typename TComponent>
+void
+HDF5ContainerAccumulateStatistics(const TComponent *                          data,
+                                  size_t                                      n,
+                                  TComponent                                  background,
+                                  HDF5ContainerImageIO::ChunkStatisticsType & stats)
+{
+  if (n == 0)
+    return;
+
+  using SumType = std::conditional_t<std::is_integral<TComponent>::value,
+                                     std::conditional_t<std::is_signed<TComponent>::value, int64_t, uint64_t>,
+                                     double>;
+  constexpr size_t Lanes = 8;
+
+  TComponent minimum(data[0]), maximum(data[0]);
+  SumType    sums[Lanes] = {};
+  size_t     foreground[Lanes] = {};
+  size_t     i(0);
+
+  for (; i + Lanes <= n; i += Lanes)
+  {
+    for (size_t j = 0; j < Lanes; j++)
+    {
+      const TComponent v(data[i + j]);
+      minimum = v < minimum ? v : minimum;
+      maximum = v > maximum ? v : maximum;
+      sums[j] += static_cast<SumType>(v);
+      foreground[j] += (v != background);
+    }
+  }
+  for (; i < n; i++)
+  {
+    const TComponent v(data[i]);
+    minimum = v < minimum ? v : minimum;
+    maximum = v > maximum ? v : maximum;
+    sums[0] += static_cast<SumType>(v);
+    foreground[0] += (v != background);
+  }
+
+  double sum(0.0);
+  size_t numForeground(0);
+  for (size_t j = 0; j < Lanes; j++)
+  {
+    sum += static_cast<double>(sums[j]);
+    numForeground += foreground[j];
+  }
+
+  stats.Minimum = std::min(stats.Minimum, static_cast<double>(minimum));
+  stats.Maximum = std::max(stats.Maximum, static_cast<double>(maximum));
+  stats.Sum += sum;
+  stats.Count += n;
+  stats.ForegroundCount += numForeground;
+}
+
+/** Call f(index, n) for each row of an N-D block within a row-major
+ * buffer, index being the element offset of the row and n its length.
+ * Trailing dimensions the block covers completely are merged into the
+ * row, so the components of vector images do not make rows short. */
+template <typename TFunction>
+void
+HDF5ContainerForEachBlockRow(HDF5ContainerChunkGrid::DimensionsType dims,
+                             HDF5ContainerChunkGrid::DimensionsType offset,
+                             HDF5ContainerChunkGrid::DimensionsType count,
+                             TFunction &&                           f)
+{
+  size_t rank(count.size());
+  if (rank == 0)
+    return;
+
+  while (rank > 1 && count[rank - 1] == dims[rank - 1])
+  {
+    dims[rank - 2] *= dims[rank - 1];
+    offset[rank - 2] *= dims[rank - 1];
+    count[rank - 2] *= count[rank - 1];
+    rank--;
+  }
+
+  HDF5ContainerChunkGrid::DimensionsType pos(rank, 0);
+  for (;;)
+  {
+    size_t index(0);
+    for (size_t i = 0; i < rank; i++)
+      index = index * dims[i] + offset[i] + pos[i];
+
+    f(index, static_cast<size_t>(count[rank - 1]));
+
+    size_t i(rank - 1);
+    while (i-- > 0)
+    {
+      if (++pos[i] < count[i])
+        break;
+      pos[i] = 0;
+    }
+    if (i == static_cast<size_t>(-1))
+      break;
+  }
+}
+
+/** Accumulate the statistics of an N-D block within a row-major buffer */
+template <typename TComponent>
+void
+HDF5ContainerAccumulateBlockStatistics(const TComponent *                             data,
+                                       const HDF5ContainerChunkGrid::DimensionsType & dims,
+                                       const HDF5ContainerChunkGrid::DimensionsType & offset,
+                                       const HDF5ContainerChunkGrid::DimensionsType & count,
+                                       TComponent                                     background,
+                                       HDF5ContainerImageIO::ChunkStatisticsType &    stats)
+{
+  HDF5ContainerForEachBlockRow(dims, offset, count, [&](size_t index, size_t n) {
+    HDF5ContainerAccumulateStatistics(data + index, n, background, stats);
+  });
+}
+
+/** Sum of the squared deviations from mean of an N-D block */
+template <typename TComponent>
+double
+HDF5ContainerBlockSquaredDeviations(const TComponent *                             data,
+                                    const HDF5ContainerChunkGrid::DimensionsType & dims,
+                                    const HDF5ContainerChunkGrid::DimensionsType & offset,
+                                    const HDF5ContainerChunkGrid::DimensionsType & count,
+                                    double                                         mean)
+{
+  double squaredDeviations(0.0);
+  HDF5ContainerForEachBlockRow(dims, offset, count, [&](size_t index, size_t n) {
+    for (size_t i = 0; i < n; i++)
+    {
+      const double deviation(static_cast<double>(data[index + i]) - mean);
+      squaredDeviations += deviation * deviation;
+    }
+  });
+  return squaredDeviations;
+}
+
+/** Merge the statistics of two disjoint sets of pixels */
+inline void
+HDF5ContainerMergeStatistics(const HDF5ContainerImageIO::ChunkStatisticsType & source,
+                             HDF5ContainerImageIO::ChunkStatisticsType &       target)
+{
+  if (source.Count == 0)
+    return;
+
+  target.Minimum = std::min(target.Minimum, source.Minimum);
+  target.Maximum = std::max(target.Maximum, source.Maximum);
+  target.Sum += source.Sum;
+  target.Count += source.Count;
+  target.ForegroundCount += source.ForegroundCount;
+}
+
+/** Merge statistics together with their sums of squared deviations from
+ * their means, the pairwise update of Chan et al. */
+inline void
+HDF5ContainerMergeStatistics(const HDF5ContainerImageIO::ChunkStatisticsType & source,
+                             double                                            sourceSquaredDeviations,
+                             HDF5ContainerImageIO::ChunkStatisticsType &       target,
+                             double &                                          targetSquaredDeviations)
+{
+  if (source.Count == 0)
+    return;
+
+  const double countA(static_cast<double>(target.Count));
+  const double countB(static_cast<double>(source.Count));
+  const double delta(source.GetMean() - target.GetMean());
+  targetSquaredDeviations += sourceSquaredDeviations + delta * delta * countA * countB / (countA + countB);
+  HDF5ContainerMergeStatistics(source, target);
+}
+
+} // end namespace itk
+
+#endif // itkHDF5ContainerChunkStatistics_h
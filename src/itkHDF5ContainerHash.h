@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerHash_h
+#define itkHDF5ContainerHash_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace itk
+{
+namespace HDF5ContainerHashDetail
+{
+constexpr uint64_t Prime1 = 11400714785074694791ULL;
+constexpr uint64_t Prime2 = 14029467366897019727ULL;
+constexpr uint64_t Prime3 = 1609587929392839161ULL;
+constexpr uint64_t Prime4 = 9650029242287828579ULL;
+constexpr uint64_t Prime5 = 2870177450012600261ULL;
+
+inline uint64_t
+RotateLeft(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t
+Read64(const unsigned char * p)
+{
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t
+Read32(const unsigned char * p)
+{
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint64_t
+Round(uint64_t acc, uint64_t input)
+{
+  acc += input * Prime2;
+  acc = RotateLeft(acc, 31);
+  return acc * Prime1;
+}
+
+inline uint64_t
+MergeRound(uint64_t acc, uint64_t val)
+{
+  acc ^= Round(0, val);
+  return acc * Prime1 + Prime4;
+}
+} // namespace HDF5ContainerHashDetail
+
+/** 64 bit XXH64 hash of a buffer (little endian hosts). It hashes at
+ * memory bandwidth, so chunks can be fingerprinted as they are written.
+ * Hashes of several buffers are combined by passing the hash of the
+ * previous buffer as the seed of the next. */
+inline uint64_t
+HDF5ContainerHash64(const void * data, size_t length, uint64_t seed = 0)
+{
+  using namespace HDF5ContainerHashDetail;
+
+  const auto *          p = static_cast<const unsigned char *>(data);
+  const unsigned char * end = p + length;
+  uint64_t              h;
+
+  if (length >= 32)
+  {
+    const unsigned char * limit = end - 32;
+    uint64_t              v1 = seed + Prime1 + Prime2;
+    uint64_t              v2 = seed + Prime2;
+    uint64_t              v3 = seed;
+    uint64_t              v4 = seed - Prime1;
+
+    do
+    {
+      v1 = Round(v1, Read64(p));
+      v2 = Round(v2, Read64(p + 8));
+      v3 = Round(v3, Read64(p + 16));
+      v4 = Round(v4, Read64(p + 24));
+      p += 32;
+    } while (p <= limit);
+
+    h = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+    h = MergeRound(h, v1);
+    h = MergeRound(h, v2);
+    h = MergeRound(h, v3);
+    h = MergeRound(h, v4);
+  }
+  else
+  {
+    h = seed + Prime5;
+  }
+
+  h += static_cast<uint64_t>(length);
+
+  for (; p + 8 <= end; p += 8)
+  {
+    h ^= Round(0, Read64(p));
+    h = RotateLeft(h, 27) * Prime1 + Prime4;
+  }
+  if (p + 4 <= end)
+  {
+    h ^= static_cast<uint64_t>(Read32(p)) * Prime1;
+    h = RotateLeft(h, 23) * Prime2 + Prime3;
+    p += 4;
+  }
+  for (; p < end; p++)
+  {
+    h ^= static_cast<uint64_t>(*p) * Prime5;
+    h = RotateLeft(h, 11) * Prime1;
+  }
+
+  h ^= h >> 33;
+  h *= Prime2;
+  h ^= h >> 29;
+  h *= Prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+} // end namespace itk
+
+#endif // itkHDF5ContainerHash_h
@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerHistogram_h
+#define itkHDF5ContainerHistogram_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerHistogram
+ *
+ * \brief Fixed bin count histogram whose range grows with the data.
+ *
+ * The range of a streamed image is unknown until its last region has
+ * been written. The histogram starts with the range of the first values
+ * added, and when later values fall outside it the bin width is doubled
+ * by merging pairs of neighbouring bins, extending the range towards the
+ * new values. Merged bins cover exactly the bins they replace, so counts
+ * never need to be redistributed. Integer images use integral bin widths.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerHistogram
+{
+public:
+  using CountType = unsigned long long;
+
+  explicit HDF5ContainerHistogram(unsigned int numberOfBins)
+    : m_Bins(numberOfBins + numberOfBins % 2, 0)
+  {}
+
+  const std::vector<CountType> &
+  GetBins() const
+  {
+    return m_Bins;
+  }
+
+  double
+  GetMinimum() const
+  {
+    return m_Minimum;
+  }
+
+  double
+  GetMaximum() const
+  {
+    return m_Minimum + m_BinWidth * static_cast<double>(m_Bins.size());
+  }
+
+  /** Extend the range to include [minimum, maximum]. Infinite values are
+   * counted in the first or last bin */
+  void
+  Cover(double minimum, double maximum, bool integral)
+  {
+    const double n(static_cast<double>(m_Bins.size()));
+
+    if (m_BinWidth == 0.0)
+    {
+      m_Minimum = std::isfinite(minimum) ? minimum : 0.0;
+      double width(std::isfinite(maximum) ? (maximum - m_Minimum) / n : 0.0);
+      if (integral)
+        width = std::ceil(width);
+      m_BinWidth = width > 0.0 ? width : 1.0;
+      if (integral && maximum >= this->GetMaximum())
+        m_BinWidth += 1.0;
+      return;
+    }
+
+    while (std::isfinite(minimum) && minimum < m_Minimum)
+    {
+      this->MergeBins(true);
+      m_Minimum -= m_BinWidth * n / 2.0;
+    }
+    while (std::isfinite(maximum) && maximum > this->GetMaximum())
+    {
+      this->MergeBins(false);
+    }
+  }
+
+  /** Count the values of a buffer, which must lie within the range, and
+   * return the sum of their squared deviations from mean */
+  template <typename TComponent>
+  double
+  Add(const TComponent * data, size_t count, double mean)
+  {
+    const double scale(1.0 / m_BinWidth);
+    const size_t last(m_Bins.size() - 1);
+    double       squaredDeviations(0.0);
+
+    for (size_t i = 0; i < count; i++)
+    {
+      const double value(static_cast<double>(data[i]));
+      const double position((value - m_Minimum) * scale);
+      const size_t bin(position > 0.0 ? std::min(static_cast<size_t>(position), last) : 0);
+      m_Bins[bin]++;
+      squaredDeviations += (value - mean) * (value - mean);
+    }
+    return squaredDeviations;
+  }
+
+private:
+  // Double the bin width, the merged bins fill the upper half of the
+  // histogram if it is extended downwards, otherwise the lower half
+  void
+  MergeBins(bool downwards)
+  {
+    const size_t           half(m_Bins.size() / 2);
+    std::vector<CountType> merged(m_Bins.size(), 0);
+    for (size_t i = 0; i < half; i++)
+      merged[(downwards ? half : 0) + i] = m_Bins[2 * i] + m_Bins[2 * i + 1];
+    m_Bins.swap(merged);
+    m_BinWidth *= 2.0;
+  }
+
+  std::vector<CountType> m_Bins;
+  double                 m_Minimum{ 0.0 };
+  double                 m_BinWidth{ 0.0 };
+};
+
+} // end namespace itk
+
+#endif // itkHDF5ContainerHistogram_h
@@ -17,16 +17,55 @@
  *=========================================================================*/
 #include "itkHDF5ContainerImageIO.h"
 #include "itkArray.h"
+#include "itkHDF5ContainerAccessTrace.h"
+#include "itkHDF5ContainerChunkCache.h"
+#include "itkHDF5ContainerChunkCodec.h"
+#include "itkHDF5ContainerChunkGrid.h"
+#include "itkHDF5ContainerChunkStatistics.h"
+#include "itkHDF5ContainerHash.h"
+#include "itkHDF5ContainerHistogram.h"
+#include "itkHDF5ContainerLocalChunkCache.h"
+#include "itkHDF5ContainerPixelOperations.h"
+#include "itkHDF5ContainerProjections.h"
+#include "itkHDF5ContainerZstdFilter.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
 #include "itkVersion.h"
 #include "itk_H5Cpp.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <iomanip>
+#include <mutex>
 #include <regex>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#if defined(H5_HAVE_DIRECT)
+#  include <sys/statvfs.h>
+#endif
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#if defined(HDF5Container_USE_MPI)
+#  if !defined(H5_HAVE_PARALLEL)
+#    error HDF5Container_USE_MPI requires HDF5 built with parallel (MPI-IO) support.\
+  Please build ITK against a parallel HDF5 (by setting ITK_USE_SYSTEM_HDF5 to ON).
+#  endif
+#  include <mpi.h>
+#  if defined(H5_HAVE_SUBFILING_VFD)
+#    include <sys/stat.h>
+#  endif
+#endif
+
 namespace itk
 {
 
@@ -42,11 +81,21 @@ HDF5ContainerImageIO::HDF5ContainerImageIO()
 
   this->Self::SetMaximumCompressionLevel(9);
   this->Self::SetCompressionLevel(5);
+
+  // Make the Zstandard filter known to libhdf5 so that datasets using it
+  // can be read and written without the external plugin. Zstandard
+  // levels go beyond the 9 of deflate
+  if (HDF5ContainerZstdFilter::IsAvailable())
+  {
+    HDF5ContainerZstdFilter::Register();
+    this->Self::SetMaximumCompressionLevel(HDF5ContainerZstdFilter::GetMaximumLevel());
+  }
 }
 
 HDF5ContainerImageIO::~HDF5ContainerImageIO()
 {
   this->CloseH5File();
+  this->ReleaseZstdDictionary();
 }
 
 void
@@ -93,6 +142,175 @@ HDF5ContainerImageIO ::PrintSelf(std::ostream & os, Indent indent) const
   {
     os << indent << "UseInferredDimensions: Off" << std::endl;
   }
+
+  if (m_UseChunkSize)
+  {
+    os << indent << "UseChunkSize: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseChunkSize: Off" << std::endl;
+  }
+
+  if (m_UseZstdDictionary)
+  {
+    os << indent << "UseZstdDictionary: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseZstdDictionary: Off" << std::endl;
+  }
+  os << indent << "ZstdDictionaryCapacity: " << this->m_ZstdDictionaryCapacity << std::endl;
+
+  if (m_UseShuffle)
+  {
+    os << indent << "UseShuffle: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseShuffle: Off" << std::endl;
+  }
+
+  if (m_UseSparse)
+  {
+    os << indent << "UseSparse: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseSparse: Off" << std::endl;
+  }
+
+  if (m_UseWriteCombining)
+  {
+    os << indent << "UseWriteCombining: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseWriteCombining: Off" << std::endl;
+  }
+
+  if (m_UseUpdate)
+  {
+    os << indent << "UseUpdate: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseUpdate: Off" << std::endl;
+  }
+
+  if (m_UseCheckpoints)
+  {
+    os << indent << "UseCheckpoints: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseCheckpoints: Off" << std::endl;
+  }
+  os << indent << "CheckpointInterval: " << this->m_CheckpointInterval << std::endl;
+
+  if (m_UseChunkHashes)
+  {
+    os << indent << "UseChunkHashes: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseChunkHashes: Off" << std::endl;
+  }
+
+  if (m_UseChunkChecksums)
+  {
+    os << indent << "UseChunkChecksums: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseChunkChecksums: Off" << std::endl;
+  }
+  os << indent << "FillValue: " << this->m_FillValue << std::endl;
+
+  if (m_UseChunkStatistics)
+  {
+    os << indent << "UseChunkStatistics: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseChunkStatistics: Off" << std::endl;
+  }
+
+  if (m_UseImageStatistics)
+  {
+    os << indent << "UseImageStatistics: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseImageStatistics: Off" << std::endl;
+  }
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+
+  if (m_UseProjections)
+  {
+    os << indent << "UseProjections: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseProjections: Off" << std::endl;
+  }
+
+  if (m_UseMeanProjections)
+  {
+    os << indent << "UseMeanProjections: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseMeanProjections: Off" << std::endl;
+  }
+  os << indent << "ThumbnailSize: " << this->m_ThumbnailSize << std::endl;
+
+  if (m_UseSharedChunkCache)
+  {
+    os << indent << "UseSharedChunkCache: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseSharedChunkCache: Off" << std::endl;
+  }
+  os << indent << "LocalChunkCacheDirectory: " << this->m_LocalChunkCacheDirectory << std::endl;
+  os << indent << "LocalChunkCacheCapacity: " << this->m_LocalChunkCacheCapacity << std::endl;
+  os << indent << "AccessTraceFileName: " << this->m_AccessTraceFileName << std::endl;
+
+  if (m_UseMPIIO)
+  {
+    os << indent << "UseMPIIO: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseMPIIO: Off" << std::endl;
+  }
+
+  switch (m_FileDriver)
+  {
+    case FileDriverEnum::SEC2:
+      os << indent << "FileDriver: SEC2" << std::endl;
+      break;
+    case FileDriverEnum::Family:
+      os << indent << "FileDriver: Family" << std::endl;
+      break;
+    case FileDriverEnum::Subfiling:
+      os << indent << "FileDriver: Subfiling" << std::endl;
+      break;
+    case FileDriverEnum::Split:
+      os << indent << "FileDriver: Split" << std::endl;
+      break;
+  }
+  os << indent << "FamilyMemberSize: " << this->m_FamilyMemberSize << std::endl;
+
+  if (m_UseDirectIO)
+  {
+    os << indent << "UseDirectIO: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseDirectIO: Off" << std::endl;
+  }
 }
 
 //
@@ -104,6 +322,187 @@ const std::string Directions("Directions");
 const std::string Spacing("Spacing");
 const std::string Dimensions("Dimension");
 const std::string MetaDataName("MCT");
+const std::string ZstdDictionarySuffix("_ZstdDictionary");
+const std::string ChunkStatisticsSuffix("_ChunkStatistics");
+const std::string MaximumProjectionSuffix("_MaximumProjection");
+const std::string MeanProjectionSuffix("_MeanProjection");
+const std::string MaximumProjectionThumbnailSuffix("_MaximumProjectionThumbnail");
+const std::string ThumbnailSuffix("_Thumbnail");
+const std::string CheckpointCompletedChunks("CheckpointCompletedChunks");
+const std::string ChunkHashesSuffix("_ChunkHashes");
+const std::string ChunkChecksumsSuffix("_ChunkChecksums");
+
+// Minimum, maximum, sum, count and foreground count of each chunk
+constexpr size_t ChunkStatisticsFields = 5;
+
+// Image statistics attributes, also the metadata dictionary keys
+const std::string StatisticsMinimum("Minimum");
+const std::string StatisticsMaximum("Maximum");
+const std::string StatisticsMean("Mean");
+const std::string StatisticsStandardDeviation("StandardDeviation");
+const std::string StatisticsHistogram("Histogram");
+const std::string StatisticsHistogramRange("HistogramRange");
+const std::string StatisticsForegroundCount("ForegroundCount");
+const std::string StatisticsFingerprint("StatisticsFingerprint");
+
+// Content fingerprint attribute, preceded by the storage fingerprint
+const std::string ContentFingerprint("ContentFingerprint");
+
+using FileDriverEnum = HDF5ContainerImageIO::FileDriverEnum;
+
+// Family containers are stored in member files named after the
+// container, with the index of the member before the extension
+std::string
+FamilyMemberPrefix(const std::string & fileName)
+{
+  const std::filesystem::path path(fileName);
+  return (path.parent_path() / path.stem()).string() + '-';
+}
+
+std::string
+FamilyMemberFileName(const std::string & fileName, unsigned int index)
+{
+  std::ostringstream name;
+  name << FamilyMemberPrefix(fileName) << std::setw(5) << std::setfill('0') << index
+       << std::filesystem::path(fileName).extension().string();
+  return name.str();
+}
+
+// The printf pattern libhdf5 derives the member file names from
+std::string
+FamilyMemberPattern(const std::string & fileName)
+{
+  const auto escape = [](const std::string & text) {
+    std::string escaped;
+    for (char c : text)
+    {
+      escaped += c;
+      if (c == '%')
+        escaped += '%';
+    }
+    return escaped;
+  };
+  return escape(FamilyMemberPrefix(fileName)) + "%05d" +
+         escape(std::filesystem::path(fileName).extension().string());
+}
+
+// Subfiled containers keep their configuration in a file named after the
+// stub file and its inode, beside it unless libhdf5 is told otherwise
+bool
+HasSubfilingConfig(const std::string & fileName)
+{
+#if defined(HDF5Container_USE_MPI) && defined(H5_HAVE_SUBFILING_VFD)
+  struct stat status;
+  if (stat(fileName.c_str(), &status) != 0)
+    return false;
+
+  const std::filesystem::path path(fileName);
+  const char *                prefix(std::getenv(H5FD_SUBFILING_CONFIG_FILE_PREFIX));
+  const std::filesystem::path directory(prefix != nullptr ? std::filesystem::path(prefix) : path.parent_path());
+  const std::string           configName(path.filename().string() + ".subfile_" +
+                                std::to_string(static_cast<uint64_t>(status.st_ino)) + ".config");
+  return std::filesystem::exists(directory / configName);
+#else
+  (void)fileName;
+  return false;
+#endif
+}
+
+// Split containers append these to the file name
+const char * const SplitMetaDataExtension(".meta");
+const char * const SplitRawDataExtension(".raw");
+constexpr size_t   SplitMetaDataIncrement = 1 << 20;
+
+// Find the driver an existing container was written with, false if
+// there is none
+bool
+FindContainerFileDriver(const std::string & fileName, FileDriverEnum & driver)
+{
+  if (std::filesystem::exists(fileName))
+  {
+    driver = HasSubfilingConfig(fileName) ? FileDriverEnum::Subfiling : FileDriverEnum::SEC2;
+    return true;
+  }
+  if (std::filesystem::exists(FamilyMemberFileName(fileName, 0)))
+  {
+    driver = FileDriverEnum::Family;
+    return true;
+  }
+  if (std::filesystem::exists(fileName + SplitMetaDataExtension))
+  {
+    driver = FileDriverEnum::Split;
+    return true;
+  }
+  return false;
+}
+
+// The name libhdf5 opens a container written with the driver by
+std::string
+DriverFileName(const std::string & fileName, FileDriverEnum driver)
+{
+  return driver == FileDriverEnum::Family ? FamilyMemberPattern(fileName) : fileName;
+}
+
+// The file of a container holding its superblock
+std::string
+SuperblockFileName(const std::string & fileName, FileDriverEnum driver)
+{
+  switch (driver)
+  {
+    case FileDriverEnum::Family:
+      return FamilyMemberFileName(fileName, 0);
+    case FileDriverEnum::Split:
+      return fileName + SplitMetaDataExtension;
+    default:
+      return fileName;
+  }
+}
+
+#if defined(H5_HAVE_DIRECT)
+// Size of the buffer the direct driver copies unaligned transfers through
+constexpr size_t DirectIOCopyBufferSize = 16 << 20;
+
+// Block size of the filesystem a file is, or is to be, stored on, which
+// direct transfers have to be aligned to
+size_t
+GetFileSystemBlockSize(const std::string & fileName)
+{
+  std::filesystem::path directory(std::filesystem::path(fileName).parent_path());
+  if (directory.empty())
+    directory = ".";
+
+  struct statvfs status;
+  if (statvfs(directory.c_str(), &status) != 0 || status.f_bsize == 0)
+    return 4096;
+  return status.f_bsize;
+}
+#endif
+
+// Select the drivers needing no MPI, returns false if libhdf5 fails to
+bool
+SetupSerialFileAccess(const H5::FileAccPropList & fapl, FileDriverEnum driver, hsize_t familyMemberSize)
+{
+  switch (driver)
+  {
+    case FileDriverEnum::Family:
+      return H5Pset_fapl_family(fapl.getId(), familyMemberSize, H5P_DEFAULT) >= 0;
+    case FileDriverEnum::Split:
+    {
+      // The metadata file is held in memory, read with one request when
+      // opened and written back when flushed, the chunks go to the raw
+      // file directly
+      H5::FileAccPropList metaDataAccess;
+      return H5Pset_fapl_core(metaDataAccess.getId(), SplitMetaDataIncrement, 1) >= 0 &&
+             H5Pset_fapl_split(fapl.getId(),
+                               SplitMetaDataExtension,
+                               metaDataAccess.getId(),
+                               SplitRawDataExtension,
+                               H5P_DEFAULT) >= 0;
+    }
+    default:
+      return true;
+  }
+}
 
 template <typename TScalar>
 H5::PredType
@@ -292,6 +691,132 @@ doesAttrExist(const H5::H5Object & object, const char * const name)
   return (H5Aexists(object.getId(), name) > 0 ? true : false);
 }
 
+// Chunk layout of an existing dataset
+HDF5ContainerChunkGrid
+GetDataSetChunkGrid(const H5::DataSet & ds)
+{
+  H5::DataSpace                          space(ds.getSpace());
+  const int                              rank(space.getSimpleExtentNdims());
+  HDF5ContainerChunkGrid::DimensionsType dims(rank), chunkDims(rank);
+
+  space.getSimpleExtentDims(dims.data());
+
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+  if (plist.getLayout() != H5D_CHUNKED)
+    itkGenericExceptionMacro(<< "DataSet is not chunked");
+  plist.getChunk(rank, chunkDims.data());
+
+  return HDF5ContainerChunkGrid(dims, chunkDims);
+}
+
+// Fingerprint of the storage of a dataset: its shape, type and layout,
+// and the address, size and filter mask of every chunk. Rewriting a
+// compressed chunk moves or resizes it, so the content is identified
+// without being read. Chunks rewritten in place with the same size, as
+// uncompressed chunks are, leave it unchanged, which is why the values
+// cached with it are removed when the dataset is opened for update.
+uint64_t
+GetDataSetFingerprint(const H5::DataSet & ds)
+{
+  H5::DataSpace                          space(ds.getSpace());
+  const int                              rank(space.getSimpleExtentNdims());
+  HDF5ContainerChunkGrid::DimensionsType dims(rank);
+  space.getSimpleExtentDims(dims.data());
+
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+  std::vector<uint64_t> words(dims.begin(), dims.end());
+  words.push_back(ds.getDataType().getSize());
+  words.push_back(static_cast<uint64_t>(ds.getDataType().getClass()));
+  words.push_back(static_cast<uint64_t>(plist.getLayout()));
+
+  if (plist.getLayout() == H5D_CHUNKED)
+  {
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+    words.insert(words.end(), grid.GetChunkDimensions().begin(), grid.GetChunkDimensions().end());
+    for (hsize_t chunk = 0; chunk < grid.GetNumberOfChunks(); chunk++)
+    {
+      const HDF5ContainerChunkGrid::DimensionsType offset(grid.GetChunkOffset(chunk));
+      unsigned int                                 filterMask(0);
+      haddr_t                                      address(HADDR_UNDEF);
+      hsize_t                                      size(0);
+      H5Dget_chunk_info_by_coord(ds.getId(), offset.data(), &filterMask, &address, &size);
+      words.push_back(address);
+      words.push_back(size);
+      words.push_back(filterMask);
+    }
+  }
+  else
+  {
+    words.push_back(H5Dget_offset(ds.getId()));
+    words.push_back(ds.getStorageSize());
+  }
+
+  return HDF5ContainerHash64(words.data(), words.size() * sizeof(uint64_t));
+}
+
+#if defined(POSIX_FADV_DONTNEED)
+// Byte ranges of the file storing the elements selected in space, as
+// offset and length: the allocated chunks intersecting the selection, or
+// the span of a contiguous dataset from its first to its last selected
+// element. Compact datasets live in the object header and have none.
+std::vector<std::pair<SizeValueType, SizeValueType>>
+GetDataSetByteRanges(const H5::DataSet & ds, const H5::DataSpace & space)
+{
+  std::vector<std::pair<SizeValueType, SizeValueType>> ranges;
+  if (space.getSelectNpoints() <= 0)
+    return ranges;
+
+  const int                              rank(space.getSimpleExtentNdims());
+  HDF5ContainerChunkGrid::DimensionsType first(rank), last(rank), count(rank);
+  space.getSelectBounds(first.data(), last.data());
+  for (int i = 0; i < rank; i++)
+    count[i] = last[i] - first[i] + 1;
+
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+  if (plist.getLayout() == H5D_CHUNKED)
+  {
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+    for (auto chunk : grid.GetChunksIntersecting(first, count))
+    {
+      const HDF5ContainerChunkGrid::DimensionsType offset(grid.GetChunkOffset(chunk));
+      unsigned int                                 filterMask(0);
+      haddr_t                                      address(HADDR_UNDEF);
+      hsize_t                                      size(0);
+      if (H5Dget_chunk_info_by_coord(ds.getId(), offset.data(), &filterMask, &address, &size) >= 0 &&
+          address != HADDR_UNDEF && size > 0)
+        ranges.emplace_back(address, size);
+    }
+  }
+  else if (plist.getLayout() == H5D_CONTIGUOUS)
+  {
+    const haddr_t address(H5Dget_offset(ds.getId()));
+    if (address == HADDR_UNDEF)
+      return ranges;
+
+    HDF5ContainerChunkGrid::DimensionsType dims(rank);
+    space.getSimpleExtentDims(dims.data());
+    hsize_t firstElement(0), lastElement(0);
+    for (int i = 0; i < rank; i++)
+    {
+      firstElement = firstElement * dims[i] + first[i];
+      lastElement = lastElement * dims[i] + last[i];
+    }
+    const hsize_t elementSize(ds.getDataType().getSize());
+    ranges.emplace_back(address + firstElement * elementSize, (lastElement - firstElement + 1) * elementSize);
+  }
+  return ranges;
+}
+#endif
+
+// Checksum of the stored bytes of a chunk, zero is kept for chunks
+// without a checksum
+uint64_t
+GetChunkChecksum(const std::vector<unsigned char> & stored)
+{
+  const uint64_t checksum(HDF5ContainerHash64(stored.data(), stored.size()));
+  return checksum == 0 ? 1 : checksum;
+}
+
 } // namespace
 
 void
@@ -771,11 +1296,19 @@ HDF5ContainerImageIO ::CanReadFile(const char * FileNameToRead)
 {
   // HDF5 is overly verbose in complaining that
   //     a file does not exist.
-  if (!std::filesystem::exists(FileNameToRead))
+  FileDriverEnum driver(FileDriverEnum::SEC2);
+  if (!FindContainerFileDriver(FileNameToRead, driver))
   {
     return false;
   }
 
+  // The stub of a subfiled container is only opened through MPI, its
+  // configuration file identifies it
+  if (driver == FileDriverEnum::Subfiling)
+  {
+    return true;
+  }
+
   // HDF5 is so exception happy, we have to worry about
   // it throwing a wobbly here if the file doesn't exist
   // or has some other problem.
@@ -783,14 +1316,19 @@ HDF5ContainerImageIO ::CanReadFile(const char * FileNameToRead)
   try
   {
 
-    htri_t ishdf5(H5Fis_hdf5(FileNameToRead));
+    htri_t ishdf5(H5Fis_hdf5(SuperblockFileName(FileNameToRead, driver).c_str()));
 
     if (ishdf5 <= 0)
     {
       return false;
     }
 
-    H5::H5File h5file(FileNameToRead, H5F_ACC_RDONLY);
+    H5::FileAccPropList fapl;
+    if (!SetupSerialFileAccess(fapl, driver, H5F_FAMILY_DEFAULT))
+    {
+      return false;
+    }
+    H5::H5File h5file(DriverFileName(FileNameToRead, driver), H5F_ACC_RDONLY, H5::FileCreatPropList::DEFAULT, fapl);
   }
   catch (...)
   {
@@ -804,6 +1342,71 @@ HDF5ContainerImageIO ::CloseH5File()
 {
   if (this->m_H5File != nullptr)
   {
+    if (!this->m_WriteCombiningChunks.empty() && this->m_ImageInformationWritten)
+    {
+      try
+      {
+        this->FlushWriteCombining();
+      }
+      catch (ExceptionObject & error)
+      {
+        itkWarningMacro(<< "Unable to write combined chunks: " << error.GetDescription());
+      }
+    }
+    this->m_WriteCombiningChunks.clear();
+
+    if (this->m_CheckpointModified)
+    {
+      try
+      {
+        this->WriteCheckpoint();
+      }
+      catch (ExceptionObject & error)
+      {
+        itkWarningMacro(<< "Unable to store checkpoint: " << error.GetDescription());
+      }
+    }
+
+    if (this->m_ChunkHashesModified)
+    {
+      try
+      {
+        this->WriteChunkHashes();
+      }
+      catch (ExceptionObject & error)
+      {
+        itkWarningMacro(<< "Unable to store chunk hashes: " << error.GetDescription());
+      }
+    }
+
+    if (this->m_ChunkChecksumsModified)
+    {
+      try
+      {
+        this->WriteChunkChecksums();
+      }
+      catch (ExceptionObject & error)
+      {
+        itkWarningMacro(<< "Unable to store chunk checksums: " << error.GetDescription());
+      }
+    }
+
+    if (this->m_ChunkStatisticsModified)
+    {
+      try
+      {
+        this->WriteChunkStatistics();
+      }
+      catch (ExceptionObject & error)
+      {
+        itkWarningMacro(<< "Unable to store chunk statistics: " << error.GetDescription());
+      }
+    }
+
+    // Pages of the last transfer still being written back when it was
+    // advised
+    this->DropPageCache();
+    this->m_PageCacheRanges.clear();
     this->m_H5File->close();
   }
 }
@@ -814,26 +1417,58 @@ HDF5ContainerImageIO ::ReadImageInformation()
   try
   {
     this->CloseH5File();
+    this->m_ChunkStatistics.clear();
+    this->m_CheckpointElementsWritten.clear();
+    this->m_ChunkHashes.clear();
+    this->m_ChunkHashesModified = false;
+    this->m_ChunkChecksums.clear();
+    this->m_DirtyChunkChecksums.clear();
+    this->m_ChunkChecksumsModified = false;
+    this->m_Updating = false;
+    std::atomic_store(&this->m_ChunkEncoder, std::shared_ptr<const HDF5ContainerChunkCodec>());
 
     // Open file as read-only
-    this->m_H5File.reset(new H5::H5File(this->GetFileName(), H5F_ACC_RDONLY));
+    this->OpenH5File(H5F_ACC_RDONLY);
 
     // Check for the existence of the path
     if (!this->GetPathExists(this->GetPath()))
       itkExceptionMacro(<< this->GetPath() << " does not exist");
 
     H5::DataSet ds(this->GetDataSet());
+    this->UpdateChunkCacheKey();
 
     // Intialise the image by reading all
     // ITK related dataset attributes
     this->ReadDataSetAttributes(ds);
 
+    // Register any Zstandard dictionary needed to decompress the chunks
+    this->LoadZstdDictionary(ds);
+
+    // Regions read from now on are appended to the access trace
+    this->m_AccessTrace.reset();
+    if (!this->m_AccessTraceFileName.empty())
+    {
+      HDF5ContainerAccessTrace::DimensionsType dimensions(this->GetNumberOfDimensions());
+      for (unsigned int i = 0; i < dimensions.size(); i++)
+        dimensions[i] = this->GetDimensions(i);
+      this->m_AccessTrace.reset(new HDF5ContainerAccessTrace(
+        this->m_AccessTraceFileName, dimensions, this->GetComponentSize() * this->GetNumberOfComponents()));
+    }
+
+    // Checksums the chunks read are verified against
+    const std::string checksumsPath(this->GetDataSetPath() + ChunkChecksumsSuffix);
+    if (this->GetUseChunkChecksums() && this->GetPathExists(checksumsPath))
+      this->m_ChunkChecksums = this->ReadVector<uint64_t>(checksumsPath);
+
     //
     // read metadata
     MetaDataDictionary & metaDict(this->GetMetaDataDictionary());
     // Necessary to clear dict if ImageIO object is re-used
     metaDict.Clear();
 
+    // Statistics accumulated when the image was written
+    this->ReadImageStatistics(ds, metaDict);
+
 #ifdef METADATA_READING
     if (this->GetUseMetaData())
     {
@@ -1082,6 +1717,9 @@ HDF5ContainerImageIO ::Read(void * buffer)
 
   itkDebugMacro(<< "regionToRead: " << regionToRead);
 
+  if (this->m_AccessTrace != nullptr)
+    this->m_AccessTrace->Record(regionToRead);
+
   // Get dataset
   H5::DataSet ds(this->GetDataSet());
 
@@ -1093,7 +1731,25 @@ HDF5ContainerImageIO ::Read(void * buffer)
 
   try
   {
-    ds.read(buffer, voxelType, dspace, imageSpace);
+    if ((this->GetUseSharedChunkCache() || !this->m_LocalChunkCacheDirectory.empty() ||
+         !this->m_ChunkChecksums.empty()) &&
+        !this->GetUseDataSetOffset() && !this->GetUseDataSetStride() && !this->GetUseMPIIO() &&
+        this->ReadThroughChunkCache(buffer))
+      return;
+
+    // libhdf5 skips chunks that were never written when the fill time is
+    // never (sparse datasets), fill them here with a memset instead
+    H5::DSetCreatPropList plist(ds.getCreatePlist());
+    if (plist.getLayout() == H5D_CHUNKED && plist.getFillTime() == H5D_FILL_TIME_NEVER)
+    {
+      std::vector<unsigned char> fillValue(voxelType.getSize(), 0);
+      if (plist.isFillValueDefined() != H5D_FILL_VALUE_UNDEFINED)
+        plist.getFillValue(voxelType, fillValue.data());
+      HDF5ContainerFill(buffer, dspace.getSimpleExtentNpoints(), fillValue.data(), fillValue.size());
+    }
+
+    ds.read(buffer, voxelType, dspace, imageSpace, this->GetTransferPropList());
+    this->DropPageCache(ds, imageSpace);
   }
   catch (H5::AttributeIException & error)
   {
@@ -1193,22 +1849,214 @@ HDF5ContainerImageIO ::WriteMetaArray(const std::string & name, MetaDataObjectBa
 }
 #endif
 
+bool
+HDF5ContainerImageIO::IsMPIIOAvailable()
+{
+#if defined(HDF5Container_USE_MPI)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool
+HDF5ContainerImageIO::IsSubfilingAvailable()
+{
+#if defined(HDF5Container_USE_MPI) && defined(H5_HAVE_SUBFILING_VFD)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+HDF5ContainerImageIO::SetupFileAccess(H5::FileAccPropList & fapl, FileDriverEnum driver, bool create)
+{
+  if (driver == FileDriverEnum::Family || driver == FileDriverEnum::Split)
+  {
+    // Collective transfers need a driver built on MPI-IO, which the
+    // family and split drivers are not
+    if (this->GetUseMPIIO())
+      itkExceptionMacro(<< "Family and split containers can't be accessed with UseMPIIO, use the Subfiling driver");
+
+    // The member size of an existing container is taken from it
+    if (!SetupSerialFileAccess(fapl, driver, create ? this->GetFamilyMemberSize() : H5F_FAMILY_DEFAULT))
+      itkExceptionMacro(<< "Unable to select the file driver for " << this->GetFileName());
+    return;
+  }
+
+  if (driver == FileDriverEnum::Subfiling && !this->GetUseMPIIO())
+    itkExceptionMacro(<< "Subfiled containers can only be accessed with UseMPIIO, " << this->GetFileName()
+                      << " is one");
+
+  if (this->GetUseMPIIO())
+  {
+#if defined(HDF5Container_USE_MPI)
+    int initialized(0);
+    MPI_Initialized(&initialized);
+    if (!initialized)
+      itkExceptionMacro(<< "MPI_Init() must be called before the file is accessed with UseMPIIO");
+
+    if (driver == FileDriverEnum::Subfiling)
+    {
+#  if defined(H5_HAVE_SUBFILING_VFD)
+      if (H5Pset_mpi_params(fapl.getId(), MPI_COMM_WORLD, MPI_INFO_NULL) < 0 ||
+          H5Pset_fapl_subfiling(fapl.getId(), nullptr) < 0)
+        itkExceptionMacro(<< "Unable to select the subfiling driver for " << this->GetFileName());
+#  else
+      itkExceptionMacro(<< "The HDF5 library the module is built with lacks the subfiling driver");
+#  endif
+    }
+    else if (H5Pset_fapl_mpio(fapl.getId(), MPI_COMM_WORLD, MPI_INFO_NULL) < 0)
+      itkExceptionMacro(<< "Unable to select the MPI-IO driver for " << this->GetFileName());
+#else
+    itkExceptionMacro(<< "UseMPIIO requires the module to be built with HDF5Container_USE_MPI");
+#endif
+  }
+  else if (this->GetUseDirectIO() && driver == FileDriverEnum::SEC2)
+  {
+#if defined(H5_HAVE_DIRECT)
+    // Chunks of a block or more start on a block, so reading them needs
+    // no copy
+    const size_t blockSize(GetFileSystemBlockSize(this->GetFileName()));
+    if (H5Pset_fapl_direct(fapl.getId(), blockSize, blockSize, DirectIOCopyBufferSize) < 0 ||
+        H5Pset_alignment(fapl.getId(), blockSize, blockSize) < 0)
+      itkExceptionMacro(<< "Unable to select the direct driver for " << this->GetFileName());
+#endif
+  }
+}
+
+bool
+HDF5ContainerImageIO::IsDirectIOAvailable()
+{
+#if defined(H5_HAVE_DIRECT)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+HDF5ContainerImageIO::DropPageCache(const H5::DataSet & ds, const H5::DataSpace & space)
+{
+#if defined(POSIX_FADV_DONTNEED)
+  if (!this->GetUseDirectIO() || this->m_H5File == nullptr)
+    return;
+
+  // The fallback for files not opened with the direct driver, which
+  // bypasses the cache itself: the transfers went through the cache, the
+  // pages of the bytes transferred are dropped afterwards. Dirty pages
+  // are only queued for writeback by the advice and dropped once written,
+  // so those of the previous transfer are advised again rather than the
+  // file being synchronised
+  this->DropPageCache();
+  this->m_PageCacheRanges = GetDataSetByteRanges(ds, space);
+  this->DropPageCache();
+#else
+  (void)ds;
+  (void)space;
+#endif
+}
+
+void
+HDF5ContainerImageIO::DropPageCache()
+{
+#if defined(POSIX_FADV_DONTNEED)
+  if (this->m_PageCacheRanges.empty() || this->m_H5File == nullptr)
+    return;
+
+  // Only the descriptor of sec2 is known
+  const H5::FileAccPropList fapl(this->m_H5File->getAccessPlist());
+  void *                    handle(nullptr);
+  if (fapl.getDriver() != H5FD_SEC2 || H5Fget_vfd_handle(this->m_H5File->getId(), H5P_DEFAULT, &handle) < 0 ||
+      handle == nullptr)
+    return;
+
+  const int descriptor(*static_cast<int *>(handle));
+  for (const auto & range : this->m_PageCacheRanges)
+    posix_fadvise(descriptor, static_cast<off_t>(range.first), static_cast<off_t>(range.second), POSIX_FADV_DONTNEED);
+#endif
+}
+
+void
+HDF5ContainerImageIO::OpenH5File(unsigned int flags)
+{
+  // Existing containers are opened with the driver they were written with
+  FileDriverEnum driver(this->GetFileDriver());
+  FindContainerFileDriver(this->GetFileName(), driver);
+
+  H5::FileAccPropList fapl;
+  this->SetupFileAccess(fapl, driver, false);
+  this->m_H5File.reset(new H5::H5File(
+    DriverFileName(this->GetFileName(), driver), flags, H5::FileCreatPropList::DEFAULT, fapl));
+}
+
+bool
+HDF5ContainerImageIO::FindFileDriver(FileDriverEnum & driver)
+{
+  char found[2] = { 0, 0 };
+  if (FindContainerFileDriver(this->GetFileName(), driver))
+  {
+    found[0] = 1;
+    found[1] = static_cast<char>(driver);
+  }
+
+#if defined(HDF5Container_USE_MPI)
+  // The file is created collectively, a process checking after another
+  // has started creating it must still take the same path
+  if (this->GetUseMPIIO())
+  {
+    MPI_Bcast(found, 2, MPI_CHAR, 0, MPI_COMM_WORLD);
+    if (found[0])
+      driver = static_cast<FileDriverEnum>(found[1]);
+  }
+#endif
+
+  return found[0] != 0;
+}
+
+H5::DSetMemXferPropList
+HDF5ContainerImageIO::GetTransferPropList() const
+{
+  H5::DSetMemXferPropList xfer;
+
+#if defined(HDF5Container_USE_MPI)
+  // Every process takes part in each transfer, letting MPI-IO aggregate
+  // the regions into large contiguous requests
+  if (this->GetUseMPIIO())
+    H5Pset_dxpl_mpio(xfer.getId(), H5FD_MPIO_COLLECTIVE);
+#endif
+
+  return xfer;
+}
+
 void
-HDF5ContainerImageIO::ResetH5File(const H5::FileAccPropList fapl)
+HDF5ContainerImageIO::ResetH5File(H5::FileAccPropList fapl)
 {
+  // An existing container is added to with the driver it was written
+  // with, its files would be left beside a container recreated with
+  // another
+  FileDriverEnum driver(this->GetFileDriver());
+  const bool     exists(this->FindFileDriver(driver));
+  if (exists && this->GetReCreate() && driver != this->GetFileDriver())
+    itkExceptionMacro(<< this->GetFileName() << " was written with another file driver, remove it to recreate it");
+
+  this->SetupFileAccess(fapl, driver, !exists || this->GetReCreate());
+  const std::string fileName(DriverFileName(this->GetFileName(), driver));
+
   try
   {
-    if (!std::filesystem::exists(this->GetFileName()))
+    if (!exists)
     {
       // The file doesn't exist, attempt to create a new file
-      this->m_H5File.reset(new H5::H5File(this->GetFileName(), H5F_ACC_TRUNC, H5::FileCreatPropList::DEFAULT, fapl));
+      this->m_H5File.reset(new H5::H5File(fileName, H5F_ACC_TRUNC, H5::FileCreatPropList::DEFAULT, fapl));
     }
     else
     {
       // The file already exists, depending on the state of the ReCreate flat
       // always create a new file or open it in read/write mode
       this->m_H5File.reset(new H5::H5File(
-        this->GetFileName(), this->GetReCreate() ? H5F_ACC_TRUNC : H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, fapl));
+        fileName, this->GetReCreate() ? H5F_ACC_TRUNC : H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, fapl));
     }
   }
   catch (H5::FileIException & error)
@@ -1323,6 +2171,162 @@ HDF5ContainerImageIO::GetDataSet()
   return this->m_H5File->openDataSet(this->GetDataSetPath());
 }
 
+HDF5ContainerChunkGrid
+HDF5ContainerImageIO::GetChunkGrid() const
+{
+  const unsigned int numComponents(this->GetNumberOfComponents());
+  const unsigned int numDims(this->GetNumberOfDimensions());
+
+  // HDF5 dimensions listed slowest moving first, ITK are fastest
+  // moving first.
+  HDF5ContainerChunkGrid::DimensionsType dims(numDims + (numComponents == 1 ? 0 : 1));
+  HDF5ContainerChunkGrid::DimensionsType chunkDims(dims.size());
+
+  for (unsigned int i(0), j(numDims - 1); i < numDims; i++, j--)
+  {
+    dims[j] = this->m_Dimensions[i];
+
+    if (this->m_UseChunkSize)
+    {
+      if (this->m_ChunkSize.size() != numDims)
+        itkExceptionMacro(<< "Invalid chunk size dimension: " << this->m_ChunkSize.size());
+
+      // Chunks larger than the dataset only waste space
+      chunkDims[j] = std::max<hsize_t>(1, std::min<hsize_t>(this->m_ChunkSize[i], dims[j]));
+    }
+    else
+    {
+      // The default chunk is the N-1 dimension region
+      chunkDims[j] = (j == 0 ? 1 : dims[j]);
+    }
+  }
+  if (numComponents > 1)
+  {
+    dims[numDims] = numComponents;
+    chunkDims[numDims] = numComponents;
+  }
+
+  return HDF5ContainerChunkGrid(dims, chunkDims);
+}
+
+void
+HDF5ContainerImageIO::TrainZstdDictionary(const ImageIORegion & region, const void * buffer)
+{
+  if (!this->GetUseCompression() || !this->GetUseZstdDictionary())
+    return;
+  if (this->m_ImageInformationWritten)
+    itkExceptionMacro(<< "The Zstandard dictionary has to be trained before WriteImageInformation()");
+
+  const HDF5ContainerChunkGrid           grid(this->GetChunkGrid());
+  const size_t                           elementSize(this->GetComponentSize());
+  HDF5ContainerChunkGrid::DimensionsType offset, count;
+
+  HDF5ContainerRegionToHyperslab(region, this->GetNumberOfComponents(), offset, count);
+
+  // Each chunk's share of the region is one training sample, Zstandard
+  // recommends around 100 times the dictionary capacity of sample data
+  const size_t               sampleLimit(static_cast<size_t>(this->m_ZstdDictionaryCapacity) * 100);
+  std::vector<unsigned char> samples;
+  std::vector<size_t>        sampleSizes;
+
+  for (auto chunk : grid.GetChunksIntersecting(offset, count))
+  {
+    HDF5ContainerChunkGrid::DimensionsType overlapOffset, overlapCount;
+    if (!grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount))
+      continue;
+
+    size_t sampleSize(elementSize);
+    for (size_t i = 0; i < overlapCount.size(); i++)
+    {
+      sampleSize *= overlapCount[i];
+      overlapOffset[i] -= offset[i];
+    }
+
+    if (samples.size() + sampleSize > sampleLimit)
+      break;
+
+    const size_t pos(samples.size());
+    samples.resize(pos + sampleSize);
+    HDF5ContainerCopyBlock(buffer,
+                           count,
+                           overlapOffset,
+                           samples.data() + pos,
+                           overlapCount,
+                           HDF5ContainerChunkGrid::DimensionsType(overlapCount.size(), 0),
+                           overlapCount,
+                           elementSize);
+    sampleSizes.push_back(sampleSize);
+  }
+
+  this->ReleaseZstdDictionary();
+  this->m_ZstdDictionary =
+    HDF5ContainerZstdFilter::TrainDictionary(samples, sampleSizes, this->m_ZstdDictionaryCapacity);
+
+  if (this->m_ZstdDictionary.empty())
+  {
+    itkWarningMacro(<< "Not enough sample data to train a Zstandard dictionary, compressing without one");
+  }
+  else
+  {
+    HDF5ContainerZstdFilter::AddDictionary(this->m_ZstdDictionary);
+    this->m_ZstdDictionaryId = HDF5ContainerZstdFilter::GetDictionaryId(this->m_ZstdDictionary);
+  }
+}
+
+void
+HDF5ContainerImageIO::ReleaseZstdDictionary()
+{
+  if (this->m_ZstdDictionaryId != 0)
+  {
+    HDF5ContainerZstdFilter::ReleaseDictionary(this->m_ZstdDictionaryId);
+    this->m_ZstdDictionaryId = 0;
+  }
+}
+
+void
+HDF5ContainerImageIO::LoadZstdDictionary(const H5::DataSet & ds)
+{
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+
+  for (int i = 0; i < plist.getNfilters(); i++)
+  {
+    unsigned int flags, filterConfig;
+    unsigned int cdValues[2] = { 0, 0 };
+    size_t       cdNelmts(2);
+    char         name[64];
+
+    const H5Z_filter_t id(plist.getFilter(i, flags, cdNelmts, cdValues, sizeof(name), name, filterConfig));
+    if (id != static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::FilterId) &&
+        id != static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::DictionaryFilterId))
+      continue;
+
+    if (!HDF5ContainerZstdFilter::IsAvailable())
+      itkExceptionMacro(<< "DataSet: " << this->GetDataSetName()
+                        << " is compressed with Zstandard, which this module was built without");
+
+    // Only the dictionary filter has a dictionary identifier, a
+    // reference to the dictionary is held until another is needed
+    if (id != static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::DictionaryFilterId) || cdNelmts < 2 ||
+        cdValues[1] == 0 || cdValues[1] == this->m_ZstdDictionaryId)
+      return;
+
+    this->ReleaseZstdDictionary();
+    if (!HDF5ContainerZstdFilter::AcquireDictionary(cdValues[1]))
+    {
+      const std::string dictionaryPath(this->GetDataSetPath() + ZstdDictionarySuffix);
+      if (!this->GetPathExists(dictionaryPath))
+        itkExceptionMacro(<< dictionaryPath << " does not exist");
+
+      const std::vector<unsigned char> dictionary(this->ReadVector<unsigned char>(dictionaryPath));
+      if (HDF5ContainerZstdFilter::GetDictionaryId(dictionary) != cdValues[1])
+        itkExceptionMacro(<< dictionaryPath << " is not dictionary " << cdValues[1]);
+      HDF5ContainerZstdFilter::AddDictionary(dictionary);
+    }
+    this->m_ZstdDictionaryId = cdValues[1];
+    return;
+  }
+}
+
 void
 HDF5ContainerImageIO::WriteDataSetAttributes(H5::DataSet ds)
 {
@@ -1626,6 +2630,19 @@ HDF5ContainerImageIO::WriteImageInformation()
     return;
   }
 
+  // Each process only sees its own regions, the state these options
+  // gather from all of them can't be kept
+  if (this->GetUseMPIIO() &&
+      (this->GetUseSparse() || this->GetUseChunkStatistics() || this->GetUseImageStatistics() ||
+       this->GetUseProjections() || this->GetUseWriteCombining() || this->GetUseCheckpoints() ||
+       this->GetUseChunkHashes() || this->GetUseChunkChecksums() ||
+       (this->GetUseCompression() && this->GetUseZstdDictionary())))
+  {
+    itkExceptionMacro(<< "UseMPIIO can't be combined with UseSparse, UseChunkStatistics, UseImageStatistics, "
+                      << "UseProjections, UseWriteCombining, UseCheckpoints, UseChunkHashes, UseChunkChecksums "
+                      << "or UseZstdDictionary");
+  }
+
   try
   {
     this->CloseH5File();
@@ -1645,11 +2662,44 @@ HDF5ContainerImageIO::WriteImageInformation()
     // Reset the HDF5 file
     this->ResetH5File(fapl);
 
+    // An existing dataset is written in place, when updating or resuming
+    // an interrupted write
+    if (!this->GetReCreate() && this->GetPathExists(this->GetDataSetPath()) &&
+        (this->GetUseUpdate() ||
+         (this->GetUseCheckpoints() && this->GetDataSet().attrExists(CheckpointCompletedChunks))))
+    {
+      // The statistics and projections gather every region written, those
+      // written before the interruption are not seen again
+      if (!this->GetUseUpdate() &&
+          (this->GetUseChunkStatistics() || this->GetUseImageStatistics() || this->GetUseProjections()))
+        itkExceptionMacro(<< "Unable to resume writing " << this->GetDataSetName()
+                          << " with UseChunkStatistics, UseImageStatistics or UseProjections, resume without them "
+                          << "and call ComputeStatistics() once it is complete");
+
+      this->OpenDataSetForUpdate();
+      if (this->GetUseCheckpoints())
+        this->LoadCheckpoint(this->GetDataSet());
+      this->m_ImageInformationWritten = true;
+      return;
+    }
+
     H5::Group group(this->GetGroup());
 
     // Write a timestamp attribute on the group
     // auto strTimeStamp(this->GetTimestamp());
-    this->WriteStringAttr(group, MCT_METADATA_TIMESTAMP_ATTR, this->GetCurrentTimeString());
+    std::string timestamp(this->GetCurrentTimeString());
+#if defined(HDF5Container_USE_MPI)
+    // Attributes are written collectively, all processes must write the
+    // same value
+    if (this->GetUseMPIIO())
+    {
+      int length(static_cast<int>(timestamp.size()));
+      MPI_Bcast(&length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+      timestamp.resize(length);
+      MPI_Bcast(&timestamp[0], length, MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+#endif
+    this->WriteStringAttr(group, MCT_METADATA_TIMESTAMP_ATTR, timestamp);
 
     // First, check if the dataset already exists
     if (!this->GetOverwrite() && group.nameExists(this->GetDataSetName()))
@@ -1679,20 +2729,66 @@ HDF5ContainerImageIO::WriteImageInformation()
     H5::PredType  dataType(ComponentToPredType(this->GetComponentType()));
 
     H5::DSetCreatPropList plist;
+    const bool            useZstd(this->GetUseCompression() && this->GetUseZstdDictionary());
+
+    // Shuffling precedes compression in the filter pipeline
+    if (this->GetUseCompression() && this->GetUseShuffle())
+      plist.setShuffle();
+
+    if (useZstd && !this->m_ZstdDictionary.empty())
+    {
+      // Zstandard level followed by the dictionary identifier
+      const unsigned int cdValues[2] = { static_cast<unsigned int>(this->GetCompressionLevel()),
+                                         HDF5ContainerZstdFilter::GetDictionaryId(this->m_ZstdDictionary) };
+      plist.setFilter(HDF5ContainerZstdFilter::DictionaryFilterId, H5Z_FLAG_MANDATORY, 2, cdValues);
+    }
+    else if (useZstd)
+    {
+      // Without enough data to train a dictionary the chunks are written
+      // as the standard Zstandard plugin would
+      const unsigned int level(static_cast<unsigned int>(this->GetCompressionLevel()));
+      plist.setFilter(HDF5ContainerZstdFilter::FilterId, H5Z_FLAG_MANDATORY, 1, &level);
+    }
+    else if (this->GetUseCompression())
+    {
+      // Set compression level, deflate levels stop at 9
+      plist.setDeflate(std::min(this->GetCompressionLevel(), 9));
+    }
+
+    if (this->GetUseChunking() || useZstd || this->GetUseSparse() || this->GetUseChunkStatistics() ||
+        this->GetUseCheckpoints() || this->GetUseChunkHashes() || this->GetUseChunkChecksums())
+    {
+      // If chunking is selected set the chunk size to the user
+      // specified size, or the N-1 dimension region by default
+      plist.setChunk(numDims, this->GetChunkGrid().GetChunkDimensions().data());
+    }
 
-    if (this->GetUseCompression())
+    // The parts of chunks never written hold the fill value
+    const std::vector<unsigned char> fillValue(
+      HDF5ContainerComponentBytes(this->GetComponentType(), this->GetFillValue()));
+    plist.setFillValue(dataType, fillValue.data());
+
+    if (this->GetUseSparse())
     {
-      // Set compression level
-      plist.setDeflate(this->GetCompressionLevel());
+      // Chunks are only allocated when written, and never filled by
+      // libhdf5, Write() skips chunks holding only the fill value
+      plist.setFillTime(H5D_FILL_TIME_NEVER);
+      plist.setAllocTime(H5D_ALLOC_TIME_INCR);
+
+      this->m_SparseWrittenChunks.assign(this->GetChunkGrid().GetNumberOfChunks(), false);
     }
 
-    if (this->GetUseChunking())
+    this->m_ChunkStatistics.clear();
+    this->m_ChunkStatisticsModified = false;
+    this->m_ImageStatistics = ChunkStatisticsType();
+    this->m_ImageSquaredDeviations = 0.0;
+    this->m_Histogram.reset();
+    this->m_Projections.reset();
+    this->m_NumberOfPixelsWritten = 0;
+    std::atomic_store(&this->m_ChunkEncoder, std::shared_ptr<const HDF5ContainerChunkCodec>());
+    if (this->GetUseChunkStatistics())
     {
-      // If chunking is selected set the chunk
-      // size to be the N-1 dimension region
-      dims[0] = 1;
-      plist.setChunk(numDims, dims.get());
-      dims.reset();
+      this->m_ChunkStatistics.assign(this->GetChunkGrid().GetNumberOfChunks(), ChunkStatisticsType());
     }
 
     // Create the image dataset in the group
@@ -1700,8 +2796,29 @@ HDF5ContainerImageIO::WriteImageInformation()
 
     ds = group.createDataSet(this->GetDataSetName(), dataType, imageSpace, plist);
 
+    // The dictionary is stored beside the image, it is needed to
+    // decompress any of its chunks
+    if (useZstd && !this->m_ZstdDictionary.empty())
+    {
+      const std::string dictionaryPath(this->GetDataSetPath() + ZstdDictionarySuffix);
+      if (this->GetPathExists(dictionaryPath))
+        this->m_H5File->unlink(dictionaryPath);
+      this->WriteVector(dictionaryPath, this->m_ZstdDictionary);
+    }
+
     // Write ITK image specific attributes to the dataset
     this->WriteDataSetAttributes(ds);
+    this->UpdateChunkCacheKey();
+
+    // The first checkpoint records that nothing was written, so the
+    // dataset can be resumed however early the writer stops
+    if (this->GetUseCheckpoints())
+    {
+      this->LoadCheckpoint(ds);
+      this->WriteCheckpoint();
+    }
+    this->LoadChunkHashes(ds, true);
+    this->LoadChunkChecksums(ds, true);
 
     // Write image MetaData to the dataset in subgroup
     if (this->GetUseMetaData())
@@ -1755,14 +2872,17 @@ HDF5ContainerImageIO::WriteImageMetaDataOnly(const MetaDataDictionary & metaDict
   Please use a different version of HDF5, e.g. the one bundled with ITK (by setting ITK_USE_SYSTEM_HDF5 to OFF).
 #endif
 
-    if (!std::filesystem::exists(this->GetFileName()))
+    FileDriverEnum driver(this->GetFileDriver());
+    if (!this->FindFileDriver(driver))
     {
       itkExceptionMacro(<< this->GetFileName() << " does not exist, can't write metadata");
     }
     else
     {
       // The file already exists, open in read/write mode
-      this->m_H5File.reset(new H5::H5File(this->GetFileName(), H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, fapl));
+      this->SetupFileAccess(fapl, driver, false);
+      this->m_H5File.reset(new H5::H5File(
+        DriverFileName(this->GetFileName(), driver), H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, fapl));
     }
 
     H5::Group group(this->GetGroup());
@@ -1806,6 +2926,13 @@ HDF5ContainerImageIO::WriteImageMetaDataOnly(const MetaDataDictionary & metaDict
 void
 HDF5ContainerImageIO ::Write(const void * buffer)
 {
+  // The dictionary is trained from the first region written, it has
+  // to exist before the dataset and its filter pipeline are created
+  if (!this->m_ImageInformationWritten)
+  {
+    this->TrainZstdDictionary(this->GetIORegion(), buffer);
+  }
+
   this->WriteImageInformation();
 
   try
@@ -1832,7 +2959,87 @@ HDF5ContainerImageIO ::Write(const void * buffer)
 
     H5::DataSet ds(this->GetDataSet());
 
-    ds.write(buffer, dataType, dspace, imageSpace);
+    if (this->m_Updating)
+    {
+      // Regions completed before an interrupted write are not written
+      // again
+      if (this->GetUseCheckpoints() && this->IsRegionCompleted(this->GetIORegion()))
+        return;
+
+      // Statistics or fingerprints computed since the dataset was opened
+      // do not describe the region written
+      this->RemoveDerivedData(ds);
+      if (this->m_ChunkHashes.empty())
+        ds.write(buffer, dataType, dspace, imageSpace, this->GetTransferPropList());
+      else
+        this->WriteChangedChunks(buffer, ds);
+      this->EraseFromSharedChunkCache();
+      if (!this->m_ChunkChecksums.empty())
+        this->MarkChunkChecksumsDirty(ds);
+      if (this->GetUseCheckpoints())
+        this->AccumulateCheckpoint(ds);
+      this->DropPageCache(ds, imageSpace);
+      return;
+    }
+
+    // Regions covering chunks partly are gathered, and written chunk by
+    // chunk through this method once complete
+    if (this->GetUseWriteCombining() && !this->m_WriteCombining && this->CombineWrite(buffer, ds))
+      return;
+
+    if (this->GetUseSparse())
+    {
+      this->WriteSparse(buffer, ds);
+    }
+    else
+    {
+      ds.write(buffer, dataType, dspace, imageSpace, this->GetTransferPropList());
+    }
+
+    // Chunks cached by readers of the dataset are stale once rewritten
+    this->EraseFromSharedChunkCache();
+
+    if (!this->m_ChunkHashes.empty())
+    {
+      this->AccumulateChunkHashes(buffer, ds);
+    }
+    if (!this->m_ChunkChecksums.empty())
+    {
+      this->MarkChunkChecksumsDirty(ds);
+    }
+
+    if (this->GetUseCheckpoints())
+    {
+      this->AccumulateCheckpoint(ds);
+    }
+
+    if (this->GetUseChunkStatistics())
+    {
+      this->AccumulateChunkStatistics(buffer, ds);
+    }
+    if (this->GetUseImageStatistics())
+    {
+      this->AccumulateImageStatistics(buffer);
+    }
+    if (this->GetUseProjections())
+    {
+      this->AccumulateProjections(buffer);
+    }
+
+    // Statistics are stored once the whole image has been written, chunk
+    // statistics of a partly written image are stored when it is closed
+    this->m_NumberOfPixelsWritten += this->GetIORegion().GetNumberOfPixels();
+    if (this->m_NumberOfPixelsWritten >= this->GetImageSizeInPixels())
+    {
+      if (this->m_ChunkStatisticsModified)
+        this->WriteChunkStatistics();
+      if (this->GetUseImageStatistics())
+        this->WriteImageStatistics(ds);
+      if (this->GetUseProjections())
+        this->WriteProjections();
+    }
+
+    this->DropPageCache(ds, imageSpace);
   }
   // catch failure caused by the H5File operations
   catch (H5::FileIException & error)
@@ -1856,6 +3063,2656 @@ HDF5ContainerImageIO ::Write(const void * buffer)
   }
 }
 
+bool
+HDF5ContainerImageIO::CombineWrite(const void * buffer, const H5::DataSet & ds)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->GetUseDataSetOffset() || this->GetUseDataSetStride() || ds.getCreatePlist().getLayout() != H5D_CHUNKED)
+    return false;
+
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  const size_t                 elementSize(this->GetComponentSize());
+  const size_t                 rank(grid.GetRank());
+  DimensionsType               offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+
+  // Regions made of whole chunks are written as they are
+  const std::vector<hsize_t> chunks(grid.GetChunksIntersecting(offset, count));
+  bool                       aligned(true);
+  for (auto chunk : chunks)
+  {
+    if (this->m_WriteCombiningChunks.count(chunk) != 0 || !grid.IsChunkCovered(chunk, offset, count))
+      aligned = false;
+  }
+  if (aligned)
+    return false;
+
+  // The parts of a chunk never written hold the fill value of the dataset
+  const std::vector<unsigned char> fillValue(
+    HDF5ContainerComponentBytes(this->GetComponentType(), this->GetFillValue()));
+
+  for (auto chunk : chunks)
+  {
+    DimensionsType overlapOffset, overlapCount;
+    grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount);
+
+    const DimensionsType chunkOffset(grid.GetChunkOffset(chunk));
+    const DimensionsType extent(grid.GetChunkExtent(chunk));
+    hsize_t              numElements(1), numOverlap(1);
+    for (size_t i = 0; i < rank; i++)
+    {
+      numElements *= extent[i];
+      numOverlap *= overlapCount[i];
+    }
+
+    WriteCombiningChunkType & pending(this->m_WriteCombiningChunks[chunk]);
+    if (pending.Data.empty())
+    {
+      pending.Data.resize(numElements * elementSize);
+      HDF5ContainerFill(pending.Data.data(), numElements, fillValue.data(), elementSize);
+    }
+
+    DimensionsType chunkStart(rank), bufferStart(rank);
+    for (size_t i = 0; i < rank; i++)
+    {
+      chunkStart[i] = overlapOffset[i] - chunkOffset[i];
+      bufferStart[i] = overlapOffset[i] - offset[i];
+    }
+    HDF5ContainerCopyBlock(
+      buffer, count, bufferStart, pending.Data.data(), extent, chunkStart, overlapCount, elementSize);
+
+    pending.NumberOfElementsWritten += numOverlap;
+    if (pending.NumberOfElementsWritten >= numElements)
+      this->FlushWriteCombiningChunk(chunk);
+  }
+  return true;
+}
+
+void
+HDF5ContainerImageIO::FlushWriteCombiningChunk(SizeValueType chunk)
+{
+  auto it(this->m_WriteCombiningChunks.find(chunk));
+  if (it == this->m_WriteCombiningChunks.end())
+    return;
+
+  const WriteCombiningChunkType pending(std::move(it->second));
+  this->m_WriteCombiningChunks.erase(it);
+
+  // The chunk is written as a region of its own, so the sparse, statistics
+  // and projections options see it as any other region
+  const ImageIORegion region(this->GetIORegion());
+  this->m_WriteCombining = true;
+  try
+  {
+    this->SetIORegion(this->GetChunkRegion(chunk));
+    this->Write(pending.Data.data());
+  }
+  catch (...)
+  {
+    this->m_WriteCombining = false;
+    this->SetIORegion(region);
+    throw;
+  }
+  this->m_WriteCombining = false;
+  this->SetIORegion(region);
+}
+
+void
+HDF5ContainerImageIO::FlushWriteCombining()
+{
+  while (!this->m_WriteCombiningChunks.empty())
+    this->FlushWriteCombiningChunk(this->m_WriteCombiningChunks.begin()->first);
+}
+
+void
+HDF5ContainerImageIO::WriteSparse(const void * buffer, H5::DataSet & ds)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  const HDF5ContainerChunkGrid     grid(GetDataSetChunkGrid(ds));
+  const size_t                     elementSize(this->GetComponentSize());
+  const int                        rank(static_cast<int>(grid.GetRank()));
+  const std::vector<unsigned char> fillValue(HDF5ContainerComponentBytes(this->GetComponentType(), this->GetFillValue()));
+  H5::PredType                     dataType(ComponentToPredType(this->GetComponentType()));
+  DimensionsType                   offset, count;
+
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+
+  // Without a record of the chunks written so far, e.g. when the dataset
+  // was created by another writer, every chunk is assumed to be allocated
+  if (this->m_SparseWrittenChunks.size() != grid.GetNumberOfChunks())
+    this->m_SparseWrittenChunks.assign(grid.GetNumberOfChunks(), true);
+
+  H5::DataSpace fileSpace(ds.getSpace());
+  H5::DataSpace memSpace(rank, count.data());
+  fileSpace.selectNone();
+  memSpace.selectNone();
+
+  const std::vector<hsize_t> chunks(grid.GetChunksIntersecting(offset, count));
+  size_t                     numSelected(0);
+  std::vector<unsigned char> chunkBuffer;
+
+  for (auto chunk : chunks)
+  {
+    DimensionsType overlapOffset, overlapCount;
+    if (!grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount))
+      continue;
+
+    DimensionsType bufferOffset(overlapOffset);
+    for (int i = 0; i < rank; i++)
+      bufferOffset[i] -= offset[i];
+
+    if (!this->m_SparseWrittenChunks[chunk])
+    {
+      // Nothing to write, the chunk stays unallocated
+      if (HDF5ContainerIsBlockUniform(buffer, count, bufferOffset, overlapCount, fillValue.data(), fillValue.size()))
+        continue;
+
+      if (!grid.IsChunkCovered(chunk, offset, count))
+      {
+        // libhdf5 pads a newly allocated chunk with zeros rather than the
+        // fill value, so a chunk this region only partly covers is written
+        // whole, with the remainder set to the fill value
+        const DimensionsType chunkOffset(grid.GetChunkOffset(chunk));
+        const DimensionsType chunkExtent(grid.GetChunkExtent(chunk));
+        DimensionsType       chunkBufferOffset(overlapOffset);
+        hsize_t              numElements(1);
+        for (int i = 0; i < rank; i++)
+        {
+          chunkBufferOffset[i] -= chunkOffset[i];
+          numElements *= chunkExtent[i];
+        }
+
+        chunkBuffer.resize(numElements * elementSize);
+        HDF5ContainerFill(chunkBuffer.data(), numElements, fillValue.data(), elementSize);
+        HDF5ContainerCopyBlock(
+          buffer, count, bufferOffset, chunkBuffer.data(), chunkExtent, chunkBufferOffset, overlapCount, elementSize);
+
+        H5::DataSpace chunkFileSpace(ds.getSpace());
+        H5::DataSpace chunkMemSpace(rank, chunkExtent.data());
+        chunkFileSpace.selectHyperslab(H5S_SELECT_SET, chunkExtent.data(), chunkOffset.data());
+        ds.write(chunkBuffer.data(), dataType, chunkMemSpace, chunkFileSpace);
+
+        this->m_SparseWrittenChunks[chunk] = true;
+        continue;
+      }
+    }
+
+    fileSpace.selectHyperslab(H5S_SELECT_OR, overlapCount.data(), overlapOffset.data());
+    memSpace.selectHyperslab(H5S_SELECT_OR, overlapCount.data(), bufferOffset.data());
+    this->m_SparseWrittenChunks[chunk] = true;
+    numSelected++;
+  }
+
+  if (numSelected == chunks.size())
+  {
+    // Nothing was skipped, write the region with a single hyperslab
+    fileSpace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+    memSpace.selectAll();
+  }
+
+  if (numSelected > 0)
+  {
+    ds.write(buffer, dataType, memSpace, fileSpace);
+  }
+}
+
+std::vector<bool>
+HDF5ContainerImageIO::GetAllocatedChunkMap()
+{
+  try
+  {
+    H5::DataSet                  ds(this->GetDataSet());
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+
+    // Chunks held in the chunk cache are only allocated when flushed
+    unsigned int intent(H5F_ACC_RDONLY);
+    H5Fget_intent(this->m_H5File->getId(), &intent);
+    if (intent & H5F_ACC_RDWR)
+      this->m_H5File->flush(H5F_SCOPE_LOCAL);
+
+    std::vector<bool> allocated(grid.GetNumberOfChunks(), false);
+    for (hsize_t chunk = 0; chunk < grid.GetNumberOfChunks(); chunk++)
+    {
+      const HDF5ContainerChunkGrid::DimensionsType offset(grid.GetChunkOffset(chunk));
+      unsigned int                                 filterMask;
+      haddr_t                                      address;
+      hsize_t                                      size;
+
+      if (H5Dget_chunk_info_by_coord(ds.getId(), offset.data(), &filterMask, &address, &size) < 0)
+        itkExceptionMacro(<< "Unable to query chunk " << chunk << " of " << this->GetDataSetName());
+      allocated[chunk] = (address != HADDR_UNDEF);
+    }
+    return allocated;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+std::vector<ImageIOBase::SizeValueType>
+HDF5ContainerImageIO::GetChunkGridSize()
+{
+  try
+  {
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(this->GetDataSet()));
+    const unsigned int           numDims(this->GetNumberOfDimensions());
+
+    // The component dimension of vector images is last in HDF5 order
+    // and always holds a single chunk
+    std::vector<SizeValueType> gridSize(numDims);
+    for (unsigned int i = 0; i < numDims; i++)
+      gridSize[i] = grid.GetGridDimensions()[numDims - i - 1];
+    return gridSize;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+void
+HDF5ContainerImageIO::AccumulateChunkStatistics(const void * buffer, const H5::DataSet & ds)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  DimensionsType               offset, count;
+
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+
+  if (this->m_ChunkStatistics.size() != grid.GetNumberOfChunks())
+    this->m_ChunkStatistics.assign(grid.GetNumberOfChunks(), ChunkStatisticsType());
+
+  HDF5ContainerDispatchComponentType(this->GetComponentType(), [&](auto * tag) {
+    using ComponentType = std::remove_pointer_t<decltype(tag)>;
+    const auto * data = static_cast<const ComponentType *>(buffer);
+    const auto   background(static_cast<ComponentType>(this->GetFillValue()));
+
+    for (auto chunk : grid.GetChunksIntersecting(offset, count))
+    {
+      DimensionsType overlapOffset, overlapCount;
+      if (!grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount))
+        continue;
+
+      for (size_t i = 0; i < overlapOffset.size(); i++)
+        overlapOffset[i] -= offset[i];
+      HDF5ContainerAccumulateBlockStatistics(
+        data, count, overlapOffset, overlapCount, background, this->m_ChunkStatistics[chunk]);
+    }
+  });
+
+  this->m_ChunkStatisticsModified = true;
+}
+
+void
+HDF5ContainerImageIO::WriteChunkStatistics()
+{
+  try
+  {
+    std::vector<double> values;
+    values.reserve(this->m_ChunkStatistics.size() * ChunkStatisticsFields);
+    for (const auto & stats : this->m_ChunkStatistics)
+    {
+      values.push_back(stats.Minimum);
+      values.push_back(stats.Maximum);
+      values.push_back(stats.Sum);
+      values.push_back(static_cast<double>(stats.Count));
+      values.push_back(static_cast<double>(stats.ForegroundCount));
+    }
+
+    const std::string path(this->GetDataSetPath() + ChunkStatisticsSuffix);
+    if (this->GetPathExists(path))
+    {
+      H5::DataSet statsSet(this->m_H5File->openDataSet(path));
+      if (statsSet.getSpace().getSimpleExtentNpoints() == static_cast<hssize_t>(values.size()))
+      {
+        statsSet.write(values.data(), H5::PredType::NATIVE_DOUBLE);
+        this->m_ChunkStatisticsModified = false;
+        return;
+      }
+      statsSet.close();
+      this->m_H5File->unlink(path);
+    }
+    this->WriteVector(path, values);
+    this->m_ChunkStatisticsModified = false;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+ImageIORegion
+HDF5ContainerImageIO::GetChunkRegion(SizeValueType chunk)
+{
+  try
+  {
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(this->GetDataSet()));
+    if (chunk >= grid.GetNumberOfChunks())
+      itkExceptionMacro(<< "Chunk " << chunk << " is outside the " << grid.GetNumberOfChunks() << " chunks of "
+                        << this->GetDataSetName());
+
+    return HDF5ContainerHyperslabToRegion(
+      grid.GetChunkOffset(chunk), grid.GetChunkExtent(chunk), this->GetNumberOfDimensions());
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+std::recursive_mutex &
+HDF5ContainerImageIO::GetLibraryMutex()
+{
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+void
+HDF5ContainerImageIO::ReadChunk(SizeValueType chunk, void * buffer)
+{
+  this->ReadChunk(chunk, buffer, true);
+}
+
+void
+HDF5ContainerImageIO::ReadChunk(SizeValueType chunk, void * buffer, bool recordAccess)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+  using ChunkCache = HDF5ContainerChunkCache;
+
+  HDF5ContainerChunkGrid                   grid;
+  std::unique_ptr<HDF5ContainerChunkCodec> codec;
+  std::vector<unsigned char>               stored, fillValue;
+  ChunkCache::BufferPointer                decoded, cachedStored;
+  const ChunkCache::KeyType                key{ this->m_ChunkCacheFile, this->m_ChunkCacheDataSet, chunk };
+  HDF5ContainerLocalChunkCache *           localCache(nullptr);
+  std::string                              localName;
+  uint64_t                                 version(0);
+  uint64_t                                 checksum(0);
+  unsigned int                             filterMask(0);
+  bool                                     allocated(true);
+  bool                                     cacheable(false);
+  bool                                     readFromFile(false);
+  size_t                                   elementSize;
+
+  try
+  {
+    // libhdf5 is only entered by one thread at a time
+    std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+
+    if (this->m_H5File == nullptr)
+      itkExceptionMacro(<< "ReadImageInformation() must be called before ReadChunk()");
+
+    H5::DataSet           ds(this->GetDataSet());
+    H5::DSetCreatPropList plist(ds.getCreatePlist());
+    const H5::DataType    dataType(ds.getDataType());
+    grid = GetDataSetChunkGrid(ds);
+    elementSize = dataType.getSize();
+
+    if (chunk >= grid.GetNumberOfChunks())
+      itkExceptionMacro(<< "Chunk " << chunk << " is outside the " << grid.GetNumberOfChunks() << " chunks of "
+                        << this->GetDataSetName());
+
+    fillValue.assign(elementSize, 0);
+    if (plist.isFillValueDefined() != H5D_FILL_VALUE_UNDEFINED)
+      plist.getFillValue(dataType, fillValue.data());
+
+    const DimensionsType offset(grid.GetChunkOffset(chunk));
+    const DimensionsType extent(grid.GetChunkExtent(chunk));
+
+    if (recordAccess && this->m_AccessTrace != nullptr)
+      this->m_AccessTrace->Record(HDF5ContainerHyperslabToRegion(offset, extent, this->GetNumberOfDimensions()));
+
+    codec.reset(new HDF5ContainerChunkCodec(ds));
+    if (!codec->IsSupported())
+    {
+      // libhdf5 decodes the chunk itself
+      if (plist.getFillTime() == H5D_FILL_TIME_NEVER)
+      {
+        hsize_t numElements(1);
+        for (auto e : extent)
+          numElements *= e;
+        HDF5ContainerFill(buffer, numElements, fillValue.data(), elementSize);
+      }
+
+      H5::DataSpace fileSpace(ds.getSpace());
+      H5::DataSpace memSpace(static_cast<int>(extent.size()), extent.data());
+      fileSpace.selectHyperslab(H5S_SELECT_SET, extent.data(), offset.data());
+      ds.read(buffer, dataType, memSpace, fileSpace);
+      return;
+    }
+
+    haddr_t address;
+    hsize_t size;
+    if (H5Dget_chunk_info_by_coord(ds.getId(), offset.data(), &filterMask, &address, &size) < 0)
+      itkExceptionMacro(<< "Unable to query chunk " << chunk << " of " << this->GetDataSetName());
+    allocated = (address != HADDR_UNDEF);
+    if (chunk < this->m_ChunkChecksums.size())
+      checksum = this->m_ChunkChecksums[chunk];
+
+    // The version identifies the stored chunk, along with its checksum
+    // when one is recorded. A chunk rewritten in place with the same size
+    // keeps its address, so the chunks of a file open for writing, which
+    // may be rewritten at any time, are not cached
+    const uint64_t identity[4] = {
+      static_cast<uint64_t>(address), static_cast<uint64_t>(size), filterMask, checksum
+    };
+    version = HDF5ContainerHash64(identity, sizeof(identity));
+
+    unsigned int intent(H5F_ACC_RDONLY);
+    H5Fget_intent(this->m_H5File->getId(), &intent);
+    cacheable = allocated && !(intent & H5F_ACC_RDWR);
+
+    if (cacheable && this->GetUseSharedChunkCache())
+    {
+      decoded = ChunkCache::GetInstance().FindDecoded(key, version);
+      if (decoded == nullptr)
+        cachedStored = ChunkCache::GetInstance().FindStored(key, version);
+    }
+
+    if (cacheable && decoded == nullptr && cachedStored == nullptr && !this->m_LocalChunkCacheDirectory.empty())
+    {
+      localCache = &HDF5ContainerLocalChunkCache::GetInstance(this->m_LocalChunkCacheDirectory);
+      localCache->SetCapacity(this->m_LocalChunkCacheCapacity);
+      localName = HDF5ContainerLocalChunkCache::GetEntryName(
+        this->m_ChunkCacheFile, this->m_ChunkCacheDataSet, chunk, version);
+      if (localCache->Find(localName, stored) && stored.size() == size)
+        localCache = nullptr;
+      else
+        stored.clear();
+    }
+
+    if (allocated && decoded == nullptr && cachedStored == nullptr && stored.empty())
+    {
+      stored.resize(size);
+      if (H5Dread_chunk(ds.getId(), H5P_DEFAULT, offset.data(), &filterMask, stored.data()) < 0)
+        itkExceptionMacro(<< "Unable to read chunk " << chunk << " of " << this->GetDataSetName());
+      readFromFile = true;
+    }
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  const DimensionsType extent(grid.GetChunkExtent(chunk));
+  hsize_t              numElements(1);
+  for (auto e : extent)
+    numElements *= e;
+
+  // Chunks read from the file or the local cache are verified outside the
+  // lock, those found in the shared cache are not read again
+  if (checksum != 0 &&
+      (!allocated || (!stored.empty() && GetChunkChecksum(stored) != checksum)))
+    itkExceptionMacro(<< "Chunk " << chunk << " of " << this->GetDataSetName() << " does not match its checksum");
+
+  if (!allocated)
+  {
+    HDF5ContainerFill(buffer, numElements, fillValue.data(), elementSize);
+    return;
+  }
+
+  // The local copy is written outside the lock, other threads carry on
+  // reading the file meanwhile
+  if (readFromFile && localCache != nullptr)
+    localCache->Store(localName, stored);
+
+  // Raw chunks always hold the full chunk dimensions, even at the edges
+  // of the dataset
+  if (decoded == nullptr)
+  {
+    if (cachedStored != nullptr)
+      stored = *cachedStored;
+    else if (cacheable && this->GetUseSharedChunkCache())
+      cachedStored = std::make_shared<const std::vector<unsigned char>>(stored);
+
+    auto chunkData(std::make_shared<std::vector<unsigned char>>());
+    codec->Decode(stored, filterMask, grid.GetChunkElements() * elementSize, *chunkData);
+    decoded = chunkData;
+
+    if (cacheable && this->GetUseSharedChunkCache())
+      ChunkCache::GetInstance().Insert(key, version, decoded, cachedStored);
+  }
+
+  const DimensionsType origin(extent.size(), 0);
+  HDF5ContainerCopyBlock(
+    decoded->data(), grid.GetChunkDimensions(), origin, buffer, extent, origin, extent, elementSize);
+}
+
+bool
+HDF5ContainerImageIO::ReadThroughChunkCache(void * buffer)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+
+  H5::DataSet ds(this->GetDataSet());
+  if (ds.getCreatePlist().getLayout() != H5D_CHUNKED || !HDF5ContainerChunkCodec(ds).IsSupported())
+    return false;
+
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  const size_t                 elementSize(ds.getDataType().getSize());
+  const size_t                 rank(grid.GetRank());
+  DimensionsType               offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+
+  // Each chunk is decoded, or found in the cache, then the part of it
+  // within the region is copied
+  std::vector<unsigned char> chunkBuffer;
+  for (auto chunk : grid.GetChunksIntersecting(offset, count))
+  {
+    DimensionsType overlapOffset, overlapCount;
+    grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount);
+
+    const DimensionsType chunkOffset(grid.GetChunkOffset(chunk));
+    const DimensionsType extent(grid.GetChunkExtent(chunk));
+    hsize_t              numElements(1);
+    for (auto e : extent)
+      numElements *= e;
+
+    // The region was recorded by Read()
+    chunkBuffer.resize(numElements * elementSize);
+    this->ReadChunk(chunk, chunkBuffer.data(), false);
+
+    DimensionsType chunkStart(rank), bufferStart(rank);
+    for (size_t i = 0; i < rank; i++)
+    {
+      chunkStart[i] = overlapOffset[i] - chunkOffset[i];
+      bufferStart[i] = overlapOffset[i] - offset[i];
+    }
+    HDF5ContainerCopyBlock(
+      chunkBuffer.data(), extent, chunkStart, buffer, count, bufferStart, overlapCount, elementSize);
+  }
+  return true;
+}
+
+void
+HDF5ContainerImageIO::EraseFromSharedChunkCache()
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  HDF5ContainerChunkCache & cache(HDF5ContainerChunkCache::GetInstance());
+  if (cache.IsEmpty())
+    return;
+
+  H5::DataSet ds(this->GetDataSet());
+  if (ds.getCreatePlist().getLayout() != H5D_CHUNKED)
+    return;
+
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  DimensionsType               offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+  for (auto chunk : grid.GetChunksIntersecting(offset, count))
+    cache.Erase({ this->m_ChunkCacheFile, this->m_ChunkCacheDataSet, chunk });
+}
+
+void
+HDF5ContainerImageIO::UpdateChunkCacheKey()
+{
+  // Files are identified by their path, size and modification time, so
+  // a file replaced by another of the same name does not share its chunks
+  // Containers of several files are identified by the one holding the
+  // superblock, which is rewritten whenever the container is
+  FileDriverEnum driver(FileDriverEnum::SEC2);
+  FindContainerFileDriver(this->GetFileName(), driver);
+  const std::string storageName(SuperblockFileName(this->GetFileName(), driver));
+
+  std::error_code   error;
+  const std::string path(std::filesystem::weakly_canonical(this->GetFileName(), error).string());
+  const uint64_t    identity[2] = {
+    static_cast<uint64_t>(std::filesystem::last_write_time(storageName, error).time_since_epoch().count()),
+    static_cast<uint64_t>(std::filesystem::file_size(storageName, error))
+  };
+
+  this->m_ChunkCacheFile =
+    HDF5ContainerHash64(path.data(), path.size(), HDF5ContainerHash64(identity, sizeof(identity)));
+  const std::string dataSetPath(this->GetDataSetPath());
+  this->m_ChunkCacheDataSet = HDF5ContainerHash64(dataSetPath.data(), dataSetPath.size());
+}
+
+void
+HDF5ContainerImageIO::SetSharedChunkCacheCapacity(SizeValueType decodedBytes, SizeValueType compressedBytes)
+{
+  HDF5ContainerChunkCache::GetInstance().SetCapacity(decodedBytes, compressedBytes);
+}
+
+HDF5ContainerImageIO::SharedChunkCacheStatisticsType
+HDF5ContainerImageIO::GetSharedChunkCacheStatistics()
+{
+  return HDF5ContainerChunkCache::GetInstance().GetStatistics();
+}
+
+void
+HDF5ContainerImageIO::ClearSharedChunkCache()
+{
+  HDF5ContainerChunkCache::GetInstance().Clear();
+}
+
+void
+HDF5ContainerImageIO::ReadRegion(const ImageIORegion & region, void * buffer)
+{
+  std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+  this->SetIORegion(region);
+  this->Read(buffer);
+}
+
+void
+HDF5ContainerImageIO::WriteChunk(SizeValueType chunk, const void * buffer)
+{
+  std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+  this->SetIORegion(this->GetChunkRegion(chunk));
+  this->Write(buffer);
+}
+
+void
+HDF5ContainerImageIO::OpenDataSetForUpdate()
+{
+  try
+  {
+    H5::DataSet ds(this->GetDataSet());
+
+    // The component type, number of components and dimensions set must
+    // match the dataset, its geometry and metadata are left as they are
+    const H5::DataType dataType(ds.getDataType());
+    if (!(dataType == ComponentToPredType(this->GetComponentType())))
+      itkExceptionMacro(<< "Unable to update " << this->GetDataSetName() << ", its component type differs from "
+                        << ImageIOBase::GetComponentTypeAsString(this->GetComponentType()));
+
+    const unsigned int numComponents(this->GetNumberOfComponents());
+    const unsigned int numDims(this->GetNumberOfDimensions());
+    H5::DataSpace      space(ds.getSpace());
+    const int          rank(space.getSimpleExtentNdims());
+    if (rank != static_cast<int>(numDims + (numComponents > 1 ? 1 : 0)))
+      itkExceptionMacro(<< "Unable to update " << this->GetDataSetName() << ", it has " << rank
+                        << " dimensions, including components");
+
+    std::vector<hsize_t> dims(rank);
+    space.getSimpleExtentDims(dims.data());
+    for (unsigned int i = 0; i < numDims; i++)
+    {
+      if (dims[numDims - i - 1] != this->GetDimensions(i))
+        itkExceptionMacro(<< "Unable to update " << this->GetDataSetName() << ", its dimension " << i << " is "
+                          << dims[numDims - i - 1] << " rather than " << this->GetDimensions(i));
+    }
+    if (numComponents > 1 && dims[numDims] != numComponents)
+      itkExceptionMacro(<< "Unable to update " << this->GetDataSetName() << ", it has " << dims[numDims]
+                        << " components rather than " << numComponents);
+
+    // Compressing with the filter needs the dictionary the dataset uses
+    this->LoadZstdDictionary(ds);
+    this->RemoveDerivedData(ds);
+    this->LoadChunkHashes(ds, false);
+    this->LoadChunkChecksums(ds, false);
+    this->UpdateChunkCacheKey();
+    this->m_Updating = true;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+namespace
+{
+// Suffixes of the datasets computed from the content of a dataset, which
+// rewriting part of it leaves stale
+std::vector<std::string>
+GetDerivedDataSetSuffixes(unsigned int numDims)
+{
+  std::vector<std::string> suffixes{ ChunkStatisticsSuffix, ThumbnailSuffix };
+  for (unsigned int axis = 0; axis < numDims; axis++)
+  {
+    suffixes.push_back(MaximumProjectionSuffix + std::to_string(axis));
+    suffixes.push_back(MeanProjectionSuffix + std::to_string(axis));
+    suffixes.push_back(MaximumProjectionThumbnailSuffix + std::to_string(axis));
+  }
+  return suffixes;
+}
+} // namespace
+
+void
+HDF5ContainerImageIO::RemoveDerivedData(H5::DataSet & ds)
+{
+  // Statistics and fingerprints cached by ComputeStatistics() and
+  // ComputeFingerprint() are only checked against the storage
+  // fingerprint, which in place rewrites may leave unchanged
+  for (auto name : { StatisticsMinimum,
+                     StatisticsMaximum,
+                     StatisticsMean,
+                     StatisticsStandardDeviation,
+                     StatisticsHistogram,
+                     StatisticsHistogramRange,
+                     StatisticsForegroundCount,
+                     StatisticsFingerprint,
+                     ContentFingerprint })
+  {
+    if (ds.attrExists(name))
+      ds.removeAttr(name);
+  }
+
+  // The chunk statistics, projections and thumbnails are only computed
+  // while the whole dataset is written
+  const unsigned int numDims(static_cast<unsigned int>(ds.getSpace().getSimpleExtentNdims()));
+  for (const auto & suffix : GetDerivedDataSetSuffixes(numDims))
+  {
+    const std::string path(this->GetDataSetPath() + suffix);
+    if (this->GetPathExists(path))
+      this->m_H5File->unlink(path);
+  }
+  this->m_ChunkStatistics.clear();
+}
+
+namespace
+{
+double
+GetCheckpointClock()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+void
+HDF5ContainerImageIO::LoadCheckpoint(const H5::DataSet & ds)
+{
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  const hsize_t                numChunks(grid.GetNumberOfChunks());
+
+  // One bit per chunk, set once all of its elements were written
+  std::vector<unsigned char> completed;
+  if (ds.attrExists(CheckpointCompletedChunks))
+    completed = this->ReadVectorAttrib<unsigned char>(ds, CheckpointCompletedChunks);
+  if (!completed.empty() && completed.size() != (numChunks + 7) / 8)
+    itkExceptionMacro(<< "The checkpoint of " << this->GetDataSetName() << " does not match its chunks");
+
+  this->m_CheckpointElementsWritten.assign(numChunks, 0);
+  this->m_NumberOfChunksCompleted = 0;
+  for (hsize_t chunk = 0; chunk < numChunks && !completed.empty(); chunk++)
+  {
+    if (completed[chunk / 8] & (1u << (chunk % 8)))
+    {
+      hsize_t numElements(1);
+      for (auto e : grid.GetChunkExtent(chunk))
+        numElements *= e;
+      this->m_CheckpointElementsWritten[chunk] = numElements;
+      this->m_NumberOfChunksCompleted++;
+    }
+  }
+  this->m_CheckpointModified = false;
+  this->m_LastCheckpointTime = GetCheckpointClock();
+}
+
+void
+HDF5ContainerImageIO::AccumulateCheckpoint(const H5::DataSet & ds)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  if (this->m_CheckpointElementsWritten.size() != grid.GetNumberOfChunks())
+    this->LoadCheckpoint(ds);
+
+  DimensionsType offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+  for (auto chunk : grid.GetChunksIntersecting(offset, count))
+  {
+    DimensionsType overlapOffset, overlapCount;
+    grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount);
+
+    hsize_t numElements(1), numOverlap(1);
+    for (size_t i = 0; i < overlapCount.size(); i++)
+    {
+      numElements *= grid.GetChunkExtent(chunk)[i];
+      numOverlap *= overlapCount[i];
+    }
+
+    SizeValueType & written(this->m_CheckpointElementsWritten[chunk]);
+    if (written < numElements && written + numOverlap >= numElements)
+      this->m_NumberOfChunksCompleted++;
+    written = std::min<SizeValueType>(written + numOverlap, numElements);
+  }
+  this->m_CheckpointModified = true;
+
+  if (this->m_NumberOfChunksCompleted == grid.GetNumberOfChunks() ||
+      GetCheckpointClock() - this->m_LastCheckpointTime >= this->GetCheckpointInterval())
+    this->WriteCheckpoint();
+}
+
+void
+HDF5ContainerImageIO::WriteCheckpoint()
+{
+  try
+  {
+    H5::DataSet                  ds(this->GetDataSet());
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+
+    // The pixels are flushed before the checkpoint claims them, a crash
+    // in between leaves the previous checkpoint, which is still valid
+    H5Fflush(this->m_H5File->getId(), H5F_SCOPE_GLOBAL);
+
+    const hsize_t              numChunks(grid.GetNumberOfChunks());
+    std::vector<unsigned char> completed((numChunks + 7) / 8, 0);
+    hsize_t                    numCompleted(0);
+    for (hsize_t chunk = 0; chunk < numChunks && chunk < this->m_CheckpointElementsWritten.size(); chunk++)
+    {
+      hsize_t numElements(1);
+      for (auto e : grid.GetChunkExtent(chunk))
+        numElements *= e;
+      if (this->m_CheckpointElementsWritten[chunk] >= numElements)
+      {
+        completed[chunk / 8] |= static_cast<unsigned char>(1u << (chunk % 8));
+        numCompleted++;
+      }
+    }
+
+    // Once every chunk is complete there is nothing left to resume, and
+    // the next write of the dataset starts afresh
+    if (numCompleted == numChunks)
+    {
+      if (ds.attrExists(CheckpointCompletedChunks))
+        ds.removeAttr(CheckpointCompletedChunks);
+    }
+    else if (ds.attrExists(CheckpointCompletedChunks))
+    {
+      H5::Attribute attribute(ds.openAttribute(CheckpointCompletedChunks));
+      if (attribute.getSpace().getSimpleExtentNpoints() == static_cast<hssize_t>(completed.size()))
+      {
+        attribute.write(H5::PredType::NATIVE_UCHAR, completed.data());
+      }
+      else
+      {
+        attribute.close();
+        ds.removeAttr(CheckpointCompletedChunks);
+        this->WriteVectorAttrib(ds, CheckpointCompletedChunks, completed);
+      }
+    }
+    else
+    {
+      this->WriteVectorAttrib(ds, CheckpointCompletedChunks, completed);
+    }
+    H5Fflush(this->m_H5File->getId(), H5F_SCOPE_GLOBAL);
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  this->m_CheckpointModified = false;
+  this->m_LastCheckpointTime = GetCheckpointClock();
+}
+
+bool
+HDF5ContainerImageIO::ReadCheckpoint()
+{
+  FileDriverEnum driver(this->GetFileDriver());
+  if (!FindContainerFileDriver(this->GetFileName(), driver))
+    return false;
+
+  try
+  {
+    this->CloseH5File();
+    this->OpenH5File(H5F_ACC_RDONLY);
+    this->m_CheckpointElementsWritten.clear();
+
+    if (!this->GetPathExists(this->GetDataSetPath()))
+      return false;
+    H5::DataSet ds(this->GetDataSet());
+    if (!ds.attrExists(CheckpointCompletedChunks))
+      return false;
+    this->LoadCheckpoint(ds);
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  return true;
+}
+
+bool
+HDF5ContainerImageIO::IsRegionCompleted(const ImageIORegion & region)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->m_H5File == nullptr || this->m_CheckpointElementsWritten.empty())
+    return false;
+
+  try
+  {
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(this->GetDataSet()));
+    if (this->m_CheckpointElementsWritten.size() != grid.GetNumberOfChunks())
+      return false;
+
+    // The components are taken from the dataset, as the checkpoint may be
+    // read before the image information is set
+    const unsigned int numComponents(
+      grid.GetRank() > region.GetImageDimension() ? static_cast<unsigned int>(grid.GetDataSetDimensions().back()) : 1);
+    DimensionsType offset, count;
+    HDF5ContainerRegionToHyperslab(region, numComponents, offset, count);
+    if (offset.size() != grid.GetRank())
+      return false;
+    for (auto chunk : grid.GetChunksIntersecting(offset, count))
+    {
+      hsize_t numElements(1);
+      for (auto e : grid.GetChunkExtent(chunk))
+        numElements *= e;
+      if (this->m_CheckpointElementsWritten[chunk] < numElements)
+        return false;
+    }
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  return true;
+}
+
+namespace
+{
+// Hash of every chunk a hyperslab of a row-major buffer covers whole, and
+// zero for the chunks it covers partly. A chunk is gathered before being
+// hashed, so its hash does not depend on the regions it was written with.
+std::vector<std::pair<hsize_t, uint64_t>>
+HashRegionChunks(const void *                                  buffer,
+                 const HDF5ContainerChunkGrid &                grid,
+                 const HDF5ContainerChunkGrid::DimensionsType & offset,
+                 const HDF5ContainerChunkGrid::DimensionsType & count,
+                 size_t                                        elementSize)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  std::vector<std::pair<hsize_t, uint64_t>> hashes;
+  std::vector<unsigned char>                block;
+  for (auto chunk : grid.GetChunksIntersecting(offset, count))
+  {
+    DimensionsType overlapOffset, overlapCount;
+    grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount);
+    if (overlapCount != grid.GetChunkExtent(chunk))
+    {
+      hashes.emplace_back(chunk, 0);
+      continue;
+    }
+
+    hsize_t numElements(1);
+    for (size_t i = 0; i < overlapOffset.size(); i++)
+    {
+      overlapOffset[i] -= offset[i];
+      numElements *= overlapCount[i];
+    }
+    block.resize(numElements * elementSize);
+    HDF5ContainerCopyBlock(buffer,
+                           count,
+                           overlapOffset,
+                           block.data(),
+                           overlapCount,
+                           DimensionsType(overlapCount.size(), 0),
+                           overlapCount,
+                           elementSize);
+
+    // Zero is kept for chunks without a hash
+    const uint64_t hash(HDF5ContainerHash64(block.data(), block.size()));
+    hashes.emplace_back(chunk, hash == 0 ? 1 : hash);
+  }
+  return hashes;
+}
+} // namespace
+
+void
+HDF5ContainerImageIO::LoadChunkHashes(const H5::DataSet & ds, bool created)
+{
+  this->m_ChunkHashes.clear();
+  this->m_ChunkHashesModified = false;
+  this->m_NumberOfChunksSkipped = 0;
+
+  // The hashes are removed while the dataset is written and stored again
+  // when it is closed, a writer that is interrupted leaves none to match
+  // chunks it may have changed
+  const std::string     path(this->GetDataSetPath() + ChunkHashesSuffix);
+  std::vector<uint64_t> hashes;
+  if (this->GetPathExists(path))
+  {
+    if (!created)
+      hashes = this->ReadVector<uint64_t>(path);
+    this->m_H5File->unlink(path);
+  }
+
+  // Regions only address chunks directly without dataset offset, size
+  // and stride
+  if (!this->GetUseChunkHashes() || this->GetUseDataSetOffset() || this->GetUseDataSetSize() ||
+      this->GetUseDataSetStride() || ds.getCreatePlist().getLayout() != H5D_CHUNKED)
+    return;
+
+  const hsize_t numChunks(GetDataSetChunkGrid(ds).GetNumberOfChunks());
+  if (hashes.size() != numChunks)
+    hashes.assign(numChunks, 0);
+  this->m_ChunkHashes = hashes;
+  this->m_ChunkHashesModified = true;
+}
+
+void
+HDF5ContainerImageIO::AccumulateChunkHashes(const void * buffer, const H5::DataSet & ds)
+{
+  HDF5ContainerChunkGrid::DimensionsType offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+
+  for (const auto & chunkHash :
+       HashRegionChunks(buffer, GetDataSetChunkGrid(ds), offset, count, this->GetComponentSize()))
+  {
+    this->m_ChunkHashes[chunkHash.first] = chunkHash.second;
+  }
+  this->m_ChunkHashesModified = true;
+}
+
+void
+HDF5ContainerImageIO::WriteChangedChunks(const void * buffer, H5::DataSet & ds)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+  DimensionsType               offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+
+  const std::vector<std::pair<hsize_t, uint64_t>> hashes(
+    HashRegionChunks(buffer, grid, offset, count, this->GetComponentSize()));
+
+  // The parts of the changed chunks are selected both in the region and
+  // in the dataset, and written at once
+  H5::DataSpace memSpace(static_cast<int>(count.size()), count.data());
+  H5::DataSpace fileSpace(ds.getSpace());
+  memSpace.selectNone();
+  fileSpace.selectNone();
+
+  SizeValueType numChanged(0);
+  for (const auto & chunkHash : hashes)
+  {
+    if (chunkHash.second != 0 && chunkHash.second == this->m_ChunkHashes[chunkHash.first])
+    {
+      this->m_NumberOfChunksSkipped++;
+      continue;
+    }
+
+    DimensionsType overlapOffset, overlapCount;
+    grid.GetIntersection(chunkHash.first, offset, count, overlapOffset, overlapCount);
+    fileSpace.selectHyperslab(H5S_SELECT_OR, overlapCount.data(), overlapOffset.data());
+    for (size_t i = 0; i < overlapOffset.size(); i++)
+      overlapOffset[i] -= offset[i];
+    memSpace.selectHyperslab(H5S_SELECT_OR, overlapCount.data(), overlapOffset.data());
+    numChanged++;
+  }
+
+  if (numChanged > 0)
+    ds.write(buffer, ComponentToPredType(this->GetComponentType()), memSpace, fileSpace);
+
+  for (const auto & chunkHash : hashes)
+    this->m_ChunkHashes[chunkHash.first] = chunkHash.second;
+  this->m_ChunkHashesModified = true;
+}
+
+void
+HDF5ContainerImageIO::WriteChunkHashes()
+{
+  try
+  {
+    const std::string path(this->GetDataSetPath() + ChunkHashesSuffix);
+    if (this->GetPathExists(path))
+      this->m_H5File->unlink(path);
+    this->WriteVector(path, this->m_ChunkHashes);
+    this->m_ChunkHashesModified = false;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+void
+HDF5ContainerImageIO::LoadChunkChecksums(const H5::DataSet & ds, bool created)
+{
+  this->m_ChunkChecksums.clear();
+  this->m_DirtyChunkChecksums.clear();
+  this->m_ChunkChecksumsModified = false;
+
+  // As the hashes, the checksums are removed while the dataset is written
+  const std::string     path(this->GetDataSetPath() + ChunkChecksumsSuffix);
+  std::vector<uint64_t> checksums;
+  if (this->GetPathExists(path))
+  {
+    if (!created)
+      checksums = this->ReadVector<uint64_t>(path);
+    this->m_H5File->unlink(path);
+  }
+
+  if (!this->GetUseChunkChecksums() || ds.getCreatePlist().getLayout() != H5D_CHUNKED)
+    return;
+
+  const hsize_t numChunks(GetDataSetChunkGrid(ds).GetNumberOfChunks());
+  if (checksums.size() != numChunks)
+    checksums.assign(numChunks, 0);
+  this->m_ChunkChecksums = checksums;
+  this->m_DirtyChunkChecksums.assign(numChunks, false);
+  this->m_ChunkChecksumsModified = true;
+}
+
+void
+HDF5ContainerImageIO::MarkChunkChecksumsDirty(const H5::DataSet & ds)
+{
+  this->m_ChunkChecksumsModified = true;
+
+  // With a dataset offset, size or stride the chunks written are not
+  // those of the region, all are checksummed again
+  if (this->GetUseDataSetOffset() || this->GetUseDataSetSize() || this->GetUseDataSetStride())
+  {
+    std::fill(this->m_DirtyChunkChecksums.begin(), this->m_DirtyChunkChecksums.end(), true);
+    return;
+  }
+
+  HDF5ContainerChunkGrid::DimensionsType offset, count;
+  HDF5ContainerRegionToHyperslab(this->GetIORegion(), this->GetNumberOfComponents(), offset, count);
+  for (auto chunk : GetDataSetChunkGrid(ds).GetChunksIntersecting(offset, count))
+    this->m_DirtyChunkChecksums[chunk] = true;
+}
+
+void
+HDF5ContainerImageIO::WriteChunkChecksums()
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  try
+  {
+    H5::DataSet                  ds(this->GetDataSet());
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+    const hid_t                  dsId(ds.getId());
+
+    std::vector<SizeValueType> dirty;
+    for (SizeValueType chunk = 0; chunk < this->m_DirtyChunkChecksums.size(); chunk++)
+    {
+      if (this->m_DirtyChunkChecksums[chunk])
+        dirty.push_back(chunk);
+    }
+
+    // Chunks still held by the chunk cache of libhdf5 are not allocated
+    // yet
+    H5Fflush(this->m_H5File->getId(), H5F_SCOPE_LOCAL);
+
+    // The chunks written are read back stored, one at a time, and hashed
+    // by a pool of threads
+    MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+    threader->ParallelizeArray(
+      0,
+      dirty.size(),
+      [&](SizeValueType i) {
+        const SizeValueType        chunk(dirty[i]);
+        const DimensionsType       offset(grid.GetChunkOffset(chunk));
+        std::vector<unsigned char> stored;
+        {
+          std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+          unsigned int                          filterMask(0);
+          haddr_t                               address;
+          hsize_t                               size;
+          if (H5Dget_chunk_info_by_coord(dsId, offset.data(), &filterMask, &address, &size) < 0)
+            itkGenericExceptionMacro(<< "Unable to query chunk " << chunk);
+          if (address != HADDR_UNDEF)
+          {
+            stored.resize(size);
+            if (H5Dread_chunk(dsId, H5P_DEFAULT, offset.data(), &filterMask, stored.data()) < 0)
+              itkGenericExceptionMacro(<< "Unable to read chunk " << chunk);
+          }
+        }
+
+        // Chunks never allocated, e.g. those of sparse datasets holding
+        // the fill value only, have no checksum
+        this->m_ChunkChecksums[chunk] = stored.empty() ? 0 : GetChunkChecksum(stored);
+      },
+      nullptr);
+    std::fill(this->m_DirtyChunkChecksums.begin(), this->m_DirtyChunkChecksums.end(), false);
+
+    const std::string path(this->GetDataSetPath() + ChunkChecksumsSuffix);
+    if (this->GetPathExists(path))
+      this->m_H5File->unlink(path);
+    this->WriteVector(path, this->m_ChunkChecksums);
+    this->m_ChunkChecksumsModified = false;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+std::vector<ImageIORegion>
+HDF5ContainerImageIO::VerifyDataSet()
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before VerifyDataSet()");
+
+  std::vector<SizeValueType> corrupt;
+  try
+  {
+    H5::DataSet       ds(this->GetDataSet());
+    const std::string path(this->GetDataSetPath() + ChunkChecksumsSuffix);
+    if (!this->GetPathExists(path))
+      itkExceptionMacro(<< "No chunk checksums stored for " << this->GetDataSetPath());
+
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+    const std::vector<uint64_t>  checksums(this->ReadVector<uint64_t>(path));
+    if (checksums.size() != grid.GetNumberOfChunks())
+      itkExceptionMacro(<< "The chunk checksums of " << this->GetDataSetPath() << " do not match its chunks");
+
+    const hid_t                dsId(ds.getId());
+    std::mutex                 corruptMutex;
+    MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+    threader->ParallelizeArray(
+      0,
+      grid.GetNumberOfChunks(),
+      [&](SizeValueType chunk) {
+        if (checksums[chunk] == 0)
+          return;
+
+        const DimensionsType       offset(grid.GetChunkOffset(chunk));
+        std::vector<unsigned char> stored;
+        bool                       allocated;
+        {
+          // libhdf5 is only entered by one thread at a time
+          std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+          unsigned int                          filterMask(0);
+          haddr_t                               address;
+          hsize_t                               size;
+          if (H5Dget_chunk_info_by_coord(dsId, offset.data(), &filterMask, &address, &size) < 0)
+            itkGenericExceptionMacro(<< "Unable to query chunk " << chunk);
+          allocated = (address != HADDR_UNDEF);
+          if (allocated)
+          {
+            stored.resize(size);
+            if (H5Dread_chunk(dsId, H5P_DEFAULT, offset.data(), &filterMask, stored.data()) < 0)
+              itkGenericExceptionMacro(<< "Unable to read chunk " << chunk);
+          }
+        }
+
+        if (!allocated || GetChunkChecksum(stored) != checksums[chunk])
+        {
+          std::lock_guard<std::mutex> lock(corruptMutex);
+          corrupt.push_back(chunk);
+        }
+      },
+      nullptr);
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  std::sort(corrupt.begin(), corrupt.end());
+  std::vector<ImageIORegion> regions;
+  for (auto chunk : corrupt)
+    regions.push_back(this->GetChunkRegion(chunk));
+  return regions;
+}
+
+bool
+HDF5ContainerImageIO::EncodeChunk(const void * chunk, SizeValueType chunkBytes, std::vector<unsigned char> & stored)
+{
+  // The codec is created once per dataset, producers then only take the
+  // lock of the file if it is missing
+  std::shared_ptr<const HDF5ContainerChunkCodec> codec(std::atomic_load(&this->m_ChunkEncoder));
+  if (codec == nullptr)
+  {
+    try
+    {
+      std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+
+      H5::DataSet ds(this->GetDataSet());
+      if (ds.getCreatePlist().getLayout() != H5D_CHUNKED)
+        itkExceptionMacro(<< this->GetDataSetName() << " is not chunked");
+      codec = std::make_shared<const HDF5ContainerChunkCodec>(ds);
+      std::atomic_store(&this->m_ChunkEncoder, codec);
+    }
+    catch (H5::Exception & error)
+    {
+      itkExceptionMacro(<< error.getCDetailMsg());
+    }
+  }
+
+  if (!codec->IsEncodeSupported())
+    return false;
+  codec->Encode(chunk, chunkBytes, stored);
+  return true;
+}
+
+void
+HDF5ContainerImageIO::WriteRawChunk(SizeValueType chunk, const std::vector<unsigned char> & stored)
+{
+  std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+  try
+  {
+    H5::DataSet                  ds(this->GetDataSet());
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+    if (chunk >= grid.GetNumberOfChunks())
+      itkExceptionMacro(<< "Chunk " << chunk << " is outside the " << grid.GetNumberOfChunks() << " chunks of "
+                        << this->GetDataSetName());
+
+    if (H5Dwrite_chunk(ds.getId(), H5P_DEFAULT, 0, grid.GetChunkOffset(chunk).data(), stored.size(), stored.data()) <
+        0)
+      itkExceptionMacro(<< "Unable to write chunk " << chunk << " of " << this->GetDataSetName());
+    if (this->m_Updating)
+      this->RemoveDerivedData(ds);
+
+    // The content of a chunk written encoded is not hashed
+    if (!this->m_ChunkHashes.empty())
+    {
+      this->m_ChunkHashes[chunk] = 0;
+      this->m_ChunkHashesModified = true;
+    }
+    if (!this->m_ChunkChecksums.empty())
+    {
+      this->m_ChunkChecksums[chunk] = GetChunkChecksum(stored);
+      this->m_DirtyChunkChecksums[chunk] = false;
+      this->m_ChunkChecksumsModified = true;
+    }
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  HDF5ContainerChunkCache & cache(HDF5ContainerChunkCache::GetInstance());
+  if (!cache.IsEmpty())
+    cache.Erase({ this->m_ChunkCacheFile, this->m_ChunkCacheDataSet, chunk });
+}
+
+void
+HDF5ContainerImageIO::OpenForUpdate()
+{
+  if (this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before OpenForUpdate()");
+
+  try
+  {
+    unsigned int intent(H5F_ACC_RDONLY);
+    H5Fget_intent(this->m_H5File->getId(), &intent);
+    if (!(intent & H5F_ACC_RDWR))
+    {
+      this->m_H5File->close();
+      this->OpenH5File(H5F_ACC_RDWR);
+    }
+
+    H5::DataSet ds(this->GetDataSet());
+    this->RemoveDerivedData(ds);
+    this->LoadChunkHashes(ds, false);
+    this->LoadChunkChecksums(ds, false);
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  // The existing dataset is written as is
+  this->m_ImageInformationWritten = true;
+  this->m_Updating = true;
+}
+
+std::vector<HDF5ContainerImageIO::ChunkStatisticsType>
+HDF5ContainerImageIO::GetChunkStatistics()
+{
+  if (!this->m_ChunkStatistics.empty())
+    return this->m_ChunkStatistics;
+
+  try
+  {
+    const std::string path(this->GetDataSetPath() + ChunkStatisticsSuffix);
+    if (!this->GetPathExists(path))
+      itkExceptionMacro(<< "No chunk statistics stored for " << this->GetDataSetPath());
+
+    const std::vector<double>        values(this->ReadVector<double>(path));
+    std::vector<ChunkStatisticsType> chunkStatistics(values.size() / ChunkStatisticsFields);
+    for (size_t i = 0; i < chunkStatistics.size(); i++)
+    {
+      const double * v(values.data() + i * ChunkStatisticsFields);
+      chunkStatistics[i].Minimum = v[0];
+      chunkStatistics[i].Maximum = v[1];
+      chunkStatistics[i].Sum = v[2];
+      chunkStatistics[i].Count = static_cast<SizeValueType>(v[3]);
+      chunkStatistics[i].ForegroundCount = static_cast<SizeValueType>(v[4]);
+    }
+
+    this->m_ChunkStatistics = chunkStatistics;
+    return chunkStatistics;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+HDF5ContainerImageIO::ChunkStatisticsType
+HDF5ContainerImageIO::GetStatistics()
+{
+  ChunkStatisticsType statistics;
+  for (const auto & stats : this->GetChunkStatistics())
+    HDF5ContainerMergeStatistics(stats, statistics);
+  return statistics;
+}
+
+std::vector<ImageIOBase::SizeValueType>
+HDF5ContainerImageIO::GetChunksInIntensityRange(double lower, double upper)
+{
+  const std::vector<ChunkStatisticsType> chunkStatistics(this->GetChunkStatistics());
+  std::vector<SizeValueType>             chunks;
+
+  for (SizeValueType chunk = 0; chunk < chunkStatistics.size(); chunk++)
+  {
+    const ChunkStatisticsType & stats(chunkStatistics[chunk]);
+    if (stats.Count > 0 && stats.Maximum >= lower && stats.Minimum <= upper)
+      chunks.push_back(chunk);
+  }
+  return chunks;
+}
+
+ImageIORegion
+HDF5ContainerImageIO::GetForegroundRegion()
+{
+  const std::vector<ChunkStatisticsType> chunkStatistics(this->GetChunkStatistics());
+
+  try
+  {
+    const HDF5ContainerChunkGrid           grid(GetDataSetChunkGrid(this->GetDataSet()));
+    const size_t                           rank(grid.GetRank());
+    HDF5ContainerChunkGrid::DimensionsType lower(grid.GetDataSetDimensions()), upper(rank, 0);
+    bool                                   found(false);
+
+    for (hsize_t chunk = 0; chunk < chunkStatistics.size() && chunk < grid.GetNumberOfChunks(); chunk++)
+    {
+      if (chunkStatistics[chunk].ForegroundCount == 0)
+        continue;
+
+      const HDF5ContainerChunkGrid::DimensionsType offset(grid.GetChunkOffset(chunk));
+      const HDF5ContainerChunkGrid::DimensionsType extent(grid.GetChunkExtent(chunk));
+      for (size_t i = 0; i < rank; i++)
+      {
+        lower[i] = std::min(lower[i], offset[i]);
+        upper[i] = std::max(upper[i], offset[i] + extent[i]);
+      }
+      found = true;
+    }
+
+    if (!found)
+      lower.assign(rank, 0);
+    for (size_t i = 0; i < rank; i++)
+      upper[i] -= lower[i];
+
+    return HDF5ContainerHyperslabToRegion(lower, upper, this->GetNumberOfDimensions());
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+void
+HDF5ContainerImageIO::AccumulateImageStatistics(const void * buffer)
+{
+  if (this->m_Histogram == nullptr)
+    this->m_Histogram.reset(new HDF5ContainerHistogram(this->GetNumberOfHistogramBins()));
+
+  const size_t numComponents(this->GetIORegion().GetNumberOfPixels() * this->GetNumberOfComponents());
+
+  HDF5ContainerDispatchComponentType(this->GetComponentType(), [&](auto * tag) {
+    using ComponentType = std::remove_pointer_t<decltype(tag)>;
+    const auto * data = static_cast<const ComponentType *>(buffer);
+
+    // The vectorized pass gives the range and mean of the region, the
+    // histogram pass also sums the squared deviations from that mean
+    ChunkStatisticsType region;
+    HDF5ContainerAccumulateStatistics(
+      data, numComponents, static_cast<ComponentType>(this->GetFillValue()), region);
+    if (region.Count == 0)
+      return;
+
+    this->m_Histogram->Cover(region.Minimum, region.Maximum, std::is_integral<ComponentType>::value);
+    const double squaredDeviations(this->m_Histogram->Add(data, numComponents, region.GetMean()));
+
+    HDF5ContainerMergeStatistics(
+      region, squaredDeviations, this->m_ImageStatistics, this->m_ImageSquaredDeviations);
+  });
+}
+
+void
+HDF5ContainerImageIO::WriteImageStatistics(H5::DataSet & ds)
+{
+  const ChunkStatisticsType & stats(this->m_ImageStatistics);
+  if (stats.Count == 0 || this->m_Histogram == nullptr)
+    return;
+
+  const double standardDeviation(std::sqrt(this->m_ImageSquaredDeviations / static_cast<double>(stats.Count)));
+
+  try
+  {
+    // Attributes of a rewritten dataset are replaced
+    for (auto name : { StatisticsMinimum,
+                       StatisticsMaximum,
+                       StatisticsMean,
+                       StatisticsStandardDeviation,
+                       StatisticsHistogram,
+                       StatisticsHistogramRange })
+    {
+      if (ds.attrExists(name))
+        ds.removeAttr(name);
+    }
+
+    this->WriteVectorAttrib(ds, StatisticsMinimum, std::vector<double>(1, stats.Minimum));
+    this->WriteVectorAttrib(ds, StatisticsMaximum, std::vector<double>(1, stats.Maximum));
+    this->WriteVectorAttrib(ds, StatisticsMean, std::vector<double>(1, stats.GetMean()));
+    this->WriteVectorAttrib(ds, StatisticsStandardDeviation, std::vector<double>(1, standardDeviation));
+    this->WriteVectorAttrib(ds, StatisticsHistogram, this->m_Histogram->GetBins());
+    this->WriteVectorAttrib(ds,
+                            StatisticsHistogramRange,
+                            std::vector<double>{ this->m_Histogram->GetMinimum(), this->m_Histogram->GetMaximum() });
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+void
+HDF5ContainerImageIO::ReadImageStatistics(const H5::DataSet & ds, MetaDataDictionary & metaDict)
+{
+  for (auto name : { StatisticsMinimum, StatisticsMaximum, StatisticsMean, StatisticsStandardDeviation })
+  {
+    if (ds.attrExists(name))
+      EncapsulateMetaData<double>(metaDict, name, this->ReadVectorAttrib<double>(ds, name).at(0));
+  }
+
+  if (ds.attrExists(StatisticsHistogram))
+    EncapsulateMetaData<std::vector<unsigned long long>>(
+      metaDict, StatisticsHistogram, this->ReadVectorAttrib<unsigned long long>(ds, StatisticsHistogram));
+
+  if (ds.attrExists(StatisticsHistogramRange))
+    EncapsulateMetaData<std::vector<double>>(
+      metaDict, StatisticsHistogramRange, this->ReadVectorAttrib<double>(ds, StatisticsHistogramRange));
+}
+
+void
+HDF5ContainerImageIO::AccumulateProjections(const void * buffer)
+{
+  if (this->m_Projections == nullptr)
+    this->m_Projections.reset(new HDF5ContainerProjections(
+      this->m_Dimensions, this->GetNumberOfComponents(), this->GetUseMeanProjections()));
+
+  HDF5ContainerDispatchComponentType(this->GetComponentType(), [&](auto * tag) {
+    using ComponentType = std::remove_pointer_t<decltype(tag)>;
+    this->m_Projections->Add(static_cast<const ComponentType *>(buffer), this->GetIORegion());
+  });
+}
+
+void
+HDF5ContainerImageIO::WriteProjections()
+{
+  if (this->m_Projections == nullptr)
+    return;
+
+  const HDF5ContainerProjections & projections(*this->m_Projections);
+  const unsigned int               numComponents(projections.GetNumberOfComponents());
+  const unsigned int               numDims(this->GetNumberOfDimensions());
+
+  // Geometry of an image reduced to some of its axes, and downsampled
+  // by a factor with each pixel at the centre of the box it averages
+  auto geometry = [&](const std::vector<unsigned int> & axes,
+                      size_t                            factor,
+                      std::vector<double> &             spacing,
+                      std::vector<double> &             origin) {
+    spacing.clear();
+    origin.clear();
+    for (auto axis : axes)
+    {
+      spacing.push_back(this->m_Spacing[axis] * factor);
+      origin.push_back(this->m_Origin[axis] + 0.5 * (factor - 1) * this->m_Spacing[axis]);
+    }
+  };
+
+  std::vector<double>                      spacing, origin;
+  HDF5ContainerProjections::DimensionsType thumbnailDims;
+  size_t                                   factor;
+
+  for (unsigned int axis = 0; axis < numDims && numDims > 1; axis++)
+  {
+    std::vector<unsigned int> axes;
+    for (unsigned int k = 0; k < numDims; k++)
+    {
+      if (k != axis)
+        axes.push_back(k);
+    }
+    const auto        dims(projections.GetProjectionDimensions(axis));
+    const std::string suffix(std::to_string(axis));
+
+    geometry(axes, 1, spacing, origin);
+    this->WriteProjectionDataSet(MaximumProjectionSuffix + suffix,
+                                 projections.GetMaximumProjection(axis),
+                                 dims,
+                                 spacing,
+                                 origin,
+                                 this->GetComponentType(),
+                                 numComponents);
+    if (this->GetUseMeanProjections())
+      this->WriteProjectionDataSet(MeanProjectionSuffix + suffix,
+                                   projections.GetMeanProjection(axis),
+                                   dims,
+                                   spacing,
+                                   origin,
+                                   IOComponentEnum::FLOAT,
+                                   numComponents);
+
+    const std::vector<double> thumbnail(HDF5ContainerProjections::Downsample(
+      projections.GetMaximumProjection(axis), dims, numComponents, this->GetThumbnailSize(), thumbnailDims, factor));
+    geometry(axes, factor, spacing, origin);
+    this->WriteProjectionDataSet(MaximumProjectionThumbnailSuffix + suffix,
+                                 thumbnail,
+                                 thumbnailDims,
+                                 spacing,
+                                 origin,
+                                 this->GetComponentType(),
+                                 numComponents);
+  }
+
+  const std::vector<double> thumbnail(HDF5ContainerProjections::Downsample(projections.GetCentralSlice(),
+                                                                           projections.GetCentralSliceDimensions(),
+                                                                           numComponents,
+                                                                           this->GetThumbnailSize(),
+                                                                           thumbnailDims,
+                                                                           factor));
+  geometry(numDims > 1 ? std::vector<unsigned int>{ 0, 1 } : std::vector<unsigned int>{ 0 }, factor, spacing, origin);
+  this->WriteProjectionDataSet(
+    ThumbnailSuffix, thumbnail, thumbnailDims, spacing, origin, this->GetComponentType(), numComponents);
+
+  this->m_Projections.reset();
+}
+
+void
+HDF5ContainerImageIO::WriteProjectionDataSet(const std::string &                name,
+                                             const std::vector<double> &        data,
+                                             const std::vector<SizeValueType> & dims,
+                                             const std::vector<double> &        spacing,
+                                             const std::vector<double> &        origin,
+                                             IOComponentEnum                    componentType,
+                                             unsigned int                       numComponents)
+{
+  // Averages are rounded rather than truncated when stored as integers
+  std::vector<double> values(data);
+  if (componentType != IOComponentEnum::FLOAT && componentType != IOComponentEnum::DOUBLE)
+  {
+    for (auto & v : values)
+      v = std::round(v);
+  }
+
+  try
+  {
+    // HDF5 dimensions listed slowest moving first
+    std::vector<hsize_t> h5Dims(dims.rbegin(), dims.rend());
+    if (numComponents > 1)
+      h5Dims.push_back(numComponents);
+
+    const std::string path(this->GetDataSetPath() + name);
+    if (this->GetPathExists(path))
+      this->m_H5File->unlink(path);
+
+    H5::DataSpace space(static_cast<int>(h5Dims.size()), h5Dims.data());
+    H5::DataSet   ds(this->m_H5File->createDataSet(path, ComponentToPredType(componentType), space));
+    ds.write(values.data(), H5::PredType::NATIVE_DOUBLE);
+
+    this->WriteVectorAttrib(ds, Origin, origin);
+    this->WriteVectorAttrib(ds, Spacing, spacing);
+    this->WriteVectorAttrib(ds, Dimensions, dims);
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+namespace
+{
+// Chunk layout in which a dataset is processed, contiguous datasets are
+// processed in slabs of about 16 MB
+HDF5ContainerChunkGrid
+GetDataSetProcessingGrid(const H5::DataSet & ds)
+{
+  if (ds.getCreatePlist().getLayout() == H5D_CHUNKED)
+    return GetDataSetChunkGrid(ds);
+
+  H5::DataSpace                          space(ds.getSpace());
+  const int                              rank(space.getSimpleExtentNdims());
+  HDF5ContainerChunkGrid::DimensionsType dims(rank);
+  space.getSimpleExtentDims(dims.data());
+
+  HDF5ContainerChunkGrid::DimensionsType slab(dims);
+  hsize_t                                slabBytes(ds.getDataType().getSize());
+  for (int i = 1; i < rank; i++)
+    slabBytes *= dims[i];
+  slab[0] = std::max<hsize_t>(1, std::min<hsize_t>(dims[0], (16 << 20) / std::max<hsize_t>(slabBytes, 1)));
+  return HDF5ContainerChunkGrid(dims, slab);
+}
+
+// Call f(chunk, extent, blockDims, decoded, fillValue) for every chunk of
+// the processing grid of a dataset, on a pool of threads. decoded holds
+// the elements of the chunk in a block of blockDims, extent of which are
+// within the dataset. It is nullptr for unallocated chunks, which hold
+// the element fillValue. Chunks are read raw and decoded by the worker
+// threads when the codec supports the filters, otherwise libhdf5 decodes
+// them one at a time. Each work unit holds at most two chunks, so memory
+// use is bounded by the number of threads rather than the dataset size.
+template <typename TFunction>
+void
+ForEachDecodedChunk(const H5::DataSet & ds, const HDF5ContainerChunkGrid & grid, TFunction && f)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+  const int             rank(static_cast<int>(grid.GetRank()));
+  const bool            chunked(plist.getLayout() == H5D_CHUNKED);
+  const H5::DataType    dataType(ds.getDataType());
+  const size_t          elementSize(dataType.getSize());
+
+  const HDF5ContainerChunkCodec codec(chunked ? HDF5ContainerChunkCodec(ds) : HDF5ContainerChunkCodec());
+  const bool                    useRawChunks(chunked && codec.IsSupported());
+  const size_t                  chunkBytes(grid.GetChunkElements() * elementSize);
+  const bool                    fillNever(chunked && plist.getFillTime() == H5D_FILL_TIME_NEVER);
+
+  std::vector<unsigned char> fillValue(elementSize, 0);
+  if (chunked && plist.isFillValueDefined() != H5D_FILL_VALUE_UNDEFINED)
+    plist.getFillValue(dataType, fillValue.data());
+
+  const hid_t dsId(ds.getId());
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->ParallelizeArray(
+    0,
+    grid.GetNumberOfChunks(),
+    [&](SizeValueType chunk) {
+      const DimensionsType       offset(grid.GetChunkOffset(chunk));
+      const DimensionsType       extent(grid.GetChunkExtent(chunk));
+      hsize_t                    numElements(1);
+      std::vector<unsigned char> stored, decoded;
+      unsigned int               filterMask(0);
+      bool                       allocated(true);
+
+      for (auto e : extent)
+        numElements *= e;
+
+      {
+        // libhdf5 is only entered by one thread at a time
+        std::lock_guard<std::recursive_mutex> lock(HDF5ContainerImageIO::GetLibraryMutex());
+        if (useRawChunks)
+        {
+          haddr_t address;
+          hsize_t size;
+          if (H5Dget_chunk_info_by_coord(dsId, offset.data(), &filterMask, &address, &size) < 0)
+            itkGenericExceptionMacro(<< "Unable to query chunk " << chunk);
+          allocated = (address != HADDR_UNDEF);
+          if (allocated)
+          {
+            stored.resize(size);
+            if (H5Dread_chunk(dsId, H5P_DEFAULT, offset.data(), &filterMask, stored.data()) < 0)
+              itkGenericExceptionMacro(<< "Unable to read chunk " << chunk);
+          }
+        }
+        else
+        {
+          decoded.resize(numElements * elementSize);
+          if (fillNever)
+            HDF5ContainerFill(decoded.data(), numElements, fillValue.data(), elementSize);
+
+          H5::DataSpace fileSpace(ds.getSpace());
+          H5::DataSpace memSpace(rank, extent.data());
+          fileSpace.selectHyperslab(H5S_SELECT_SET, extent.data(), offset.data());
+          ds.read(decoded.data(), dataType, memSpace, fileSpace);
+        }
+      }
+
+      // Raw chunks always hold the full chunk dimensions, even at the
+      // edges of the dataset
+      const DimensionsType & blockDims(useRawChunks ? grid.GetChunkDimensions() : extent);
+      if (useRawChunks && allocated)
+        codec.Decode(stored, filterMask, chunkBytes, decoded);
+
+      f(static_cast<hsize_t>(chunk), extent, blockDims, allocated ? decoded.data() : nullptr, fillValue.data());
+    },
+    nullptr);
+}
+} // namespace
+
+HDF5ContainerImageIO::ChunkStatisticsType
+HDF5ContainerImageIO::ComputeStatistics()
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before ComputeStatistics()");
+
+  ChunkStatisticsType statistics;
+  double              squaredDeviations(0.0);
+  uint64_t            fingerprint;
+
+  try
+  {
+    H5::DataSet ds(this->GetDataSet());
+    fingerprint = GetDataSetFingerprint(ds);
+
+    // Results cached by an earlier call remain valid while the storage of
+    // the dataset is unchanged
+    if (ds.attrExists(StatisticsFingerprint) &&
+        this->ReadVectorAttrib<unsigned long long>(ds, StatisticsFingerprint).at(0) == fingerprint)
+    {
+      statistics.Minimum = this->ReadVectorAttrib<double>(ds, StatisticsMinimum).at(0);
+      statistics.Maximum = this->ReadVectorAttrib<double>(ds, StatisticsMaximum).at(0);
+      statistics.Count = ds.getSpace().getSimpleExtentNpoints();
+      statistics.Sum = this->ReadVectorAttrib<double>(ds, StatisticsMean).at(0) * statistics.Count;
+      statistics.ForegroundCount = this->ReadVectorAttrib<unsigned long long>(ds, StatisticsForegroundCount).at(0);
+      return statistics;
+    }
+
+    if (ds.getDataType().getSize() != this->GetComponentSize())
+      itkExceptionMacro(<< "Component size of " << this->GetDataSetPath() << " does not match its type");
+
+    const HDF5ContainerChunkGrid     grid(GetDataSetProcessingGrid(ds));
+    const bool                       chunked(ds.getCreatePlist().getLayout() == H5D_CHUNKED);
+    std::vector<ChunkStatisticsType> chunkStatistics(grid.GetNumberOfChunks());
+    std::vector<double>              chunkSquaredDeviations(grid.GetNumberOfChunks(), 0.0);
+    const IOComponentEnum            componentType(this->GetComponentType());
+    const double                     backgroundValue(this->GetFillValue());
+
+    ForEachDecodedChunk(
+      ds,
+      grid,
+      [&](hsize_t                chunk,
+          const DimensionsType & extent,
+          const DimensionsType & blockDims,
+          const void *           decoded,
+          const void *           fillValue) {
+        const DimensionsType origin(extent.size(), 0);
+        hsize_t              numElements(1);
+        for (auto e : extent)
+          numElements *= e;
+
+        ChunkStatisticsType & stats(chunkStatistics[chunk]);
+        HDF5ContainerDispatchComponentType(componentType, [&](auto * tag) {
+          using ComponentType = std::remove_pointer_t<decltype(tag)>;
+          const auto background(static_cast<ComponentType>(backgroundValue));
+
+          if (decoded == nullptr)
+          {
+            // Unallocated chunks hold the fill value, which has no deviation
+            ComponentType value;
+            std::memcpy(&value, fillValue, sizeof(value));
+            stats.Minimum = stats.Maximum = static_cast<double>(value);
+            stats.Sum = static_cast<double>(value) * static_cast<double>(numElements);
+            stats.Count = numElements;
+            stats.ForegroundCount = (value != background) ? numElements : 0;
+            return;
+          }
+
+          const auto * data = static_cast<const ComponentType *>(decoded);
+          HDF5ContainerAccumulateBlockStatistics(data, blockDims, origin, extent, background, stats);
+          chunkSquaredDeviations[chunk] =
+            HDF5ContainerBlockSquaredDeviations(data, blockDims, origin, extent, stats.GetMean());
+        });
+      });
+
+    for (hsize_t chunk = 0; chunk < grid.GetNumberOfChunks(); chunk++)
+      HDF5ContainerMergeStatistics(
+        chunkStatistics[chunk], chunkSquaredDeviations[chunk], statistics, squaredDeviations);
+
+    // The chunk statistics answer the chunk queries until the file is
+    // read again
+    if (chunked)
+      this->m_ChunkStatistics = chunkStatistics;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  this->CacheStatistics(statistics, squaredDeviations, fingerprint);
+  return statistics;
+}
+
+bool
+HDF5ContainerImageIO::OpenForCaching(bool & reopened)
+{
+  unsigned int intent(H5F_ACC_RDONLY);
+  reopened = false;
+
+  // ReadImageInformation() opens the file read only, open it for writing
+  // while the attributes are stored
+  H5Fget_intent(this->m_H5File->getId(), &intent);
+  if (intent & H5F_ACC_RDWR)
+    return true;
+
+  this->m_H5File->close();
+  try
+  {
+    this->OpenH5File(H5F_ACC_RDWR);
+    reopened = true;
+    return true;
+  }
+  catch (H5::Exception &)
+  {
+    this->OpenH5File(H5F_ACC_RDONLY);
+    return false;
+  }
+}
+
+void
+HDF5ContainerImageIO::CacheStatistics(const ChunkStatisticsType & statistics,
+                                      double                      squaredDeviations,
+                                      uint64_t                    fingerprint)
+{
+  try
+  {
+    bool reopened;
+    if (!this->OpenForCaching(reopened))
+    {
+      itkWarningMacro(<< "Statistics of " << this->GetDataSetPath() << " are not cached, " << this->GetFileName()
+                      << " is not writable");
+      return;
+    }
+
+    {
+      H5::DataSet  ds(this->GetDataSet());
+      const double standardDeviation(
+        statistics.Count > 0 ? std::sqrt(squaredDeviations / static_cast<double>(statistics.Count)) : 0.0);
+
+      for (auto name : { StatisticsMinimum,
+                         StatisticsMaximum,
+                         StatisticsMean,
+                         StatisticsStandardDeviation,
+                         StatisticsForegroundCount,
+                         StatisticsFingerprint })
+      {
+        if (ds.attrExists(name))
+          ds.removeAttr(name);
+      }
+
+      this->WriteVectorAttrib(ds, StatisticsMinimum, std::vector<double>(1, statistics.Minimum));
+      this->WriteVectorAttrib(ds, StatisticsMaximum, std::vector<double>(1, statistics.Maximum));
+      this->WriteVectorAttrib(ds, StatisticsMean, std::vector<double>(1, statistics.GetMean()));
+      this->WriteVectorAttrib(ds, StatisticsStandardDeviation, std::vector<double>(1, standardDeviation));
+      this->WriteVectorAttrib(
+        ds, StatisticsForegroundCount, std::vector<unsigned long long>(1, statistics.ForegroundCount));
+      this->WriteVectorAttrib(ds, StatisticsFingerprint, std::vector<unsigned long long>(1, fingerprint));
+
+      this->ReadImageStatistics(ds, this->GetMetaDataDictionary());
+    }
+
+    if (reopened)
+    {
+      this->m_H5File->close();
+      this->OpenH5File(H5F_ACC_RDONLY);
+    }
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+namespace
+{
+// Term of the content fingerprint for the element of a dataset with the
+// given linear index. The terms of all elements are summed, so chunks
+// contribute independently of the chunking, and as the mix is a bijection
+// an element changed always changes its term.
+inline uint64_t
+GetFingerprintTerm(uint64_t index, uint64_t value)
+{
+  uint64_t x(value ^ (index * 0x9E3779B97F4A7C15ULL));
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33;
+  x *= 0xC4CEB9FE1A85EC53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+template <typename TWord>
+uint64_t
+SumFingerprintTerms(const unsigned char * data, size_t stride, hsize_t n, uint64_t index)
+{
+  uint64_t sum(0);
+  for (hsize_t k = 0; k < n; k++, data += stride)
+  {
+    TWord value;
+    std::memcpy(&value, data, sizeof(value));
+    sum += GetFingerprintTerm(index + k, static_cast<uint64_t>(value));
+  }
+  return sum;
+}
+
+// Sum of the fingerprint terms of the extent of a block of elements, at
+// offset within a dataset of dims. A null block holds fillValue only
+uint64_t
+GetBlockFingerprint(const void *                                  block,
+                    const void *                                  fillValue,
+                    const HDF5ContainerChunkGrid::DimensionsType & blockDims,
+                    const HDF5ContainerChunkGrid::DimensionsType & offset,
+                    const HDF5ContainerChunkGrid::DimensionsType & extent,
+                    const HDF5ContainerChunkGrid::DimensionsType & dims,
+                    size_t                                        elementSize)
+{
+  const size_t                           rank(extent.size());
+  HDF5ContainerChunkGrid::DimensionsType pos(rank, 0);
+  uint64_t                               sum(0);
+
+  for (;;)
+  {
+    hsize_t blockIndex(0), index(0);
+    for (size_t i = 0; i < rank; i++)
+    {
+      blockIndex = blockIndex * blockDims[i] + pos[i];
+      index = index * dims[i] + offset[i] + pos[i];
+    }
+
+    const auto * row = block != nullptr ? static_cast<const unsigned char *>(block) + blockIndex * elementSize
+                                        : static_cast<const unsigned char *>(fillValue);
+    const size_t stride(block != nullptr ? elementSize : 0);
+    switch (elementSize)
+    {
+      case 1:
+        sum += SumFingerprintTerms<uint8_t>(row, stride, extent[rank - 1], index);
+        break;
+      case 2:
+        sum += SumFingerprintTerms<uint16_t>(row, stride, extent[rank - 1], index);
+        break;
+      case 4:
+        sum += SumFingerprintTerms<uint32_t>(row, stride, extent[rank - 1], index);
+        break;
+      case 8:
+        sum += SumFingerprintTerms<uint64_t>(row, stride, extent[rank - 1], index);
+        break;
+      default:
+        for (hsize_t k = 0; k < extent[rank - 1]; k++)
+          sum += GetFingerprintTerm(index + k, HDF5ContainerHash64(row + k * stride, elementSize));
+    }
+
+    size_t i(rank - 1);
+    while (i-- > 0)
+    {
+      if (++pos[i] < extent[i])
+        break;
+      pos[i] = 0;
+    }
+    if (i == static_cast<size_t>(-1))
+      break;
+  }
+  return sum;
+}
+
+// Filters, with their parameters, and fill value of a chunked dataset
+std::vector<uint64_t>
+GetDataSetFilterWords(const H5::DataSet & ds)
+{
+  H5::DSetCreatPropList plist(ds.getCreatePlist());
+  std::vector<uint64_t> words;
+
+  const int numFilters(plist.getNfilters());
+  for (int i = 0; i < numFilters; i++)
+  {
+    unsigned int flags(0), filterConfig(0);
+    size_t       numValues(16);
+    unsigned int values[16];
+    char         name[64];
+    const H5Z_filter_t filter(plist.getFilter(i, flags, numValues, values, sizeof(name), name, filterConfig));
+    words.push_back(static_cast<uint64_t>(filter));
+    words.push_back(flags);
+    words.insert(words.end(), values, values + std::min<size_t>(numValues, 16));
+  }
+
+  const H5::DataType         dataType(ds.getDataType());
+  std::vector<unsigned char> fillValue(dataType.getSize(), 0);
+  if (plist.isFillValueDefined() != H5D_FILL_VALUE_UNDEFINED)
+    plist.getFillValue(dataType, fillValue.data());
+  words.push_back(HDF5ContainerHash64(fillValue.data(), fillValue.size()));
+  return words;
+}
+
+// Dimensions and element type of a dataset, which datasets compared have
+// to share
+std::vector<uint64_t>
+GetDataSetShapeWords(const H5::DataSet & ds)
+{
+  H5::DataSpace                          space(ds.getSpace());
+  HDF5ContainerChunkGrid::DimensionsType dims(space.getSimpleExtentNdims());
+  space.getSimpleExtentDims(dims.data());
+
+  const H5::DataType    dataType(ds.getDataType());
+  std::vector<uint64_t> words(dims.begin(), dims.end());
+  words.push_back(dims.size());
+  words.push_back(static_cast<uint64_t>(dataType.getClass()));
+  words.push_back(dataType.getSize());
+  words.push_back(dataType.getClass() == H5T_INTEGER ? static_cast<uint64_t>(H5Tget_sign(dataType.getId())) : 0);
+  return words;
+}
+} // namespace
+
+uint64_t
+HDF5ContainerImageIO::ComputeFingerprint()
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before ComputeFingerprint()");
+
+  uint64_t storageFingerprint, fingerprint;
+  try
+  {
+    H5::DataSet ds(this->GetDataSet());
+    storageFingerprint = GetDataSetFingerprint(ds);
+
+    // A fingerprint cached by an earlier call remains valid while the
+    // storage of the dataset is unchanged
+    if (ds.attrExists(ContentFingerprint))
+    {
+      const std::vector<unsigned long long> cached(this->ReadVectorAttrib<unsigned long long>(ds, ContentFingerprint));
+      if (cached.size() == 2 && cached[0] == storageFingerprint)
+        return cached[1];
+    }
+
+    H5::DataSpace  space(ds.getSpace());
+    DimensionsType dims(space.getSimpleExtentNdims());
+    space.getSimpleExtentDims(dims.data());
+
+    const HDF5ContainerChunkGrid grid(GetDataSetProcessingGrid(ds));
+    const size_t                 elementSize(ds.getDataType().getSize());
+    std::atomic<uint64_t>        sum(0);
+
+    ForEachDecodedChunk(
+      ds,
+      grid,
+      [&](hsize_t                chunk,
+          const DimensionsType & extent,
+          const DimensionsType & blockDims,
+          const void *           decoded,
+          const void *           fillValue) {
+        sum += GetBlockFingerprint(
+          decoded, fillValue, blockDims, grid.GetChunkOffset(chunk), extent, dims, elementSize);
+      });
+
+    std::vector<uint64_t> words(GetDataSetShapeWords(ds));
+    words.push_back(sum);
+    fingerprint = HDF5ContainerHash64(words.data(), words.size() * sizeof(uint64_t));
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+
+  try
+  {
+    bool reopened;
+    if (!this->OpenForCaching(reopened))
+      return fingerprint;
+
+    {
+      H5::DataSet ds(this->GetDataSet());
+      if (ds.attrExists(ContentFingerprint))
+        ds.removeAttr(ContentFingerprint);
+      this->WriteVectorAttrib(
+        ds, ContentFingerprint, std::vector<unsigned long long>{ storageFingerprint, fingerprint });
+    }
+
+    if (reopened)
+    {
+      this->m_H5File->close();
+      this->OpenH5File(H5F_ACC_RDONLY);
+    }
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  return fingerprint;
+}
+
+bool
+HDF5ContainerImageIO::CompareDataSets(HDF5ContainerImageIO * other)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (other == nullptr || this->m_H5File == nullptr || other->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called on both ImageIO before CompareDataSets()");
+
+  try
+  {
+    H5::DataSet ds(this->GetDataSet());
+    H5::DataSet otherDs(other->GetDataSet());
+    if (GetDataSetShapeWords(ds) != GetDataSetShapeWords(otherDs))
+      return false;
+
+    // The stored bytes of chunks are only comparable with the same
+    // chunking, filters and fill value
+    const bool chunked(ds.getCreatePlist().getLayout() == H5D_CHUNKED &&
+                       otherDs.getCreatePlist().getLayout() == H5D_CHUNKED);
+    if (!chunked || GetDataSetChunkGrid(ds).GetChunkDimensions() != GetDataSetChunkGrid(otherDs).GetChunkDimensions() ||
+        GetDataSetFilterWords(ds) != GetDataSetFilterWords(otherDs))
+    {
+      // ComputeFingerprint() may reopen the files to cache the
+      // fingerprint, which needs the datasets closed
+      ds.close();
+      otherDs.close();
+      return this->ComputeFingerprint() == other->ComputeFingerprint();
+    }
+
+    const HDF5ContainerChunkGrid grid(GetDataSetChunkGrid(ds));
+    const H5::DataType           dataType(ds.getDataType());
+    const size_t                 elementSize(dataType.getSize());
+    const int                    rank(static_cast<int>(grid.GetRank()));
+    std::atomic<bool>            equal(true);
+
+    // Both datasets share the fill value, which libhdf5 leaves out of the
+    // chunks never written of sparse datasets
+    H5::DSetCreatPropList      plist(ds.getCreatePlist());
+    std::vector<unsigned char> fillValue(elementSize, 0);
+    if (plist.isFillValueDefined() != H5D_FILL_VALUE_UNDEFINED)
+      plist.getFillValue(dataType, fillValue.data());
+
+    // Chunks are compared stored, those whose bytes differ, e.g. written
+    // with another compression level, are read and compared decoded
+    MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+    threader->ParallelizeArray(
+      0,
+      grid.GetNumberOfChunks(),
+      [&](SizeValueType chunk) {
+        if (!equal)
+          return;
+
+        const DimensionsType       offset(grid.GetChunkOffset(chunk));
+        std::vector<unsigned char> stored[2];
+        bool                       allocated[2];
+        unsigned int               filterMask[2];
+
+        // libhdf5 is only entered by one thread at a time
+        std::unique_lock<std::recursive_mutex> lock(HDF5ContainerImageIO::GetLibraryMutex());
+        const hid_t                            ids[2] = { ds.getId(), otherDs.getId() };
+        hsize_t                                size[2];
+        for (int i = 0; i < 2; i++)
+        {
+          haddr_t address;
+          if (H5Dget_chunk_info_by_coord(ids[i], offset.data(), &filterMask[i], &address, &size[i]) < 0)
+            itkGenericExceptionMacro(<< "Unable to query chunk " << chunk);
+          allocated[i] = (address != HADDR_UNDEF);
+        }
+
+        // Unallocated chunks both hold the same fill value
+        if (!allocated[0] && !allocated[1])
+          return;
+
+        if (allocated[0] && allocated[1] && size[0] == size[1] && filterMask[0] == filterMask[1])
+        {
+          for (int i = 0; i < 2; i++)
+          {
+            stored[i].resize(size[i]);
+            if (H5Dread_chunk(ids[i], H5P_DEFAULT, offset.data(), &filterMask[i], stored[i].data()) < 0)
+              itkGenericExceptionMacro(<< "Unable to read chunk " << chunk);
+          }
+          lock.unlock();
+          if (stored[0] == stored[1])
+            return;
+          lock.lock();
+        }
+
+        const DimensionsType extent(grid.GetChunkExtent(chunk));
+        hsize_t              numElements(1);
+        for (auto e : extent)
+          numElements *= e;
+
+        H5::DataSpace memSpace(rank, extent.data());
+        for (int i = 0; i < 2; i++)
+        {
+          H5::DataSpace fileSpace((i == 0 ? ds : otherDs).getSpace());
+          fileSpace.selectHyperslab(H5S_SELECT_SET, extent.data(), offset.data());
+          stored[i].resize(numElements * elementSize);
+          HDF5ContainerFill(stored[i].data(), numElements, fillValue.data(), elementSize);
+          (i == 0 ? ds : otherDs).read(stored[i].data(), dataType, memSpace, fileSpace);
+        }
+        lock.unlock();
+        if (stored[0] != stored[1])
+          equal = false;
+      },
+      nullptr);
+
+    return equal;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+namespace
+{
+// Suffixes of the datasets stored beside a dataset, in the order they
+// are copied, the dataset itself first
+std::vector<std::string>
+GetDataSetCopySuffixes(unsigned int numDims)
+{
+  std::vector<std::string>       suffixes{ "", ZstdDictionarySuffix, ChunkHashesSuffix, ChunkChecksumsSuffix };
+  const std::vector<std::string> derived(GetDerivedDataSetSuffixes(numDims));
+  suffixes.insert(suffixes.end(), derived.begin(), derived.end());
+  return suffixes;
+}
+
+// Copy an object, with its attributes and members, between files
+void
+CopyObject(const H5::H5File & source, const std::string & sourcePath, H5::H5File & dest, const std::string & destPath)
+{
+  if (H5Ocopy(source.getId(), sourcePath.c_str(), dest.getId(), destPath.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+    itkGenericExceptionMacro(<< "Unable to copy " << sourcePath << " to " << destPath);
+}
+} // namespace
+
+H5::Group
+HDF5ContainerImageIO::OpenForCopy()
+{
+  this->CloseH5File();
+
+  H5::FileAccPropList fapl;
+#if (H5_VERS_MAJOR > 1) || (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR > 10) || \
+  (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR == 10) && (H5_VERS_RELEASE >= 2)
+  // File format which is backwards compatible with HDF5 version 1.8
+  fapl.setLibverBounds(H5F_LIBVER_V18, H5F_LIBVER_V18);
+#endif
+  this->ResetH5File(fapl);
+
+  try
+  {
+    H5::Group group(this->GetGroup());
+
+    if (group.nameExists(this->GetDataSetName()))
+    {
+      if (!this->GetOverwrite())
+        itkExceptionMacro("DataSet: " << this->GetDataSetName() << ", already exists");
+
+      // The datasets stored beside the one replaced describe it only
+      const int rank(this->GetDataSet().getSpace().getSimpleExtentNdims());
+      for (const auto & suffix : GetDataSetCopySuffixes(static_cast<unsigned int>(rank)))
+      {
+        if (this->GetPathExists(this->GetDataSetPath() + suffix))
+          this->m_H5File->unlink(this->GetDataSetPath() + suffix);
+      }
+    }
+    return group;
+  }
+  catch (H5::Exception & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
+
+void
+HDF5ContainerImageIO::CopyDataSet(HDF5ContainerImageIO * destination)
+{
+  if (destination == nullptr || this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before CopyDataSet()");
+  if (destination->GetFileName() == this->GetFileName())
+    itkExceptionMacro(<< "Unable to copy " << this->GetDataSetName() << " within " << this->GetFileName());
+
+  destination->OpenForCopy();
+  try
+  {
+    for (const auto & suffix : GetDataSetCopySuffixes(this->GetNumberOfDimensions()))
+    {
+      if (this->GetPathExists(this->GetDataSetPath() + suffix))
+        CopyObject(*this->m_H5File, this->GetDataSetPath() + suffix, *destination->m_H5File,
+                   destination->GetDataSetPath() + suffix);
+    }
+
+    // Datasets merged in a path share the metadata of the first
+    this->CopyMetaData(destination);
+  }
+  catch (H5::Exception & error)
+  {
+    destination->CloseH5File();
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  catch (ExceptionObject &)
+  {
+    destination->CloseH5File();
+    throw;
+  }
+  destination->CloseH5File();
+}
+
+void
+HDF5ContainerImageIO::CopyRegion(const ImageIORegion & region, HDF5ContainerImageIO * destination)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (destination == nullptr || this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before CopyRegion()");
+  if (destination->GetFileName() == this->GetFileName())
+    itkExceptionMacro(<< "Unable to copy " << this->GetDataSetName() << " within " << this->GetFileName());
+
+  const unsigned int numDims(this->GetNumberOfDimensions());
+  if (region.GetImageDimension() != numDims)
+    itkExceptionMacro(<< "Region has " << region.GetImageDimension() << " dimensions rather than " << numDims);
+  for (unsigned int i = 0; i < numDims; i++)
+  {
+    if (region.GetIndex(i) < 0 || region.GetSize(i) == 0 ||
+        region.GetIndex(i) + static_cast<IndexValueType>(region.GetSize(i)) >
+          static_cast<IndexValueType>(this->GetDimensions(i)))
+      itkExceptionMacro(<< "Region " << region << " is not within " << this->GetDataSetName());
+  }
+
+  // The copy has the geometry of the region
+  destination->SetNumberOfDimensions(numDims);
+  destination->SetPixelType(this->GetPixelType());
+  destination->SetComponentType(this->GetComponentType());
+  destination->SetNumberOfComponents(this->GetNumberOfComponents());
+  for (unsigned int i = 0; i < numDims; i++)
+  {
+    double origin(this->GetOrigin(i));
+    for (unsigned int j = 0; j < numDims; j++)
+      origin += this->GetDirection(j)[i] * region.GetIndex(j) * this->GetSpacing(j);
+    destination->SetDimensions(i, region.GetSize(i));
+    destination->SetSpacing(i, this->GetSpacing(i));
+    destination->SetDirection(i, this->GetDirection(i));
+    destination->SetOrigin(i, origin);
+  }
+
+  H5::Group group(destination->OpenForCopy());
+  try
+  {
+    H5::DataSet        ds(this->GetDataSet());
+    const H5::DataType dataType(ds.getDataType());
+    const size_t       elementSize(dataType.getSize());
+    H5::DataSpace      space(ds.getSpace());
+    const int          rank(space.getSimpleExtentNdims());
+
+    // HDF5 dimensions listed slowest moving first, followed by the
+    // components
+    DimensionsType dims(rank), destDims(rank), regionOffset(rank, 0);
+    space.getSimpleExtentDims(dims.data());
+    destDims = dims;
+    for (unsigned int i = 0; i < numDims; i++)
+    {
+      destDims[numDims - i - 1] = region.GetSize(i);
+      regionOffset[numDims - i - 1] = region.GetIndex(i);
+    }
+
+    // The copy has the chunking, filters and fill value of the dataset,
+    // chunks larger than the region are clipped to it
+    H5::DSetCreatPropList plist(ds.getCreatePlist());
+    const bool            chunked(plist.getLayout() == H5D_CHUNKED);
+    bool                  rawChunks(chunked);
+    if (chunked)
+    {
+      DimensionsType chunkDims(GetDataSetChunkGrid(ds).GetChunkDimensions());
+      for (int i = 0; i < rank; i++)
+      {
+        rawChunks = rawChunks && regionOffset[i] % chunkDims[i] == 0 && chunkDims[i] <= destDims[i];
+        chunkDims[i] = std::min(chunkDims[i], destDims[i]);
+      }
+      plist.setChunk(rank, chunkDims.data());
+    }
+
+    std::vector<unsigned char> fillValue(elementSize, 0);
+    if (plist.isFillValueDefined() != H5D_FILL_VALUE_UNDEFINED)
+      plist.getFillValue(dataType, fillValue.data());
+    const bool fillNever(plist.getFillTime() == H5D_FILL_TIME_NEVER);
+
+    H5::DataSpace destSpace(rank, destDims.data());
+    H5::DataSet   destDs(group.createDataSet(destination->GetDataSetName(), dataType, destSpace, plist));
+    destination->WriteDataSetAttributes(destDs);
+
+    // Chunks compressed with a dictionary need it to be decompressed
+    const std::string dictionaryPath(this->GetDataSetPath() + ZstdDictionarySuffix);
+    if (this->GetPathExists(dictionaryPath))
+      CopyObject(*this->m_H5File, dictionaryPath, *destination->m_H5File,
+                 destination->GetDataSetPath() + ZstdDictionarySuffix);
+
+    const HDF5ContainerChunkGrid grid(GetDataSetProcessingGrid(destDs));
+    const hid_t                  dsId(ds.getId());
+    const hid_t                  destId(destDs.getId());
+
+    if (rawChunks)
+    {
+      // Every chunk of the copy is a chunk of the dataset, those never
+      // allocated hold the fill value in both
+      std::vector<unsigned char> stored;
+      for (SizeValueType chunk = 0; chunk < grid.GetNumberOfChunks(); chunk++)
+      {
+        const DimensionsType destOffset(grid.GetChunkOffset(chunk));
+        DimensionsType       offset(destOffset);
+        for (int i = 0; i < rank; i++)
+          offset[i] += regionOffset[i];
+
+        unsigned int filterMask(0);
+        haddr_t      address;
+        hsize_t      size;
+        if (H5Dget_chunk_info_by_coord(dsId, offset.data(), &filterMask, &address, &size) < 0)
+          itkExceptionMacro(<< "Unable to query chunk " << chunk << " of the copy");
+        if (address == HADDR_UNDEF)
+          continue;
+
+        stored.resize(size);
+        if (H5Dread_chunk(dsId, H5P_DEFAULT, offset.data(), &filterMask, stored.data()) < 0 ||
+            H5Dwrite_chunk(destId, H5P_DEFAULT, filterMask, destOffset.data(), size, stored.data()) < 0)
+          itkExceptionMacro(<< "Unable to copy chunk " << chunk << " of the copy");
+      }
+    }
+    else
+    {
+      // The chunks straddle chunks of the dataset, each is read through
+      // libhdf5 and encoded by the worker threads when the codec supports
+      // the filters
+      const HDF5ContainerChunkCodec codec(chunked ? HDF5ContainerChunkCodec(destDs) : HDF5ContainerChunkCodec());
+      const bool                    encode(chunked && codec.IsEncodeSupported());
+      const size_t                  chunkBytes(grid.GetChunkElements() * elementSize);
+      const HDF5ContainerChunkGrid  sourceGrid(GetDataSetProcessingGrid(ds));
+
+      MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+      threader->ParallelizeArray(
+        0,
+        grid.GetNumberOfChunks(),
+        [&](SizeValueType chunk) {
+          const DimensionsType destOffset(grid.GetChunkOffset(chunk));
+          const DimensionsType extent(grid.GetChunkExtent(chunk));
+          DimensionsType       offset(destOffset);
+          hsize_t              numElements(1);
+          for (int i = 0; i < rank; i++)
+          {
+            offset[i] += regionOffset[i];
+            numElements *= extent[i];
+          }
+
+          std::vector<unsigned char> decoded(numElements * elementSize);
+          if (fillNever)
+            HDF5ContainerFill(decoded.data(), numElements, fillValue.data(), elementSize);
+
+          {
+            // libhdf5 is only entered by one thread at a time
+            std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+
+            // Chunks over chunks of the dataset never allocated hold the
+            // fill value in both, and are left unallocated in the copy
+            if (chunked)
+            {
+              bool allocated(false);
+              for (auto sourceChunk : sourceGrid.GetChunksIntersecting(offset, extent))
+              {
+                const DimensionsType sourceOffset(sourceGrid.GetChunkOffset(sourceChunk));
+                unsigned int         filterMask(0);
+                haddr_t              address;
+                hsize_t              size;
+                if (H5Dget_chunk_info_by_coord(dsId, sourceOffset.data(), &filterMask, &address, &size) < 0)
+                  itkGenericExceptionMacro(<< "Unable to query chunk " << sourceChunk);
+                if (address != HADDR_UNDEF)
+                {
+                  allocated = true;
+                  break;
+                }
+              }
+              if (!allocated)
+                return;
+            }
+
+            H5::DataSpace memSpace(rank, extent.data());
+            H5::DataSpace fileSpace(ds.getSpace());
+            fileSpace.selectHyperslab(H5S_SELECT_SET, extent.data(), offset.data());
+            ds.read(decoded.data(), dataType, memSpace, fileSpace);
+            if (!encode)
+            {
+              H5::DataSpace destFileSpace(destDs.getSpace());
+              destFileSpace.selectHyperslab(H5S_SELECT_SET, extent.data(), destOffset.data());
+              destDs.write(decoded.data(), dataType, memSpace, destFileSpace);
+              return;
+            }
+          }
+
+          // Chunks are stored with the full chunk dimensions, even at the
+          // edges of the dataset
+          std::vector<unsigned char> block(chunkBytes), stored;
+          const DimensionsType       origin(rank, 0);
+          HDF5ContainerCopyBlock(
+            decoded.data(), extent, origin, block.data(), grid.GetChunkDimensions(), origin, extent, elementSize);
+          codec.Encode(block.data(), chunkBytes, stored);
+
+          std::lock_guard<std::recursive_mutex> lock(GetLibraryMutex());
+          if (H5Dwrite_chunk(destId, H5P_DEFAULT, 0, destOffset.data(), stored.size(), stored.data()) < 0)
+            itkGenericExceptionMacro(<< "Unable to write chunk " << chunk << " of the copy");
+        },
+        nullptr);
+    }
+
+    // Datasets merged in a path share the metadata of the first
+    this->CopyMetaData(destination);
+  }
+  catch (H5::Exception & error)
+  {
+    destination->CloseH5File();
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  catch (ExceptionObject &)
+  {
+    destination->CloseH5File();
+    throw;
+  }
+  destination->CloseH5File();
+}
+
+void
+HDF5ContainerImageIO::CopyMetaData(HDF5ContainerImageIO * destination)
+{
+  if (destination == nullptr || this->m_H5File == nullptr)
+    itkExceptionMacro(<< "ReadImageInformation() must be called before CopyMetaData()");
+  if (destination->m_H5File == nullptr)
+    itkExceptionMacro(<< "The file of the destination is not open for writing");
+
+  const std::string metaDataPath(std::string(this->GetPath()) + "/" + MetaDataName);
+  const std::string destMetaDataPath(std::string(destination->GetPath()) + "/" + MetaDataName);
+  if (this->GetPathExists(metaDataPath) && !destination->GetPathExists(destMetaDataPath))
+    CopyObject(*this->m_H5File, metaDataPath, *destination->m_H5File, destMetaDataPath);
+}
+
 //
 // GetHeaderSize -- return 0
 ImageIOBase::SizeType
@@ -1871,12 +5728,13 @@ HDF5ContainerImageIO ::DataSetExists()
   {
     this->CloseH5File();
 
-    if (!std::filesystem::exists(this->GetFileName()))
+    FileDriverEnum driver(this->GetFileDriver());
+    if (!FindContainerFileDriver(this->GetFileName(), driver))
       // File doesn't exist
       return false;
 
     // Open file as read-only
-    this->m_H5File.reset(new H5::H5File(this->GetFileName(), H5F_ACC_RDONLY));
+    this->OpenH5File(H5F_ACC_RDONLY);
 
     // Check for the existence of the path
     if (!this->GetPathExists(this->GetPath()))
@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerLayoutAdvisor.h"
+#include "itkHDF5ContainerAccessTrace.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <list>
+#include <sstream>
+#include <unordered_map>
+
+namespace itk
+{
+namespace
+{
+// libhdf5 limits chunks to 4GB
+const uint64_t MaximumChunkBytes((uint64_t(1) << 32) - 1);
+
+// Replay regions against a chunk size and cache size
+void
+SimulateLayout(const std::vector<ImageIORegion> &                 regions,
+               const HDF5ContainerAccessTrace::DimensionsType &   dimensions,
+               uint64_t                                           pixelSize,
+               HDF5ContainerLayoutAdvisor::LayoutEvaluationType & evaluation)
+{
+  const size_t               numDims(dimensions.size());
+  std::vector<SizeValueType> gridSize(numDims);
+  SizeValueType              chunkBytes(pixelSize);
+  for (size_t i = 0; i < numDims; i++)
+  {
+    gridSize[i] = (dimensions[i] + evaluation.ChunkSize[i] - 1) / evaluation.ChunkSize[i];
+    chunkBytes *= evaluation.ChunkSize[i];
+  }
+
+  // Chunks are stored whole, so reading one decompresses all its bytes,
+  // and the cache holds whole chunks only
+  const SizeValueType                                                   capacity(evaluation.CacheSize / chunkBytes);
+  std::list<SizeValueType>                                              recent;
+  std::unordered_map<SizeValueType, std::list<SizeValueType>::iterator> cached;
+
+  std::vector<SizeValueType> first(numDims), last(numDims), position(numDims);
+  for (const auto & region : regions)
+  {
+    bool empty(false);
+    for (size_t i = 0; i < numDims; i++)
+    {
+      const SizeValueType index(static_cast<SizeValueType>(std::max<IndexValueType>(0, region.GetIndex(i))));
+      const SizeValueType end(std::min<SizeValueType>(dimensions[i], index + region.GetSize(i)));
+      empty = empty || end <= index;
+      first[i] = index / evaluation.ChunkSize[i];
+      last[i] = empty ? first[i] : (end - 1) / evaluation.ChunkSize[i];
+    }
+    if (empty)
+      continue;
+
+    // Every chunk of the region, fastest moving dimension first
+    position = first;
+    for (;;)
+    {
+      SizeValueType chunk(0);
+      for (size_t i = numDims; i-- > 0;)
+        chunk = chunk * gridSize[i] + position[i];
+
+      evaluation.ChunksTouched++;
+      const auto found(cached.find(chunk));
+      if (found != cached.end())
+      {
+        recent.splice(recent.begin(), recent, found->second);
+      }
+      else
+      {
+        evaluation.ChunksRead++;
+        if (capacity > 0)
+        {
+          recent.push_front(chunk);
+          cached[chunk] = recent.begin();
+          if (recent.size() > capacity)
+          {
+            cached.erase(recent.back());
+            recent.pop_back();
+          }
+        }
+      }
+
+      size_t i(0);
+      for (; i < numDims && position[i] == last[i]; i++)
+        position[i] = first[i];
+      if (i == numDims)
+        break;
+      position[i]++;
+    }
+  }
+
+  evaluation.BytesDecompressed = evaluation.ChunksRead * chunkBytes;
+  evaluation.HitRate =
+    evaluation.ChunksTouched > 0
+      ? static_cast<double>(evaluation.ChunksTouched - evaluation.ChunksRead) / evaluation.ChunksTouched
+      : 0.0;
+}
+} // namespace
+
+void
+HDF5ContainerLayoutAdvisor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "TraceFileName: " << this->m_TraceFileName << std::endl;
+  os << indent << "ChunkOverhead: " << this->m_ChunkOverhead << std::endl;
+  os << indent << "CacheCost: " << this->m_CacheCost << std::endl;
+  os << indent << "MemoryBudget: " << this->m_MemoryBudget << std::endl;
+  os << indent << "CandidateChunkSizes: " << this->m_CandidateChunkSizes.size() << std::endl;
+  os << indent << "CandidateCacheSizes: " << this->m_CandidateCacheSizes.size() << std::endl;
+  os << indent << "NumberOfAccesses: " << this->m_NumberOfAccesses << std::endl;
+}
+
+void
+HDF5ContainerLayoutAdvisor::AddCandidateChunkSize(const std::vector<unsigned int> & chunkSize)
+{
+  this->m_CandidateChunkSizes.push_back(chunkSize);
+  this->Modified();
+}
+
+void
+HDF5ContainerLayoutAdvisor::AddCandidateCacheSize(SizeValueType bytes)
+{
+  this->m_CandidateCacheSizes.push_back(bytes);
+  this->Modified();
+}
+
+void
+HDF5ContainerLayoutAdvisor::ClearCandidates()
+{
+  this->m_CandidateChunkSizes.clear();
+  this->m_CandidateCacheSizes.clear();
+  this->Modified();
+}
+
+void
+HDF5ContainerLayoutAdvisor::Evaluate()
+{
+  HDF5ContainerAccessTrace::DimensionsType dimensions;
+  uint64_t                                 pixelSize(0);
+  std::vector<ImageIORegion>               regions;
+  HDF5ContainerAccessTrace::Read(this->m_TraceFileName, dimensions, pixelSize, regions);
+  this->m_NumberOfAccesses = regions.size();
+
+  const size_t numDims(dimensions.size());
+  for (auto dim : dimensions)
+  {
+    if (dim == 0)
+      itkExceptionMacro(<< this->m_TraceFileName << " records an empty image");
+  }
+
+  std::vector<std::vector<unsigned int>> chunkSizes(this->m_CandidateChunkSizes);
+  if (chunkSizes.empty())
+  {
+    for (unsigned int edge : { 16, 32, 64, 128, 256 })
+      chunkSizes.emplace_back(numDims, edge);
+    for (unsigned int depth : { 1, 4, 16 })
+    {
+      std::vector<unsigned int> slab(dimensions.begin(), dimensions.end());
+      slab[numDims - 1] = depth;
+      chunkSizes.push_back(slab);
+    }
+  }
+
+  // Candidates are clipped to the image, those made equal by it and
+  // those too large for libhdf5 are dropped
+  std::vector<std::vector<unsigned int>> candidates;
+  for (auto chunkSize : chunkSizes)
+  {
+    if (chunkSize.size() != numDims)
+      itkExceptionMacro(<< "Chunk size of " << chunkSize.size() << " dimensions for an image of " << numDims);
+
+    uint64_t chunkBytes(pixelSize);
+    for (size_t i = 0; i < numDims; i++)
+    {
+      chunkSize[i] =
+        static_cast<unsigned int>(std::max<uint64_t>(1, std::min<uint64_t>(chunkSize[i], dimensions[i])));
+      chunkBytes *= chunkSize[i];
+    }
+    if (chunkBytes <= MaximumChunkBytes &&
+        std::find(candidates.begin(), candidates.end(), chunkSize) == candidates.end())
+      candidates.push_back(chunkSize);
+  }
+
+  std::vector<SizeValueType> cacheSizes(this->m_CandidateCacheSizes);
+  if (cacheSizes.empty())
+    cacheSizes = { SizeValueType(1) << 20, SizeValueType(64) << 20, SizeValueType(1) << 30 };
+  if (this->m_MemoryBudget > 0)
+  {
+    const SizeValueType budget(this->m_MemoryBudget);
+    cacheSizes.erase(std::remove_if(cacheSizes.begin(),
+                                    cacheSizes.end(),
+                                    [budget](SizeValueType cacheSize) { return cacheSize > budget; }),
+                     cacheSizes.end());
+    if (cacheSizes.empty())
+      itkExceptionMacro(<< "No candidate cache size is within the memory budget of " << budget << " bytes");
+  }
+
+  this->m_Evaluations.clear();
+  for (const auto & chunkSize : candidates)
+  {
+    for (auto cacheSize : cacheSizes)
+    {
+      LayoutEvaluationType evaluation;
+      evaluation.ChunkSize = chunkSize;
+      evaluation.CacheSize = cacheSize;
+      this->m_Evaluations.push_back(evaluation);
+    }
+  }
+
+  // Each layout is replayed by one work unit
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->ParallelizeArray(
+    0,
+    this->m_Evaluations.size(),
+    [&](SizeValueType i) {
+      LayoutEvaluationType & evaluation(this->m_Evaluations[i]);
+      SimulateLayout(regions, dimensions, pixelSize, evaluation);
+      evaluation.Cost = static_cast<double>(evaluation.BytesDecompressed) +
+                        static_cast<double>(evaluation.ChunksRead) * static_cast<double>(this->m_ChunkOverhead) +
+                        static_cast<double>(evaluation.CacheSize) * this->m_CacheCost;
+    },
+    nullptr);
+
+  std::stable_sort(this->m_Evaluations.begin(),
+                   this->m_Evaluations.end(),
+                   [](const LayoutEvaluationType & a, const LayoutEvaluationType & b) {
+                     if (a.Cost != b.Cost)
+                       return a.Cost < b.Cost;
+                     return a.CacheSize < b.CacheSize;
+                   });
+}
+
+std::vector<unsigned int>
+HDF5ContainerLayoutAdvisor::GetRecommendedChunkSize() const
+{
+  if (this->m_Evaluations.empty())
+    itkExceptionMacro(<< "Evaluate() must be called first");
+  return this->m_Evaluations.front().ChunkSize;
+}
+
+SizeValueType
+HDF5ContainerLayoutAdvisor::GetRecommendedCacheSize() const
+{
+  if (this->m_Evaluations.empty())
+    itkExceptionMacro(<< "Evaluate() must be called first");
+  return this->m_Evaluations.front().CacheSize;
+}
+
+std::string
+HDF5ContainerLayoutAdvisor::FormatChunkSize(const std::vector<unsigned int> & chunkSize)
+{
+  std::ostringstream text;
+  for (size_t i = 0; i < chunkSize.size(); i++)
+    text << (i > 0 ? "," : "") << chunkSize[i];
+  return text.str();
+}
+} // end namespace itk
@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerLocalChunkCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace itk
+{
+namespace
+{
+const std::string EntryExtension(".chunk");
+
+// Size of the entries in a directory, with their modification times
+uintmax_t
+ScanEntries(const std::filesystem::path &                                                      directory,
+            std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> * entries)
+{
+  uintmax_t       size(0);
+  std::error_code error;
+  for (const auto & item : std::filesystem::directory_iterator(directory, error))
+  {
+    if (!item.is_regular_file(error) || item.path().extension() != EntryExtension)
+      continue;
+    size += item.file_size(error);
+    if (entries != nullptr)
+      entries->emplace_back(item.last_write_time(error), item.path());
+  }
+  return size;
+}
+} // namespace
+
+HDF5ContainerLocalChunkCache &
+HDF5ContainerLocalChunkCache::GetInstance(const std::string & directory)
+{
+  static std::mutex                                                            mutex;
+  static std::map<std::string, std::unique_ptr<HDF5ContainerLocalChunkCache>> instances;
+
+  std::error_code             error;
+  const std::string           key(std::filesystem::weakly_canonical(directory, error).string());
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto & instance(instances[key]);
+  if (instance == nullptr)
+    instance.reset(new HDF5ContainerLocalChunkCache(key));
+  return *instance;
+}
+
+HDF5ContainerLocalChunkCache::HDF5ContainerLocalChunkCache(const std::filesystem::path & directory)
+  : m_Directory(directory)
+{
+  std::error_code error;
+  std::filesystem::create_directories(m_Directory, error);
+  m_Size = ScanEntries(m_Directory, nullptr);
+}
+
+void
+HDF5ContainerLocalChunkCache::SetCapacity(uintmax_t bytes)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Capacity = bytes;
+  if (m_Size > m_Capacity)
+    this->Evict();
+}
+
+std::string
+HDF5ContainerLocalChunkCache::GetEntryName(uint64_t file, uint64_t dataSet, uint64_t chunk, uint64_t version)
+{
+  char name[96];
+  std::snprintf(name,
+                sizeof(name),
+                "%016llx-%016llx-%llu-%016llx",
+                static_cast<unsigned long long>(file),
+                static_cast<unsigned long long>(dataSet),
+                static_cast<unsigned long long>(chunk),
+                static_cast<unsigned long long>(version));
+  return name + EntryExtension;
+}
+
+bool
+HDF5ContainerLocalChunkCache::Find(const std::string & name, std::vector<unsigned char> & stored)
+{
+  const std::filesystem::path path(m_Directory / name);
+  std::ifstream               file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+    return false;
+
+  stored.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char *>(stored.data()), static_cast<std::streamsize>(stored.size())))
+    return false;
+
+  // The modification time orders entries for eviction
+  std::error_code error;
+  std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+  return true;
+}
+
+void
+HDF5ContainerLocalChunkCache::Store(const std::string & name, const std::vector<unsigned char> & stored)
+{
+  // Entries appear complete or not at all to other readers
+  std::ostringstream temporaryName;
+  temporaryName << name << "." << std::this_thread::get_id() << ".tmp";
+  const std::filesystem::path temporary(m_Directory / temporaryName.str());
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(stored.data()), static_cast<std::streamsize>(stored.size())))
+    {
+      file.close();
+      std::error_code error;
+      std::filesystem::remove(temporary, error);
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary, m_Directory / name, error);
+  if (error)
+  {
+    std::filesystem::remove(temporary, error);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Size += stored.size();
+  if (m_Size > m_Capacity)
+    this->Evict();
+}
+
+void
+HDF5ContainerLocalChunkCache::Evict()
+{
+  // Other processes may share the directory, so its size is measured
+  // again rather than trusted
+  std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+  m_Size = ScanEntries(m_Directory, &entries);
+  std::sort(entries.begin(), entries.end());
+
+  const uintmax_t target(m_Capacity / 10 * 9);
+  std::error_code error;
+  for (const auto & entry : entries)
+  {
+    if (m_Size <= target)
+      break;
+    const uintmax_t size(std::filesystem::file_size(entry.second, error));
+    if (!error && std::filesystem::remove(entry.second, error))
+      m_Size -= std::min(size, m_Size);
+  }
+}
+} // end namespace itk
@@ -0,0 +1,79 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerLocalChunkCache_h
+#define itkHDF5ContainerLocalChunkCache_h
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerLocalChunkCache
+ *
+ * \brief Persistent cache of stored chunks in a directory on local storage.
+ *
+ * Chunks are kept as read from the file, still compressed, one file per
+ * chunk named after the file, dataset, chunk index and stored chunk
+ * version, so changed chunks are never matched. Entries are written to a
+ * temporary file and renamed, so several processes can share the
+ * directory. When the directory grows over its capacity the least
+ * recently used entries, by modification time which is updated on every
+ * hit, are removed until it is under 90% of the capacity.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerLocalChunkCache
+{
+public:
+  /** The cache of a directory, created if it does not exist */
+  static HDF5ContainerLocalChunkCache &
+  GetInstance(const std::string & directory);
+
+  void
+  SetCapacity(uintmax_t bytes);
+
+  static std::string
+  GetEntryName(uint64_t file, uint64_t dataSet, uint64_t chunk, uint64_t version);
+
+  /** Read an entry, false if the directory does not hold it */
+  bool
+  Find(const std::string & name, std::vector<unsigned char> & stored);
+
+  /** Add an entry, failures only lose the entry */
+  void
+  Store(const std::string & name, const std::vector<unsigned char> & stored);
+
+private:
+  explicit HDF5ContainerLocalChunkCache(const std::filesystem::path & directory);
+
+  // Remove the least recently used entries, the lock is held
+  void
+  Evict();
+
+  std::filesystem::path m_Directory;
+  std::mutex            m_Mutex;
+  uintmax_t             m_Capacity{ uintmax_t(10) << 30 };
+  uintmax_t             m_Size{ 0 };
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerLocalChunkCache_h
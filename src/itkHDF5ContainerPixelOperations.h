@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerPixelOperations_h
+#define itkHDF5ContainerPixelOperations_h
+
+#include "itkCommonEnums.h"
+#include "itkHDF5ContainerChunkGrid.h"
+#include "itkMacro.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace itk
+{
+/** Call functor with a null pointer of the C++ type matching an ITK
+ * component type, so that generic lambdas can be instantiated for each
+ * supported type:
+ *
+ *   HDF5ContainerDispatchComponentType(type, [&](auto * tag) {
+ *     using ComponentType = std::remove_pointer_t<decltype(tag)>;
+ *     ...
+ *   });
+ */
+template <typename TFunctor>
+void
+HDF5ContainerDispatchComponentType(IOComponentEnum componentType, TFunctor && functor)
+{
+  switch (componentType)
+  {
+    case IOComponentEnum::UCHAR:
+      functor(static_cast<unsigned char *>(nullptr));
+      break;
+    case IOComponentEnum::CHAR:
+      functor(static_cast<char *>(nullptr));
+      break;
+    case IOComponentEnum::USHORT:
+      functor(static_cast<unsigned short *>(nullptr));
+      break;
+    case IOComponentEnum::SHORT:
+      functor(static_cast<short *>(nullptr));
+      break;
+    case IOComponentEnum::UINT:
+      functor(static_cast<unsigned int *>(nullptr));
+      break;
+    case IOComponentEnum::INT:
+      functor(static_cast<int *>(nullptr));
+      break;
+    case IOComponentEnum::ULONG:
+      functor(static_cast<unsigned long *>(nullptr));
+      break;
+    case IOComponentEnum::LONG:
+      functor(static_cast<long *>(nullptr));
+      break;
+    case IOComponentEnum::ULONGLONG:
+      functor(static_cast<unsigned long long *>(nullptr));
+      break;
+    case IOComponentEnum::LONGLONG:
+      functor(static_cast<long long *>(nullptr));
+      break;
+    case IOComponentEnum::FLOAT:
+      functor(static_cast<float *>(nullptr));
+      break;
+    case IOComponentEnum::DOUBLE:
+      functor(static_cast<double *>(nullptr));
+      break;
+    default:
+      itkGenericExceptionMacro(<< "unsupported IOComponentEnum" << static_cast<char>(componentType));
+  }
+}
+
+/** Bytes of a single component of the given type holding value */
+inline std::vector<unsigned char>
+HDF5ContainerComponentBytes(IOComponentEnum componentType, double value)
+{
+  std::vector<unsigned char> bytes;
+  HDF5ContainerDispatchComponentType(componentType, [&](auto * tag) {
+    using ComponentType = std::remove_pointer_t<decltype(tag)>;
+    const auto typedValue(static_cast<ComponentType>(value));
+    bytes.resize(sizeof(ComponentType));
+    std::memcpy(bytes.data(), &typedValue, sizeof(ComponentType));
+  });
+  return bytes;
+}
+
+/** True if every element of a contiguous buffer equals value. The first
+ * element is compared with value, then the buffer is compared with itself
+ * shifted by one element, which proves it is periodic. Both comparisons
+ * are memcmp calls, which the C library implements with SIMD loads and
+ * which exit on the first difference. */
+inline bool
+HDF5ContainerIsUniform(const void * data, size_t nbytes, const void * value, size_t valueSize)
+{
+  if (nbytes < valueSize)
+    return nbytes == 0;
+
+  const auto * bytes = static_cast<const unsigned char *>(data);
+  return std::memcmp(bytes, value, valueSize) == 0 && std::memcmp(bytes, bytes + valueSize, nbytes - valueSize) == 0;
+}
+
+/** True if every element of an N-D block within a row-major buffer
+ * equals value, checked one row of the fastest moving dimension at a time */
+inline bool
+HDF5ContainerIsBlockUniform(const void *                                   data,
+                            const HDF5ContainerChunkGrid::DimensionsType & dims,
+                            const HDF5ContainerChunkGrid::DimensionsType & offset,
+                            const HDF5ContainerChunkGrid::DimensionsType & count,
+                            const void *                                   value,
+                            size_t                                         valueSize)
+{
+  const size_t rank(count.size());
+  if (rank == 0)
+    return true;
+
+  const size_t                           rowBytes(count[rank - 1] * valueSize);
+  HDF5ContainerChunkGrid::DimensionsType pos(rank, 0);
+
+  for (;;)
+  {
+    size_t index(0);
+    for (size_t i = 0; i < rank; i++)
+      index = index * dims[i] + offset[i] + pos[i];
+
+    if (!HDF5ContainerIsUniform(static_cast<const char *>(data) + index * valueSize, rowBytes, value, valueSize))
+      return false;
+
+    size_t i(rank - 1);
+    while (i-- > 0)
+    {
+      if (++pos[i] < count[i])
+        break;
+      pos[i] = 0;
+    }
+    if (i == static_cast<size_t>(-1))
+      break;
+  }
+  return true;
+}
+
+/** Fill a buffer of n elements with value. A zero value is a memset,
+ * otherwise the filled prefix is doubled with memcpy. */
+inline void
+HDF5ContainerFill(void * data, size_t n, const void * value, size_t valueSize)
+{
+  if (n == 0)
+    return;
+
+  auto *       bytes = static_cast<unsigned char *>(data);
+  const auto * valueBytes = static_cast<const unsigned char *>(value);
+  const bool   isZero(valueBytes[0] == 0 && HDF5ContainerIsUniform(valueBytes, valueSize, valueBytes, 1));
+  if (isZero)
+  {
+    std::memset(bytes, 0, n * valueSize);
+    return;
+  }
+
+  const size_t total(n * valueSize);
+  std::memcpy(bytes, value, valueSize);
+  for (size_t filled = valueSize; filled < total; filled *= 2)
+    std::memcpy(bytes + filled, bytes, std::min(filled, total - filled));
+}
+
+} // end namespace itk
+
+#endif // itkHDF5ContainerPixelOperations_h
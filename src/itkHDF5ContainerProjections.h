@@ -0,0 +1,269 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerProjections_h
+#define itkHDF5ContainerProjections_h
+
+#include "itkImageIORegion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace itk
+{
+/**
+ *\class HDF5ContainerProjections
+ *
+ * \brief Running projections of an image along each of its axes.
+ *
+ * Regions are added as they are streamed. The maximum (and optionally
+ * the sum, for mean projections) of every line of pixels along each axis
+ * is updated in place, and the central slice spanned by the two fastest
+ * moving axes is captured. All dimensions are in ITK order (fastest
+ * moving first), components of vector images are projected separately
+ * and stay interleaved.
+ *
+ * \ingroup CSIROCT
+ */
+class HDF5ContainerProjections
+{
+public:
+  using DimensionsType = std::vector<ImageIORegion::SizeValueType>;
+
+  HDF5ContainerProjections(const DimensionsType & dims, unsigned int numComponents, bool useMean)
+    : m_Dimensions(dims)
+    , m_NumberOfComponents(numComponents)
+    , m_UseMean(useMean)
+    , m_Maximum(dims.size())
+    , m_Sum(dims.size())
+  {
+    for (unsigned int axis = 0; axis < dims.size(); axis++)
+    {
+      const size_t n(GetNumberOfElements(this->GetProjectionDimensions(axis)) * numComponents);
+      m_Maximum[axis].assign(n, -std::numeric_limits<double>::infinity());
+      if (useMean)
+        m_Sum[axis].assign(n, 0.0);
+    }
+    m_CentralSlice.assign(GetNumberOfElements(this->GetCentralSliceDimensions()) * numComponents, 0.0);
+  }
+
+  unsigned int
+  GetNumberOfComponents() const
+  {
+    return m_NumberOfComponents;
+  }
+
+  /** Dimensions of the projection along an axis, that is the image
+   * dimensions without the axis */
+  DimensionsType
+  GetProjectionDimensions(unsigned int axis) const
+  {
+    DimensionsType dims(m_Dimensions);
+    dims.erase(dims.begin() + axis);
+    return dims;
+  }
+
+  /** Dimensions of the central slice, the first two image dimensions */
+  DimensionsType
+  GetCentralSliceDimensions() const
+  {
+    return DimensionsType(m_Dimensions.begin(), m_Dimensions.begin() + std::min<size_t>(2, m_Dimensions.size()));
+  }
+
+  const std::vector<double> &
+  GetMaximumProjection(unsigned int axis) const
+  {
+    return m_Maximum[axis];
+  }
+
+  std::vector<double>
+  GetMeanProjection(unsigned int axis) const
+  {
+    std::vector<double> mean(m_Sum[axis]);
+    for (auto & v : mean)
+      v /= static_cast<double>(m_Dimensions[axis]);
+    return mean;
+  }
+
+  const std::vector<double> &
+  GetCentralSlice() const
+  {
+    return m_CentralSlice;
+  }
+
+  /** Add a region of the image, buffer holding its pixels */
+  template <typename TComponent>
+  void
+  Add(const TComponent * data, const ImageIORegion & region)
+  {
+    const size_t   numDims(m_Dimensions.size());
+    const size_t   nc(m_NumberOfComponents);
+    const size_t   rowLength(region.GetSize(0));
+    const size_t   numRows(rowLength > 0 ? region.GetNumberOfPixels() / rowLength : 0);
+    DimensionsType index(numDims);
+    for (size_t k = 0; k < numDims; k++)
+      index[k] = region.GetIndex(k);
+
+    for (size_t row = 0; row < numRows; row++, data += rowLength * nc)
+    {
+      // Along the fastest moving axis each row reduces to a single pixel
+      const size_t base0(this->GetProjectionOffset(0, index) * nc);
+      for (size_t c = 0; c < nc; c++)
+      {
+        double maximum(m_Maximum[0][base0 + c]), sum(0.0);
+        for (size_t i = 0; i < rowLength; i++)
+        {
+          const double v(static_cast<double>(data[i * nc + c]));
+          maximum = v > maximum ? v : maximum;
+          sum += v;
+        }
+        m_Maximum[0][base0 + c] = maximum;
+        if (m_UseMean)
+          m_Sum[0][base0 + c] += sum;
+      }
+
+      // Along the other axes the row updates a row of the projection
+      for (size_t axis = 1; axis < numDims; axis++)
+      {
+        const size_t base(this->GetProjectionOffset(axis, index) * nc);
+        double *     maximum(m_Maximum[axis].data() + base);
+        for (size_t j = 0; j < rowLength * nc; j++)
+        {
+          const double v(static_cast<double>(data[j]));
+          maximum[j] = v > maximum[j] ? v : maximum[j];
+        }
+        if (m_UseMean)
+        {
+          double * sum(m_Sum[axis].data() + base);
+          for (size_t j = 0; j < rowLength * nc; j++)
+            sum[j] += static_cast<double>(data[j]);
+        }
+      }
+
+      if (this->IsInCentralSlice(index))
+      {
+        const size_t base((index[0] + (numDims > 1 ? index[1] * m_Dimensions[0] : 0)) * nc);
+        for (size_t j = 0; j < rowLength * nc; j++)
+          m_CentralSlice[base + j] = static_cast<double>(data[j]);
+      }
+
+      // Next row of the region
+      for (size_t k = 1; k < numDims; k++)
+      {
+        if (++index[k] < region.GetIndex(k) + region.GetSize(k))
+          break;
+        index[k] = region.GetIndex(k);
+      }
+    }
+  }
+
+  /** Box filter an image down so that no dimension exceeds maxSize. The
+   * same factor is used along every dimension to keep the aspect ratio,
+   * it is returned along with the dimensions of the result */
+  static std::vector<double>
+  Downsample(const std::vector<double> & data,
+             const DimensionsType &      dims,
+             unsigned int                numComponents,
+             unsigned int                maxSize,
+             DimensionsType &            outDims,
+             size_t &                    factor)
+  {
+    const size_t maxDim(dims.empty() ? 1 : *std::max_element(dims.begin(), dims.end()));
+    factor = std::max<size_t>(1, (maxDim + maxSize - 1) / std::max<unsigned int>(maxSize, 1));
+
+    outDims.resize(dims.size());
+    for (size_t k = 0; k < dims.size(); k++)
+      outDims[k] = (dims[k] + factor - 1) / factor;
+
+    std::vector<double> sum(GetNumberOfElements(outDims) * numComponents, 0.0);
+    std::vector<size_t> count(GetNumberOfElements(outDims), 0);
+    DimensionsType      index(dims.size(), 0);
+
+    for (size_t i = 0; i < GetNumberOfElements(dims); i++)
+    {
+      size_t out(0), stride(1);
+      for (size_t k = 0; k < dims.size(); k++)
+      {
+        out += (index[k] / factor) * stride;
+        stride *= outDims[k];
+      }
+      for (size_t c = 0; c < numComponents; c++)
+        sum[out * numComponents + c] += data[i * numComponents + c];
+      count[out]++;
+
+      for (size_t k = 0; k < dims.size(); k++)
+      {
+        if (++index[k] < dims[k])
+          break;
+        index[k] = 0;
+      }
+    }
+
+    for (size_t i = 0; i < sum.size(); i++)
+      sum[i] /= static_cast<double>(std::max<size_t>(count[i / numComponents], 1));
+    return sum;
+  }
+
+  static size_t
+  GetNumberOfElements(const DimensionsType & dims)
+  {
+    size_t n(1);
+    for (auto d : dims)
+      n *= d;
+    return n;
+  }
+
+private:
+  // Offset within the projection along axis of the pixel at index
+  size_t
+  GetProjectionOffset(size_t axis, const DimensionsType & index) const
+  {
+    size_t offset(0), stride(1);
+    for (size_t k = 0; k < m_Dimensions.size(); k++)
+    {
+      if (k == axis)
+        continue;
+      offset += index[k] * stride;
+      stride *= m_Dimensions[k];
+    }
+    return offset;
+  }
+
+  bool
+  IsInCentralSlice(const DimensionsType & index) const
+  {
+    for (size_t k = 2; k < m_Dimensions.size(); k++)
+    {
+      if (index[k] != m_Dimensions[k] / 2)
+        return false;
+    }
+    return true;
+  }
+
+  DimensionsType                   m_Dimensions;
+  unsigned int                     m_NumberOfComponents;
+  bool                             m_UseMean;
+  std::vector<std::vector<double>> m_Maximum;
+  std::vector<std::vector<double>> m_Sum;
+  std::vector<double>              m_CentralSlice;
+};
+
+} // end namespace itk
+
+#endif // itkHDF5ContainerProjections_h
@@ -0,0 +1,302 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerRegionWriter.h"
+#include "itkHDF5ContainerChunkGrid.h"
+#include "itkHDF5ContainerPixelOperations.h"
+
+#include <algorithm>
+
+namespace itk
+{
+HDF5ContainerRegionWriter::HDF5ContainerRegionWriter() = default;
+
+HDF5ContainerRegionWriter::~HDF5ContainerRegionWriter()
+{
+  try
+  {
+    this->Finish();
+  }
+  catch (ExceptionObject & error)
+  {
+    itkWarningMacro(<< "Unable to finish writing: " << error.GetDescription());
+  }
+}
+
+void
+HDF5ContainerRegionWriter::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ImageIO: " << this->m_ImageIO.GetPointer() << std::endl;
+  os << indent << "MaximumQueuedBytes: " << this->m_MaximumQueuedBytes << std::endl;
+  os << indent << "NumberOfChunksWritten: " << this->m_NumberOfChunksWritten << std::endl;
+}
+
+void
+HDF5ContainerRegionWriter::Start()
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->m_ImageIO == nullptr)
+    itkExceptionMacro(<< "ImageIO is not set");
+  if (this->m_Committer.joinable())
+    itkExceptionMacro(<< "Start() was already called");
+
+  HDF5ContainerImageIO * io(this->m_ImageIO);
+  io->UseChunkingOn();
+  io->WriteImageInformation();
+
+  // The grid is built in HDF5 order from the chunk regions, as the
+  // dataset itself is private to the ImageIO
+  const unsigned int  numDims(io->GetNumberOfDimensions());
+  const unsigned int  numComponents(io->GetNumberOfComponents());
+  const ImageIORegion firstChunk(io->GetChunkRegion(0));
+  DimensionsType      dims(numDims + (numComponents > 1 ? 1 : 0)), chunkDims(dims.size());
+  for (unsigned int i = 0; i < numDims; i++)
+  {
+    dims[numDims - i - 1] = io->GetDimensions(i);
+    chunkDims[numDims - i - 1] = firstChunk.GetSize(i);
+  }
+  if (numComponents > 1)
+  {
+    dims[numDims] = numComponents;
+    chunkDims[numDims] = numComponents;
+  }
+  this->m_Grid.reset(new HDF5ContainerChunkGrid(dims, chunkDims));
+  this->m_ElementSize = io->GetComponentSize();
+
+  // The parts of a chunk never written hold the fill value of the dataset
+  this->m_FillValue = HDF5ContainerComponentBytes(io->GetComponentType(), io->GetFillValue());
+
+  this->m_PendingChunks.clear();
+  this->m_Queue.clear();
+  this->m_QueuedBytes = 0;
+  this->m_Finishing = false;
+  this->m_Failed = false;
+  this->m_Error.clear();
+  this->m_NumberOfChunksWritten = 0;
+  this->m_Committer = std::thread(&Self::Commit, this);
+}
+
+void
+HDF5ContainerRegionWriter::WriteRegion(const ImageIORegion & region, const void * buffer)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  if (this->m_Grid == nullptr)
+    itkExceptionMacro(<< "Start() must be called before WriteRegion()");
+  this->ThrowIfFailed();
+
+  const HDF5ContainerChunkGrid & grid(*this->m_Grid);
+  const size_t                   rank(grid.GetRank());
+  DimensionsType                 offset, count;
+  HDF5ContainerRegionToHyperslab(region, this->m_ImageIO->GetNumberOfComponents(), offset, count);
+  if (offset.size() != rank)
+    itkExceptionMacro(<< "Region " << region << " does not match the image dimension");
+  for (size_t i = 0; i < rank; i++)
+  {
+    if (offset[i] + count[i] > grid.GetDataSetDimensions()[i])
+      itkExceptionMacro(<< "Region " << region << " is outside the image");
+  }
+
+  const DimensionsType & chunkDims(grid.GetChunkDimensions());
+  for (auto chunk : grid.GetChunksIntersecting(offset, count))
+  {
+    DimensionsType overlapOffset, overlapCount;
+    grid.GetIntersection(chunk, offset, count, overlapOffset, overlapCount);
+
+    std::shared_ptr<PendingChunkType> pending;
+    {
+      std::lock_guard<std::mutex> lock(this->m_PendingMutex);
+
+      std::shared_ptr<PendingChunkType> & entry(this->m_PendingChunks[chunk]);
+      if (entry == nullptr)
+      {
+        entry = std::make_shared<PendingChunkType>();
+        entry->Data.resize(grid.GetChunkElements() * this->m_ElementSize);
+        HDF5ContainerFill(entry->Data.data(), grid.GetChunkElements(), this->m_FillValue.data(), this->m_ElementSize);
+        entry->NumberOfElements = 1;
+        for (auto e : grid.GetChunkExtent(chunk))
+          entry->NumberOfElements *= e;
+      }
+      pending = entry;
+    }
+
+    // Regions are disjoint, so several threads may copy into the same
+    // chunk at once
+    const DimensionsType chunkOffset(grid.GetChunkOffset(chunk));
+    DimensionsType       chunkStart(rank), bufferStart(rank);
+    SizeValueType        numOverlap(1);
+    for (size_t i = 0; i < rank; i++)
+    {
+      chunkStart[i] = overlapOffset[i] - chunkOffset[i];
+      bufferStart[i] = overlapOffset[i] - offset[i];
+      numOverlap *= overlapCount[i];
+    }
+    HDF5ContainerCopyBlock(
+      buffer, count, bufferStart, pending->Data.data(), chunkDims, chunkStart, overlapCount, this->m_ElementSize);
+
+    // The thread completing the chunk encodes it
+    if (pending->NumberOfElementsWritten.fetch_add(numOverlap) + numOverlap == pending->NumberOfElements)
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->m_PendingMutex);
+        this->m_PendingChunks.erase(chunk);
+      }
+      this->SubmitChunk(chunk, pending->Data);
+    }
+  }
+}
+
+void
+HDF5ContainerRegionWriter::SubmitChunk(SizeValueType chunk, const std::vector<unsigned char> & data)
+{
+  using DimensionsType = HDF5ContainerChunkGrid::DimensionsType;
+
+  QueuedChunkType item{ chunk, {}, true };
+  if (!this->m_ImageIO->EncodeChunk(data.data(), data.size(), item.Data))
+  {
+    // The committer writes the chunk through libhdf5, clipped to the image
+    const DimensionsType extent(this->m_Grid->GetChunkExtent(chunk));
+    const DimensionsType origin(extent.size(), 0);
+    SizeValueType        numElements(1);
+    for (auto e : extent)
+      numElements *= e;
+
+    item.Encoded = false;
+    item.Data.resize(numElements * this->m_ElementSize);
+    HDF5ContainerCopyBlock(data.data(),
+                           this->m_Grid->GetChunkDimensions(),
+                           origin,
+                           item.Data.data(),
+                           extent,
+                           origin,
+                           extent,
+                           this->m_ElementSize);
+  }
+
+  std::unique_lock<std::mutex> lock(this->m_QueueMutex);
+
+  // Back-pressure, a chunk larger than the limit is still accepted once
+  // the queue is empty
+  const SizeValueType size(item.Data.size());
+  this->m_QueueNotFull.wait(lock, [this, size] {
+    return this->m_Failed || this->m_Queue.empty() || this->m_QueuedBytes + size <= this->m_MaximumQueuedBytes;
+  });
+  if (this->m_Failed)
+    itkExceptionMacro(<< "Unable to write chunks: " << this->m_Error);
+
+  this->m_QueuedBytes += size;
+  this->m_Queue.push_back(std::move(item));
+  this->m_QueueNotEmpty.notify_one();
+}
+
+void
+HDF5ContainerRegionWriter::Commit()
+{
+  for (;;)
+  {
+    QueuedChunkType item;
+    {
+      std::unique_lock<std::mutex> lock(this->m_QueueMutex);
+      this->m_QueueNotEmpty.wait(lock, [this] { return this->m_Finishing || !this->m_Queue.empty(); });
+      if (this->m_Queue.empty())
+        return;
+      item = std::move(this->m_Queue.front());
+      this->m_Queue.pop_front();
+    }
+
+    std::string error;
+    try
+    {
+      if (item.Encoded)
+        this->m_ImageIO->WriteRawChunk(item.Chunk, item.Data);
+      else
+        this->m_ImageIO->WriteChunk(item.Chunk, item.Data.data());
+      this->m_NumberOfChunksWritten++;
+    }
+    catch (ExceptionObject & exception)
+    {
+      error = exception.GetDescription();
+    }
+    catch (std::exception & exception)
+    {
+      error = exception.what();
+    }
+
+    std::lock_guard<std::mutex> lock(this->m_QueueMutex);
+    this->m_QueuedBytes -= item.Data.size();
+    if (!error.empty() && !this->m_Failed)
+    {
+      // Chunks still queued are dropped, producers waiting are woken to
+      // throw the error
+      this->m_Failed = true;
+      this->m_Error = error;
+      this->m_Queue.clear();
+      this->m_QueuedBytes = 0;
+    }
+    this->m_QueueNotFull.notify_all();
+  }
+}
+
+void
+HDF5ContainerRegionWriter::ThrowIfFailed()
+{
+  std::lock_guard<std::mutex> lock(this->m_QueueMutex);
+  if (this->m_Failed)
+    itkExceptionMacro(<< "Unable to write chunks: " << this->m_Error);
+}
+
+void
+HDF5ContainerRegionWriter::Finish()
+{
+  if (!this->m_Committer.joinable())
+    return;
+
+  // Chunks never completed are written with the fill value in place of
+  // their missing pixels
+  std::map<SizeValueType, std::shared_ptr<PendingChunkType>> pendingChunks;
+  {
+    std::lock_guard<std::mutex> lock(this->m_PendingMutex);
+    pendingChunks.swap(this->m_PendingChunks);
+  }
+
+  std::string error;
+  try
+  {
+    for (const auto & pending : pendingChunks)
+      this->SubmitChunk(pending.first, pending.second->Data);
+  }
+  catch (ExceptionObject & exception)
+  {
+    error = exception.GetDescription();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->m_QueueMutex);
+    this->m_Finishing = true;
+    this->m_QueueNotEmpty.notify_all();
+  }
+  this->m_Committer.join();
+  this->m_Grid.reset();
+
+  this->ThrowIfFailed();
+  if (!error.empty())
+    itkExceptionMacro(<< error);
+}
+} // end namespace itk
@@ -0,0 +1,202 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerRepacker.h"
+#include "itkHDF5ContainerRegionWriter.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+void
+HDF5ContainerRepacker::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "InputImageIO: " << this->m_InputImageIO.GetPointer() << std::endl;
+  os << indent << "OutputImageIO: " << this->m_OutputImageIO.GetPointer() << std::endl;
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+  os << indent << "MaximumQueuedBytes: " << this->m_MaximumQueuedBytes << std::endl;
+}
+
+void
+HDF5ContainerRepacker::Repack()
+{
+  if (this->m_InputImageIO == nullptr)
+    itkExceptionMacro(<< "InputImageIO is not set");
+  if (this->m_OutputImageIO == nullptr)
+    itkExceptionMacro(<< "OutputImageIO is not set");
+
+  HDF5ContainerImageIO * input(this->m_InputImageIO);
+  HDF5ContainerImageIO * output(this->m_OutputImageIO);
+
+  // The input and output are set up, and the output dataset created,
+  // while holding the lock of libhdf5, which the worker threads and the
+  // writer take in turn once the tiles are read
+  std::unique_lock<std::recursive_mutex> lock(HDF5ContainerImageIO::GetLibraryMutex());
+
+  input->ReadImageInformation();
+  if (output->GetFileName() == input->GetFileName())
+    itkExceptionMacro(<< "Unable to repack " << input->GetDataSetName() << " within " << input->GetFileName());
+
+  const unsigned int numDims(input->GetNumberOfDimensions());
+  output->SetNumberOfDimensions(numDims);
+  for (unsigned int i = 0; i < numDims; i++)
+  {
+    output->SetDimensions(i, input->GetDimensions(i));
+    output->SetSpacing(i, input->GetSpacing(i));
+    output->SetOrigin(i, input->GetOrigin(i));
+    output->SetDirection(i, input->GetDirection(i));
+  }
+  output->SetNumberOfComponents(input->GetNumberOfComponents());
+  output->SetPixelType(input->GetPixelType());
+  output->SetComponentType(input->GetComponentType());
+
+  // Contiguous inputs have no chunk grid, they are read in tiles of the
+  // output chunks
+  std::vector<SizeValueType> gridSize;
+  ImageIORegion::SizeType    inputChunkSize;
+  bool                       chunked(true);
+  try
+  {
+    gridSize = input->GetChunkGridSize();
+    inputChunkSize = input->GetChunkRegion(0).GetSize();
+  }
+  catch (ExceptionObject &)
+  {
+    chunked = false;
+  }
+
+  if (!output->GetUseChunkSize() && chunked)
+  {
+    // The input chunking is kept unless a new one is given
+    output->UseChunkSizeOn();
+    output->GetChunkSize().assign(inputChunkSize.begin(), inputChunkSize.end());
+  }
+
+  const size_t pixelSize(input->GetComponentSize() * input->GetNumberOfComponents());
+
+  if (output->GetUseCompression() && output->GetUseZstdDictionary())
+  {
+    // The region writer creates the dataset before any region reaches
+    // it, the dictionary is trained from the first layer of tiles
+    // instead: those of the input chunks, or the output chunks, by
+    // default N-1 dimension slabs
+    const SizeValueType depth(input->GetDimensions(numDims - 1));
+    SizeValueType       layerDepth(1);
+    if (chunked)
+      layerDepth = inputChunkSize[numDims - 1];
+    else if (output->GetUseChunkSize())
+      layerDepth = output->GetChunkSize()[numDims - 1];
+
+    ImageIORegion layer(numDims);
+    for (unsigned int i = 0; i < numDims; i++)
+      layer.SetSize(i, input->GetDimensions(i));
+    layer.SetSize(numDims - 1, std::max<SizeValueType>(1, std::min(layerDepth, depth)));
+
+    std::vector<unsigned char> buffer(layer.GetNumberOfPixels() * pixelSize);
+    input->ReadRegion(layer, buffer.data());
+    output->TrainZstdDictionary(layer, buffer.data());
+  }
+
+  HDF5ContainerRegionWriter::Pointer writer = HDF5ContainerRegionWriter::New();
+  writer->SetImageIO(output);
+  writer->SetMaximumQueuedBytes(this->m_MaximumQueuedBytes);
+  writer->Start();
+
+  // Output chunks follow the output chunk size, or the N-1 dimension slab
+  const ImageIORegion::SizeType tileSize(chunked ? inputChunkSize : output->GetChunkRegion(0).GetSize());
+  if (!chunked)
+  {
+    gridSize.resize(numDims);
+    for (unsigned int i = 0; i < numDims; i++)
+      gridSize[i] = (input->GetDimensions(i) + tileSize[i] - 1) / tileSize[i];
+  }
+
+  SizeValueType tilesPerLayer(1);
+  for (unsigned int i = 0; i + 1 < numDims; i++)
+    tilesPerLayer *= gridSize[i];
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  if (this->m_NumberOfWorkUnits > 0)
+  {
+    threader->SetMaximumNumberOfThreads(this->m_NumberOfWorkUnits);
+    threader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  }
+
+  lock.unlock();
+
+  try
+  {
+    // A layer of tiles along the slowest axis at a time, so the output
+    // chunks pending in the writer are completed as the layers advance
+    for (SizeValueType layer = 0; layer < gridSize[numDims - 1]; layer++)
+    {
+      threader->ParallelizeArray(
+        0,
+        tilesPerLayer,
+        [&](SizeValueType i) {
+          // Tiles are ordered with the fastest moving dimension varying
+          // fastest, edge tiles are clipped to the image
+          const SizeValueType tile(layer * tilesPerLayer + i);
+          ImageIORegion       region(numDims);
+          SizeValueType       remainder(tile);
+          for (unsigned int j = 0; j < numDims; j++)
+          {
+            const SizeValueType dim(input->GetDimensions(j));
+            const SizeValueType index(remainder % gridSize[j] * tileSize[j]);
+            remainder /= gridSize[j];
+
+            region.SetIndex(j, static_cast<IndexValueType>(index));
+            region.SetSize(j, std::min<SizeValueType>(tileSize[j], dim - index));
+          }
+
+          std::vector<unsigned char> buffer(region.GetNumberOfPixels() * pixelSize);
+          if (chunked)
+            input->ReadChunk(tile, buffer.data());
+          else
+            input->ReadRegion(region, buffer.data());
+
+          writer->WriteRegion(region, buffer.data());
+        },
+        nullptr);
+    }
+    writer->Finish();
+
+    // The metadata of the input path is rewritten as it was
+    lock.lock();
+    input->CopyMetaData(output);
+  }
+  catch (ExceptionObject &)
+  {
+    // The writer is stopped before the error is passed on
+    if (lock.owns_lock())
+      lock.unlock();
+    try
+    {
+      writer->Finish();
+    }
+    catch (ExceptionObject &)
+    {
+    }
+    throw;
+  }
+}
+} // end namespace itk
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerSliceIngester.h"
+#include "itkHDF5ContainerRegionWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+void
+HDF5ContainerSliceIngester::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileNames: " << this->m_FileNames.size() << std::endl;
+  os << indent << "OutputImageIO: " << this->m_OutputImageIO.GetPointer() << std::endl;
+  os << indent << "SliceSpacing: " << this->m_SliceSpacing << std::endl;
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+  os << indent << "MaximumQueuedBytes: " << this->m_MaximumQueuedBytes << std::endl;
+}
+
+void
+HDF5ContainerSliceIngester::Ingest()
+{
+  if (this->m_FileNames.empty())
+    itkExceptionMacro(<< "FileNames is empty");
+  if (this->m_OutputImageIO == nullptr)
+    itkExceptionMacro(<< "OutputImageIO is not set");
+
+  HDF5ContainerImageIO * output(this->m_OutputImageIO);
+
+  // A new ImageIO for each slice, as ImageIOs are not shared by threads
+  const auto openSlice = [this](const std::string & fileName) {
+    ImageIOBase::Pointer io(this->m_SliceImageIOFunction
+                              ? this->m_SliceImageIOFunction(fileName)
+                              : ImageIOFactory::CreateImageIO(fileName.c_str(), IOFileModeEnum::ReadMode));
+    if (io == nullptr)
+      itkGenericExceptionMacro(<< "No ImageIO can read " << fileName);
+    io->SetFileName(fileName);
+    io->ReadImageInformation();
+
+    // Slices are 2D, or have a single pixel along any further dimension
+    for (unsigned int i = 2; i < io->GetNumberOfDimensions(); i++)
+    {
+      if (io->GetDimensions(i) != 1)
+        itkGenericExceptionMacro(<< fileName << " is not a slice");
+    }
+    return io;
+  };
+
+  const ImageIOBase::Pointer first(openSlice(this->m_FileNames[0]));
+  const SizeValueType        width(first->GetDimensions(0));
+  const SizeValueType        height(first->GetNumberOfDimensions() > 1 ? first->GetDimensions(1) : 1);
+  const SizeValueType        numSlices(this->m_FileNames.size());
+
+  output->SetNumberOfDimensions(3);
+  output->SetDimensions(0, width);
+  output->SetDimensions(1, height);
+  output->SetDimensions(2, numSlices);
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    const bool                inPlane(i < first->GetNumberOfDimensions());
+    std::vector<double>       direction(3, 0.0);
+    const std::vector<double> sliceDirection(inPlane ? first->GetDirection(i) : std::vector<double>());
+    for (unsigned int j = 0; j < 2 && j < sliceDirection.size(); j++)
+      direction[j] = sliceDirection[j];
+    if (!inPlane)
+      direction[i] = 1.0;
+
+    output->SetSpacing(i, inPlane ? first->GetSpacing(i) : 1.0);
+    output->SetOrigin(i, inPlane ? first->GetOrigin(i) : 0.0);
+    output->SetDirection(i, direction);
+  }
+  output->SetSpacing(2, this->m_SliceSpacing);
+  output->SetOrigin(2, 0.0);
+  output->SetDirection(2, std::vector<double>{ 0.0, 0.0, 1.0 });
+  output->SetPixelType(first->GetPixelType());
+  output->SetComponentType(first->GetComponentType());
+  output->SetNumberOfComponents(first->GetNumberOfComponents());
+
+  const size_t sliceBytes(width * height * first->GetComponentSize() * first->GetNumberOfComponents());
+
+  // Reads a slice checked against the first into a buffer of sliceBytes
+  const auto readSlice = [&](SizeValueType slice, void * buffer) {
+    const std::string &  fileName(this->m_FileNames[slice]);
+    ImageIOBase::Pointer io(openSlice(fileName));
+    if (io->GetDimensions(0) != width || (io->GetNumberOfDimensions() > 1 ? io->GetDimensions(1) : 1) != height ||
+        io->GetComponentType() != first->GetComponentType() ||
+        io->GetNumberOfComponents() != first->GetNumberOfComponents())
+      itkGenericExceptionMacro(<< fileName << " does not match the pixels or dimensions of " << this->m_FileNames[0]);
+
+    ImageIORegion sliceRegion(io->GetNumberOfDimensions());
+    for (unsigned int i = 0; i < io->GetNumberOfDimensions(); i++)
+      sliceRegion.SetSize(i, io->GetDimensions(i));
+    io->SetIORegion(sliceRegion);
+    io->Read(buffer);
+  };
+
+  if (output->GetUseCompression() && output->GetUseZstdDictionary())
+  {
+    // The region writer creates the dataset before any slice reaches it,
+    // the dictionary is trained from the first slab of chunks instead
+    SizeValueType depth(1);
+    if (output->GetUseChunkSize() && output->GetChunkSize().size() == 3)
+      depth = std::max<SizeValueType>(1, std::min<SizeValueType>(output->GetChunkSize()[2], numSlices));
+
+    ImageIORegion slab(3);
+    slab.SetSize(0, width);
+    slab.SetSize(1, height);
+    slab.SetSize(2, depth);
+
+    std::vector<unsigned char> buffer(depth * sliceBytes);
+    for (SizeValueType slice = 0; slice < depth; slice++)
+      readSlice(slice, buffer.data() + slice * sliceBytes);
+    output->TrainZstdDictionary(slab, buffer.data());
+  }
+
+  HDF5ContainerRegionWriter::Pointer writer = HDF5ContainerRegionWriter::New();
+  writer->SetImageIO(output);
+  writer->SetMaximumQueuedBytes(this->m_MaximumQueuedBytes);
+  writer->Start();
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  if (this->m_NumberOfWorkUnits > 0)
+  {
+    threader->SetMaximumNumberOfThreads(this->m_NumberOfWorkUnits);
+    threader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  }
+
+  // Batches of whole chunk slabs, with a slice for every work unit
+  const SizeValueType slabDepth(output->GetChunkRegion(0).GetSize(2));
+  const SizeValueType numWorkUnits(std::max<SizeValueType>(1, threader->GetNumberOfWorkUnits()));
+  const SizeValueType batchSize(((numWorkUnits + slabDepth - 1) / slabDepth) * slabDepth);
+
+  try
+  {
+    for (SizeValueType batch = 0; batch < numSlices; batch += batchSize)
+    {
+      threader->ParallelizeArray(
+        batch,
+        std::min(batch + batchSize, numSlices),
+        [&](SizeValueType slice) {
+          std::vector<unsigned char> buffer(sliceBytes);
+          readSlice(slice, buffer.data());
+
+          ImageIORegion region(3);
+          region.SetSize(0, width);
+          region.SetSize(1, height);
+          region.SetSize(2, 1);
+          region.SetIndex(2, static_cast<IndexValueType>(slice));
+          writer->WriteRegion(region, buffer.data());
+        },
+        nullptr);
+    }
+    writer->Finish();
+  }
+  catch (ExceptionObject &)
+  {
+    // The writer is stopped before the error is passed on
+    try
+    {
+      writer->Finish();
+    }
+    catch (ExceptionObject &)
+    {
+    }
+    throw;
+  }
+}
+} // end namespace itk
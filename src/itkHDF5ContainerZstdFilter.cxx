@@ -0,0 +1,421 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerZstdFilter.h"
+#include "itkMacro.h"
+#include "itk_H5Cpp.h"
+
+#include <cstring>
+
+#ifdef HDF5Container_USE_ZSTD
+#  include <zdict.h>
+#  include <zstd.h>
+
+#  include <map>
+#  include <memory>
+#  include <mutex>
+#endif
+
+namespace itk
+{
+#ifdef HDF5Container_USE_ZSTD
+namespace
+{
+// A registered dictionary, the digested forms are created on demand and
+// shared by all threads. Callers hold a reference while they use one, so
+// a dictionary released by its last owner remains valid until they finish
+struct ZstdDictionary
+{
+  std::vector<unsigned char>  data;
+  ZSTD_DDict *                ddict{ nullptr };
+  std::map<int, ZSTD_CDict *> cdicts;
+
+  ~ZstdDictionary()
+  {
+    ZSTD_freeDDict(ddict);
+    for (auto & it : cdicts)
+      ZSTD_freeCDict(it.second);
+  }
+};
+
+// Dictionaries are counted by the number of AddDictionary() and
+// AcquireDictionary() calls not yet matched by ReleaseDictionary()
+struct ZstdDictionaryEntry
+{
+  std::shared_ptr<ZstdDictionary> dictionary;
+  size_t                          references{ 0 };
+};
+
+std::mutex                                   dictionaryMutex;
+std::map<unsigned int, ZstdDictionaryEntry> dictionaries;
+
+std::shared_ptr<ZstdDictionary>
+FindDictionary(unsigned int dictionaryId)
+{
+  std::lock_guard<std::mutex> lock(dictionaryMutex);
+  auto                        it = dictionaries.find(dictionaryId);
+  return it == dictionaries.end() ? nullptr : it->second.dictionary;
+}
+
+const ZSTD_CDict *
+GetCDict(const std::shared_ptr<ZstdDictionary> & dictionary, int level)
+{
+  std::lock_guard<std::mutex> lock(dictionaryMutex);
+  ZSTD_CDict *&               cdict = dictionary->cdicts[level];
+  if (cdict == nullptr)
+    cdict = ZSTD_createCDict(dictionary->data.data(), dictionary->data.size(), level);
+  return cdict;
+}
+
+// Compression contexts are expensive to create, keep one per thread
+ZSTD_CCtx *
+GetCCtx()
+{
+  thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx *)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+  return cctx.get();
+}
+
+ZSTD_DCtx *
+GetDCtx()
+{
+  thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx *)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+  return dctx.get();
+}
+
+// The HDF5 filter callback, errors are reported by returning 0 as
+// exceptions must not propagate through libhdf5
+size_t
+ZstdFilterFunction(unsigned int flags,
+                   int          level,
+                   unsigned int dictionaryId,
+                   size_t       nbytes,
+                   size_t *     buf_size,
+                   void **      buf)
+{
+  try
+  {
+    if (flags & H5Z_FLAG_REVERSE)
+    {
+      const size_t outSize(HDF5ContainerZstdFilter::GetDecompressedSize(*buf, nbytes));
+      void *       outBuf(H5allocate_memory(outSize, false));
+      if (outBuf == nullptr)
+        return 0;
+
+      const size_t n(HDF5ContainerZstdFilter::Decompress(*buf, nbytes, dictionaryId, outBuf, outSize));
+      H5free_memory(*buf);
+      *buf = outBuf;
+      *buf_size = outSize;
+      return n;
+    }
+
+    std::vector<unsigned char> compressed;
+    HDF5ContainerZstdFilter::Compress(*buf, nbytes, level, dictionaryId, compressed);
+
+    void * outBuf(H5allocate_memory(compressed.size(), false));
+    if (outBuf == nullptr)
+      return 0;
+    std::memcpy(outBuf, compressed.data(), compressed.size());
+    H5free_memory(*buf);
+    *buf = outBuf;
+    *buf_size = compressed.size();
+    return compressed.size();
+  }
+  catch (...)
+  {
+    return 0;
+  }
+}
+
+// The client data of the registered Zstandard filter is the level alone,
+// as written and expected by the standard plugin
+size_t
+ZstdStandardFilterFunction(unsigned int       flags,
+                           size_t             cd_nelmts,
+                           const unsigned int cd_values[],
+                           size_t             nbytes,
+                           size_t *           buf_size,
+                           void **            buf)
+{
+  const int level(cd_nelmts > 0 ? static_cast<int>(cd_values[0]) : ZSTD_CLEVEL_DEFAULT);
+  return ZstdFilterFunction(flags, level, 0, nbytes, buf_size, buf);
+}
+
+size_t
+ZstdDictionaryFilterFunction(unsigned int       flags,
+                             size_t             cd_nelmts,
+                             const unsigned int cd_values[],
+                             size_t             nbytes,
+                             size_t *           buf_size,
+                             void **            buf)
+{
+  const int          level(cd_nelmts > 0 ? static_cast<int>(cd_values[0]) : ZSTD_CLEVEL_DEFAULT);
+  const unsigned int dictionaryId(cd_nelmts > 1 ? cd_values[1] : 0);
+  return ZstdFilterFunction(flags, level, dictionaryId, nbytes, buf_size, buf);
+}
+
+const H5Z_class2_t ZstdFilterClass = { H5Z_CLASS_T_VERS,
+                                       static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::FilterId),
+                                       1,
+                                       1,
+                                       "Zstandard",
+                                       nullptr,
+                                       nullptr,
+                                       ZstdStandardFilterFunction };
+
+const H5Z_class2_t ZstdDictionaryFilterClass = { H5Z_CLASS_T_VERS,
+                                                 static_cast<H5Z_filter_t>(HDF5ContainerZstdFilter::DictionaryFilterId),
+                                                 1,
+                                                 1,
+                                                 "Zstandard with dictionary (HDF5Container)",
+                                                 nullptr,
+                                                 nullptr,
+                                                 ZstdDictionaryFilterFunction };
+} // namespace
+#endif
+
+bool
+HDF5ContainerZstdFilter::IsAvailable()
+{
+#ifdef HDF5Container_USE_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+int
+HDF5ContainerZstdFilter::GetMaximumLevel()
+{
+#ifdef HDF5Container_USE_ZSTD
+  return ZSTD_maxCLevel();
+#else
+  return 0;
+#endif
+}
+
+void
+HDF5ContainerZstdFilter::Register()
+{
+#ifdef HDF5Container_USE_ZSTD
+  static std::once_flag registered;
+  std::call_once(registered, []() {
+    if (H5Zregister(&ZstdFilterClass) < 0 || H5Zregister(&ZstdDictionaryFilterClass) < 0)
+      itkGenericExceptionMacro(<< "Unable to register the Zstandard HDF5 filters");
+  });
+#else
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+std::vector<unsigned char>
+HDF5ContainerZstdFilter::TrainDictionary(const std::vector<unsigned char> & samples,
+                                         const std::vector<size_t> &        sampleSizes,
+                                         size_t                             capacity)
+{
+#ifdef HDF5Container_USE_ZSTD
+  std::vector<unsigned char> dictionary(capacity);
+
+  const size_t dictionarySize(ZDICT_trainFromBuffer(dictionary.data(),
+                                                    dictionary.size(),
+                                                    samples.data(),
+                                                    sampleSizes.data(),
+                                                    static_cast<unsigned int>(sampleSizes.size())));
+
+  // Training fails when there are too few samples, the caller falls back
+  // to compressing without a dictionary in that case
+  if (ZDICT_isError(dictionarySize))
+    return std::vector<unsigned char>();
+
+  dictionary.resize(dictionarySize);
+  return dictionary;
+#else
+  (void)samples;
+  (void)sampleSizes;
+  (void)capacity;
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+unsigned int
+HDF5ContainerZstdFilter::GetDictionaryId(const std::vector<unsigned char> & dictionary)
+{
+#ifdef HDF5Container_USE_ZSTD
+  return ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+#else
+  (void)dictionary;
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+void
+HDF5ContainerZstdFilter::AddDictionary(const std::vector<unsigned char> & dictionary)
+{
+#ifdef HDF5Container_USE_ZSTD
+  const unsigned int dictionaryId(GetDictionaryId(dictionary));
+  if (dictionaryId == 0)
+    itkGenericExceptionMacro(<< "Invalid Zstandard dictionary");
+
+  std::lock_guard<std::mutex> lock(dictionaryMutex);
+  ZstdDictionaryEntry &       entry = dictionaries[dictionaryId];
+  if (entry.dictionary == nullptr)
+  {
+    auto dict = std::make_shared<ZstdDictionary>();
+    dict->data = dictionary;
+    dict->ddict = ZSTD_createDDict(dict->data.data(), dict->data.size());
+    if (dict->ddict == nullptr)
+    {
+      dictionaries.erase(dictionaryId);
+      itkGenericExceptionMacro(<< "Unable to load Zstandard dictionary " << dictionaryId);
+    }
+    entry.dictionary = std::move(dict);
+  }
+  entry.references++;
+#else
+  (void)dictionary;
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+bool
+HDF5ContainerZstdFilter::AcquireDictionary(unsigned int dictionaryId)
+{
+#ifdef HDF5Container_USE_ZSTD
+  std::lock_guard<std::mutex> lock(dictionaryMutex);
+  auto                        it = dictionaries.find(dictionaryId);
+  if (it == dictionaries.end())
+    return false;
+  it->second.references++;
+  return true;
+#else
+  (void)dictionaryId;
+  return false;
+#endif
+}
+
+void
+HDF5ContainerZstdFilter::ReleaseDictionary(unsigned int dictionaryId)
+{
+#ifdef HDF5Container_USE_ZSTD
+  std::lock_guard<std::mutex> lock(dictionaryMutex);
+  auto                        it = dictionaries.find(dictionaryId);
+  if (it != dictionaries.end() && --it->second.references == 0)
+    dictionaries.erase(it);
+#else
+  (void)dictionaryId;
+#endif
+}
+
+bool
+HDF5ContainerZstdFilter::HasDictionary(unsigned int dictionaryId)
+{
+#ifdef HDF5Container_USE_ZSTD
+  return FindDictionary(dictionaryId) != nullptr;
+#else
+  (void)dictionaryId;
+  return false;
+#endif
+}
+
+void
+HDF5ContainerZstdFilter::Compress(const void *                 src,
+                                  size_t                       nbytes,
+                                  int                          level,
+                                  unsigned int                 dictionaryId,
+                                  std::vector<unsigned char> & dst)
+{
+#ifdef HDF5Container_USE_ZSTD
+  dst.resize(ZSTD_compressBound(nbytes));
+
+  size_t n;
+  if (dictionaryId != 0)
+  {
+    const std::shared_ptr<ZstdDictionary> dict(FindDictionary(dictionaryId));
+    if (dict == nullptr)
+      itkGenericExceptionMacro(<< "Zstandard dictionary " << dictionaryId << " has not been loaded");
+    const ZSTD_CDict * cdict(GetCDict(dict, level));
+    if (cdict == nullptr)
+      itkGenericExceptionMacro(<< "Unable to digest Zstandard dictionary " << dictionaryId);
+    n = ZSTD_compress_usingCDict(GetCCtx(), dst.data(), dst.size(), src, nbytes, cdict);
+  }
+  else
+  {
+    n = ZSTD_compressCCtx(GetCCtx(), dst.data(), dst.size(), src, nbytes, level);
+  }
+
+  if (ZSTD_isError(n))
+    itkGenericExceptionMacro(<< "Zstandard compression failed: " << ZSTD_getErrorName(n));
+  dst.resize(n);
+#else
+  (void)src;
+  (void)nbytes;
+  (void)level;
+  (void)dictionaryId;
+  (void)dst;
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+size_t
+HDF5ContainerZstdFilter::Decompress(const void * src,
+                                    size_t       nbytes,
+                                    unsigned int dictionaryId,
+                                    void *       dst,
+                                    size_t       capacity)
+{
+#ifdef HDF5Container_USE_ZSTD
+  size_t n;
+  if (dictionaryId != 0)
+  {
+    const std::shared_ptr<ZstdDictionary> dict(FindDictionary(dictionaryId));
+    if (dict == nullptr)
+      itkGenericExceptionMacro(<< "Zstandard dictionary " << dictionaryId << " has not been loaded");
+    n = ZSTD_decompress_usingDDict(GetDCtx(), dst, capacity, src, nbytes, dict->ddict);
+  }
+  else
+  {
+    n = ZSTD_decompressDCtx(GetDCtx(), dst, capacity, src, nbytes);
+  }
+
+  if (ZSTD_isError(n))
+    itkGenericExceptionMacro(<< "Zstandard decompression failed: " << ZSTD_getErrorName(n));
+  return n;
+#else
+  (void)src;
+  (void)nbytes;
+  (void)dictionaryId;
+  (void)dst;
+  (void)capacity;
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+size_t
+HDF5ContainerZstdFilter::GetDecompressedSize(const void * src, size_t nbytes)
+{
+#ifdef HDF5Container_USE_ZSTD
+  const unsigned long long n(ZSTD_getFrameContentSize(src, nbytes));
+  if (n == ZSTD_CONTENTSIZE_ERROR || n == ZSTD_CONTENTSIZE_UNKNOWN)
+    itkGenericExceptionMacro(<< "Invalid Zstandard frame");
+  return static_cast<size_t>(n);
+#else
+  (void)src;
+  (void)nbytes;
+  itkGenericExceptionMacro(<< "HDF5Container was built without Zstandard support");
+#endif
+}
+
+} // end namespace itk
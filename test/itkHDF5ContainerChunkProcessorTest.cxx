@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerChunkProcessor.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <algorithm>
+
+// Process a compressed, chunked image into a float image, with and without
+// a halo. With a halo each output pixel is the sum of its neighbours along
+// x, clamped at the image edges
+int
+HDF5ContainerChunkProcessorTest(const char * inputFileName, const char * outputFileName, unsigned int halo)
+{
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+  using OutputImageType = itk::Image<float, 3>;
+
+  ImageType::Pointer          image = itk::HDF5ContainerTestHelper::CreateImage(50, 37, 23);
+  const ImageType::RegionType region(image->GetLargestPossibleRegion());
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkingOn();
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 8 };
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(inputFileName);
+  writer->SetInput(image);
+
+  itk::HDF5ContainerImageIO::Pointer input = itk::HDF5ContainerImageIO::New();
+  input->SetFileName(inputFileName);
+  itk::HDF5ContainerImageIO::Pointer output = itk::HDF5ContainerImageIO::New();
+  output->SetFileName(outputFileName);
+  output->SetComponentType(itk::IOComponentEnum::FLOAT);
+
+  itk::HDF5ContainerChunkProcessor::Pointer processor = itk::HDF5ContainerChunkProcessor::New();
+  processor->SetInputImageIO(input);
+  processor->SetOutputImageIO(output);
+  processor->SetHalo(halo);
+  processor->SetChunkFunction([halo](const itk::ImageIORegion & inputRegion,
+                                     const void *                inputBuffer,
+                                     const itk::ImageIORegion &  outputRegion,
+                                     void *                      outputBuffer) {
+    const auto * in = static_cast<const unsigned short *>(inputBuffer);
+    auto *       out = static_cast<float *>(outputBuffer);
+
+    auto at = [&](long x, long y, long z) {
+      x = std::min(std::max(x, inputRegion.GetIndex(0)), inputRegion.GetIndex(0) + long(inputRegion.GetSize(0)) - 1);
+      return static_cast<float>(in[(x - inputRegion.GetIndex(0)) +
+                                   inputRegion.GetSize(0) * ((y - inputRegion.GetIndex(1)) +
+                                                             inputRegion.GetSize(1) * (z - inputRegion.GetIndex(2)))]);
+    };
+
+    for (long z = outputRegion.GetIndex(2); z < outputRegion.GetIndex(2) + long(outputRegion.GetSize(2)); z++)
+      for (long y = outputRegion.GetIndex(1); y < outputRegion.GetIndex(1) + long(outputRegion.GetSize(1)); y++)
+        for (long x = outputRegion.GetIndex(0); x < outputRegion.GetIndex(0) + long(outputRegion.GetSize(0)); x++)
+          *out++ = halo > 0 ? at(x - 1, y, z) + at(x + 1, y, z) : 0.5f * at(x, y, z);
+  });
+
+  using ReaderType = itk::ImageFileReader<OutputImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(outputFileName);
+
+  try
+  {
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    processor->Process();
+    processor = itk::HDF5ContainerChunkProcessor::Pointer();
+    output = itk::HDF5ContainerImageIO::Pointer();
+    input = itk::HDF5ContainerImageIO::Pointer();
+
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerChunkProcessorTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<OutputImageType> rit(reader->GetOutput(), region);
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    ImageType::IndexType idx(rit.GetIndex()), left(idx), right(idx);
+    left[0] = std::max<long>(idx[0] - 1, 0);
+    right[0] = std::min<long>(idx[0] + 1, 49);
+
+    const float expected(halo > 0 ? float(image->GetPixel(left)) + float(image->GetPixel(right))
+                                  : 0.5f * float(image->GetPixel(idx)));
+    if (rit.Get() != expected)
+    {
+      std::cout << "Pixel " << idx << " is " << rit.Get() << ", expected " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::IOTestHelper::Remove(inputFileName);
+  itk::IOTestHelper::Remove(outputFileName);
+
+  return EXIT_SUCCESS;
+}
+
+int
+itkHDF5ContainerChunkProcessorTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  int result(0);
+  result += HDF5ContainerChunkProcessorTest("ChunkProcessorInput.hdf5", "ChunkProcessorOutput.hdf5", 0);
+  result += HDF5ContainerChunkProcessorTest("ChunkProcessorHaloInput.hdf5", "ChunkProcessorHaloOutput.hdf5", 1);
+  return result != 0;
+}
@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+int
+itkHDF5ContainerImageIOCheckpointTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("Checkpoint.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer          image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+  const ImageType::RegionType region(image->GetLargestPossibleRegion());
+
+  itksys::SystemTools::RemoveFile(fileName);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    // Write slices 0 to 19 of 40 and stop, which completes the first two
+    // layers of chunks and part of the third
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(fileName);
+    itk::HDF5ContainerTestHelper::SetImageInformation(io, 64, 48, 40);
+    io->UseCompressionOn();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 8 };
+    io->UseCheckpointsOn();
+    io->SetCheckpointInterval(0.0);
+    io->WriteImageInformation();
+
+    for (itk::IndexValueType z = 0; z < 20; z += 5)
+    {
+      const itk::ImageIORegion slab(itk::HDF5ContainerTestHelper::Slab(z, 5));
+      io->SetIORegion(slab);
+      io->Write(image->GetBufferPointer() + z * 64 * 48);
+    }
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer checkpointIO = itk::HDF5ContainerImageIO::New();
+    checkpointIO->SetFileName(fileName);
+    if (!checkpointIO->ReadCheckpoint() ||
+        !checkpointIO->IsRegionCompleted(itk::HDF5ContainerTestHelper::Slab(0, 16)) ||
+        checkpointIO->IsRegionCompleted(itk::HDF5ContainerTestHelper::Slab(16, 8)) ||
+        checkpointIO->IsRegionCompleted(itk::HDF5ContainerTestHelper::Slab(24, 16)))
+    {
+      std::cout << "The checkpoint does not record slices 0 to 15 as the only ones completed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    checkpointIO = itk::HDF5ContainerImageIO::Pointer();
+
+    // Resume with other values in the completed slices, which must be
+    // skipped
+    ImageType::RegionType completed(region);
+    completed.SetSize(2, 16);
+    itk::ImageRegionIteratorWithIndex<ImageType> cit(image, completed);
+    for (cit.GoToBegin(); !cit.IsAtEnd(); ++cit)
+    {
+      cit.Set(0);
+    }
+    image->Modified();
+
+    itk::HDF5ContainerImageIO::Pointer resumeIO = itk::HDF5ContainerImageIO::New();
+    resumeIO->UseCompressionOn();
+    resumeIO->UseCheckpointsOn();
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(resumeIO);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetNumberOfStreamDivisions(5);
+    writer->Write();
+    writer = WriterType::Pointer();
+    resumeIO = itk::HDF5ContainerImageIO::Pointer();
+
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOCheckpointTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+  reader = ReaderType::Pointer();
+
+  // The checkpoint of a complete dataset is removed, writing it again
+  // with checkpoints writes every region rather than resuming
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer checkpointIO = itk::HDF5ContainerImageIO::New();
+    checkpointIO->SetFileName(fileName);
+    if (checkpointIO->ReadCheckpoint())
+    {
+      std::cout << "The checkpoint was kept once the dataset was complete" << std::endl;
+      return EXIT_FAILURE;
+    }
+    checkpointIO = itk::HDF5ContainerImageIO::Pointer();
+
+    image->FillBuffer(5);
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->OverwriteOn();
+    io->UseCompressionOn();
+    io->UseCheckpointsOn();
+    itk::HDF5ContainerTestHelper::WriteImage(image.GetPointer(), io, fileName, 5);
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOCheckpointTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), region);
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    if (rit.Get() != 5)
+    {
+      std::cout << "Pixel " << rit.GetIndex() << " is " << rit.Get() << " after the second write, expected 5"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  reader = ReaderType::Pointer();
+
+  // Statistics and projections can't be gathered when resuming, as the
+  // regions written before the interruption are not seen again
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(fileName);
+    io->ReCreateOn();
+    itk::HDF5ContainerTestHelper::SetImageInformation(io, 64, 48, 40);
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 8 };
+    io->UseCheckpointsOn();
+    io->WriteImageInformation();
+    io->SetIORegion(itk::HDF5ContainerTestHelper::Slab(0, 8));
+    io->Write(image->GetBufferPointer());
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOCheckpointTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::HDF5ContainerImageIO::Pointer resumeIO = itk::HDF5ContainerImageIO::New();
+  resumeIO->UseCheckpointsOn();
+  resumeIO->UseImageStatisticsOn();
+  try
+  {
+    itk::HDF5ContainerTestHelper::WriteImage(image.GetPointer(), resumeIO, fileName, 5);
+    std::cout << "Resuming with UseImageStatistics did not throw" << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const itk::ExceptionObject &)
+  {
+  }
+  resumeIO = itk::HDF5ContainerImageIO::Pointer();
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
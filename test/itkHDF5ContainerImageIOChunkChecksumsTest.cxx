@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileWriter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+int
+itkHDF5ContainerImageIOChunkChecksumsTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("ChunkChecksums.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+
+  // Two pixels of the chunk at 32,16,8 mark where it is stored in the
+  // file, the chunks are not compressed
+  const unsigned short marker[2] = { 54321, 12345 };
+  ImageType::IndexType markerIndex = { { 40, 20, 10 } };
+  image->SetPixel(markerIndex, marker[0]);
+  markerIndex[0]++;
+  image->SetPixel(markerIndex, marker[1]);
+
+  itksys::SystemTools::RemoveFile(fileName);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 8 };
+    io->UseChunkChecksumsOn();
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetNumberOfStreamDivisions(4);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(fileName);
+    io->ReadImageInformation();
+    if (!io->VerifyDataSet().empty())
+    {
+      std::cout << "Chunks reported corrupt after writing" << std::endl;
+      return EXIT_FAILURE;
+    }
+    io = itk::HDF5ContainerImageIO::Pointer();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOChunkChecksumsTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Flip a bit of the marker
+  {
+    std::fstream                file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    std::vector<char>           contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const char *                markerBytes(reinterpret_cast<const char *>(marker));
+    std::vector<char>::iterator found(
+      std::search(contents.begin(), contents.end(), markerBytes, markerBytes + sizeof(marker)));
+    if (found == contents.end())
+    {
+      std::cout << "Marker not found in " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+    file.clear();
+    file.seekp(found - contents.begin());
+    file.put(static_cast<char>(*found ^ 0x10));
+  }
+
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(fileName);
+    io->ReadImageInformation();
+
+    const std::vector<itk::ImageIORegion> corrupt(io->VerifyDataSet());
+    if (corrupt.size() != 1 || corrupt[0].GetIndex(0) != 32 || corrupt[0].GetIndex(1) != 16 ||
+        corrupt[0].GetIndex(2) != 8)
+    {
+      std::cout << "Expected the chunk at 32,16,8 only to be reported corrupt, " << corrupt.size()
+                << " chunks reported" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Reading it with checksums on fails
+    io->UseChunkChecksumsOn();
+    io->ReadImageInformation();
+    std::vector<unsigned short> buffer(16 * 16 * 8);
+    bool                        caught(false);
+    try
+    {
+      io->ReadChunk(18, buffer.data());
+    }
+    catch (const itk::ExceptionObject &)
+    {
+      caught = true;
+    }
+    if (!caught)
+    {
+      std::cout << "Reading the corrupt chunk did not throw" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOChunkChecksumsTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
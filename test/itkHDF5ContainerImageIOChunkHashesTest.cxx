@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+int
+itkHDF5ContainerImageIOChunkHashesTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("ChunkHashes.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer          image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+  const ImageType::RegionType region(image->GetLargestPossibleRegion());
+
+  itksys::SystemTools::RemoveFile(fileName);
+
+  // The image is 4x3x5 chunks, streamed in 5 slabs one chunk deep
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    for (int pass = 0; pass < 3; pass++)
+    {
+      // The last pass changes a single chunk
+      if (pass == 2)
+      {
+        ImageType::IndexType index = { { 16, 0, 8 } };
+        image->SetPixel(index, 12345);
+        image->Modified();
+      }
+
+      itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+      io->UseCompressionOn();
+      io->UseChunkSizeOn();
+      io->GetChunkSize() = { 16, 16, 8 };
+      io->UseChunkHashesOn();
+      io->SetUseUpdate(pass > 0);
+
+      WriterType::Pointer writer = WriterType::New();
+      writer->SetImageIO(io);
+      writer->SetFileName(fileName);
+      writer->SetInput(image);
+      writer->SetNumberOfStreamDivisions(5);
+      writer->Write();
+
+      const itk::SizeValueType expected[3] = { 0, 60, 59 };
+      if (io->GetNumberOfChunksSkipped() != expected[pass])
+      {
+        std::cout << "Pass " << pass << " skipped " << io->GetNumberOfChunksSkipped() << " chunks, expected "
+                  << expected[pass] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOChunkHashesTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), region);
+  itk::ImageRegionIteratorWithIndex<ImageType> eit(image, region);
+  for (rit.GoToBegin(), eit.GoToBegin(); !rit.IsAtEnd(); ++rit, ++eit)
+  {
+    if (rit.Get() != eit.Get())
+    {
+      std::cout << "Pixel " << rit.GetIndex() << " is " << rit.Get() << ", expected " << eit.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,225 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkMetaDataObject.h"
+
+int
+itkHDF5ContainerImageIOChunkStatisticsTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  using ImageType = itk::Image<short, 3>;
+  const char * fileName("ChunkStatisticsImage.hdf5");
+
+  ImageType::RegionType region;
+  region.SetSize(0, 64);
+  region.SetSize(1, 64);
+  region.SetSize(2, 32);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  // A block of foreground within chunks 1-2 along x, 0-1 along y and 1
+  // along z, of 16 pixel cubes
+  double                                      sum(0.0);
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType idx(it.GetIndex());
+    short                      value(0);
+    if (idx[0] >= 20 && idx[0] < 40 && idx[1] < 20 && idx[2] >= 17 && idx[2] < 25)
+      value = static_cast<short>(idx[0] + idx[1] + idx[2] - 50);
+    it.Set(value);
+    sum += value;
+  }
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkStatisticsOn();
+  io->UseImageStatisticsOn();
+  io->SetNumberOfHistogramBins(16);
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetNumberOfStreamDivisions(6);
+
+  try
+  {
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    // Query the stored statistics with a fresh reader
+    io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(fileName);
+    io->ReadImageInformation();
+
+    const itk::HDF5ContainerImageIO::ChunkStatisticsType stats(io->GetStatistics());
+    if (stats.Count != region.GetNumberOfPixels() || stats.ForegroundCount != 20 * 20 * 8 ||
+        itk::Math::NotAlmostEquals(stats.Sum, sum) || itk::Math::NotAlmostEquals(stats.Minimum, -13.0) ||
+        itk::Math::NotAlmostEquals(stats.Maximum, 32.0))
+    {
+      std::cout << "Unexpected statistics: minimum " << stats.Minimum << " maximum " << stats.Maximum << " sum "
+                << stats.Sum << " count " << stats.Count << " foreground " << stats.ForegroundCount << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    itk::ImageIORegion expectedRegion(3);
+    expectedRegion.SetIndex(0, 16);
+    expectedRegion.SetIndex(1, 0);
+    expectedRegion.SetIndex(2, 16);
+    expectedRegion.SetSize(0, 32);
+    expectedRegion.SetSize(1, 32);
+    expectedRegion.SetSize(2, 16);
+    if (io->GetForegroundRegion() != expectedRegion)
+    {
+      std::cout << "Foreground region " << io->GetForegroundRegion() << " doesn't match expected one "
+                << expectedRegion << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Image statistics are exposed in the metadata dictionary
+    const itk::MetaDataDictionary & metaDict(io->GetMetaDataDictionary());
+    double                          minimum(0.0), maximum(0.0), mean(0.0);
+    std::vector<unsigned long long> histogram;
+    if (!itk::ExposeMetaData(metaDict, "Minimum", minimum) || !itk::ExposeMetaData(metaDict, "Maximum", maximum) ||
+        !itk::ExposeMetaData(metaDict, "Mean", mean) || !itk::ExposeMetaData(metaDict, "Histogram", histogram))
+    {
+      std::cout << "Image statistics missing from the metadata dictionary" << std::endl;
+      return EXIT_FAILURE;
+    }
+    unsigned long long histogramCount(0);
+    for (auto count : histogram)
+      histogramCount += count;
+    if (itk::Math::NotAlmostEquals(minimum, -13.0) || itk::Math::NotAlmostEquals(maximum, 32.0) ||
+        itk::Math::NotAlmostEquals(mean, sum / region.GetNumberOfPixels()) || histogram.size() != 16 ||
+        histogramCount != region.GetNumberOfPixels())
+    {
+      std::cout << "Unexpected image statistics: minimum " << minimum << " maximum " << maximum << " mean " << mean
+                << " histogram bins " << histogram.size() << " count " << histogramCount << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Only chunks of the foreground block reach values above 20
+    const std::vector<itk::ImageIOBase::SizeValueType> chunks(io->GetChunksInIntensityRange(20.0, 100.0));
+    for (auto chunk : chunks)
+    {
+      if (!expectedRegion.IsInside(io->GetChunkRegion(chunk)))
+      {
+        std::cout << "Chunk " << chunk << " is outside the foreground region" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (chunks.empty())
+    {
+      std::cout << "No chunks in intensity range" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOChunkStatisticsTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  // Statistics of a compressed dataset written without them are computed
+  // on demand, the second call returns the cached attributes
+  const char * computedFileName("ComputedStatisticsImage.hdf5");
+  io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkingOn();
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+
+  writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(computedFileName);
+  writer->SetInput(image);
+
+  try
+  {
+    writer->Write();
+    writer = WriterType::Pointer();
+
+    io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(computedFileName);
+    io->ReadImageInformation();
+
+    for (int i = 0; i < 2; i++)
+    {
+      const itk::HDF5ContainerImageIO::ChunkStatisticsType stats(io->ComputeStatistics());
+      if (stats.Count != region.GetNumberOfPixels() || stats.ForegroundCount != 20 * 20 * 8 ||
+          itk::Math::NotAlmostEquals(stats.GetMean(), sum / region.GetNumberOfPixels()) ||
+          itk::Math::NotAlmostEquals(stats.Minimum, -13.0) || itk::Math::NotAlmostEquals(stats.Maximum, 32.0))
+      {
+        std::cout << "Unexpected computed statistics: minimum " << stats.Minimum << " maximum " << stats.Maximum
+                  << " mean " << stats.GetMean() << " count " << stats.Count << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A chunk rewritten in place, which may keep its address and size,
+    // makes the cached statistics stale
+    std::vector<short> chunk(16 * 16 * 16, 100);
+    io->OpenForUpdate();
+    io->WriteChunk(0, chunk.data());
+    io->ReadImageInformation();
+
+    const itk::HDF5ContainerImageIO::ChunkStatisticsType stats(io->ComputeStatistics());
+    if (itk::Math::NotAlmostEquals(stats.Maximum, 100.0) ||
+        itk::Math::NotAlmostEquals(stats.Sum, sum + 100.0 * chunk.size()))
+    {
+      std::cout << "Statistics computed after an update: maximum " << stats.Maximum << " sum " << stats.Sum
+                << ", expected 100 and " << sum + 100.0 * chunk.size() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOChunkStatisticsTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  io = itk::HDF5ContainerImageIO::Pointer();
+  itk::IOTestHelper::Remove(computedFileName);
+
+  return EXIT_SUCCESS;
+}
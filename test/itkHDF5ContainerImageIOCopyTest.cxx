@@ -0,0 +1,285 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+// Compare a dataset with the region of the image it was copied from
+template <typename TImage>
+bool
+CheckCopy(const char * fileName, const std::string & dataSetName, const typename TImage::RegionType & region)
+{
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->SetDataSetName(dataSetName);
+
+  using ReaderType = itk::ImageFileReader<TImage>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->SetFileName(fileName);
+  reader->Update();
+
+  const typename TImage::Pointer output(reader->GetOutput());
+  if (output->GetLargestPossibleRegion().GetSize() != region.GetSize())
+  {
+    std::cout << dataSetName << " has size " << output->GetLargestPossibleRegion().GetSize() << ", expected "
+              << region.GetSize() << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < TImage::ImageDimension; i++)
+  {
+    if (output->GetOrigin()[i] != region.GetIndex(i))
+    {
+      std::cout << dataSetName << " has origin " << output->GetOrigin() << ", expected " << region.GetIndex()
+                << std::endl;
+      return false;
+    }
+  }
+
+  itk::ImageRegionIteratorWithIndex<TImage> it(output, output->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    typename TImage::IndexType index(it.GetIndex());
+    for (unsigned int i = 0; i < TImage::ImageDimension; i++)
+      index[i] += region.GetIndex(i);
+
+    const unsigned short expected(itk::HDF5ContainerTestHelper::Value(index));
+    if (it.Get() != expected)
+    {
+      std::cout << dataSetName << " pixel " << it.GetIndex() << " is " << it.Get() << ", expected " << expected
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkHDF5ContainerImageIOCopyTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("CopySource.hdf5");
+  const char * copyFileName("Copy.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer          image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+  const ImageType::RegionType region(image->GetLargestPossibleRegion());
+
+  // A crop starting on chunk boundaries, whose chunks are moved raw, and
+  // one straddling chunks, which are decoded and encoded
+  ImageType::RegionType alignedRegion;
+  alignedRegion.SetIndex(0, 16);
+  alignedRegion.SetIndex(1, 16);
+  alignedRegion.SetIndex(2, 8);
+  alignedRegion.SetSize(0, 40);
+  alignedRegion.SetSize(1, 20);
+  alignedRegion.SetSize(2, 12);
+
+  ImageType::RegionType straddlingRegion;
+  straddlingRegion.SetIndex(0, 10);
+  straddlingRegion.SetIndex(1, 5);
+  straddlingRegion.SetIndex(2, 3);
+  straddlingRegion.SetSize(0, 30);
+  straddlingRegion.SetSize(1, 20);
+  straddlingRegion.SetSize(2, 10);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  itksys::SystemTools::RemoveFile(fileName);
+  itksys::SystemTools::RemoveFile(copyFileName);
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseCompressionOn();
+    io->UseChunkingOn();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 8 };
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->Write();
+    writer = WriterType::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer source = itk::HDF5ContainerImageIO::New();
+    source->SetFileName(fileName);
+    source->ReadImageInformation();
+
+    // The whole dataset copied twice merges both in one container
+    const char * dataSetNames[] = { "/first", "/second", "/aligned", "/straddling" };
+    for (int i = 0; i < 4; i++)
+    {
+      itk::HDF5ContainerImageIO::Pointer destination = itk::HDF5ContainerImageIO::New();
+      destination->SetFileName(copyFileName);
+      destination->SetDataSetName(dataSetNames[i]);
+      if (i < 2)
+      {
+        source->CopyDataSet(destination);
+        continue;
+      }
+
+      const ImageType::RegionType & cropRegion(i == 2 ? alignedRegion : straddlingRegion);
+      itk::ImageIORegion            ioRegion(3);
+      for (unsigned int j = 0; j < 3; j++)
+      {
+        ioRegion.SetIndex(j, cropRegion.GetIndex(j));
+        ioRegion.SetSize(j, cropRegion.GetSize(j));
+      }
+      source->CopyRegion(ioRegion, destination);
+    }
+
+    // An existing dataset is only replaced with Overwrite on
+    itk::HDF5ContainerImageIO::Pointer destination = itk::HDF5ContainerImageIO::New();
+    destination->SetFileName(copyFileName);
+    destination->SetDataSetName(dataSetNames[0]);
+    try
+    {
+      source->CopyDataSet(destination);
+      std::cout << "Copying over an existing dataset did not throw" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch (const itk::ExceptionObject &)
+    {
+    }
+
+    if (!CheckCopy<ImageType>(copyFileName, dataSetNames[0], region) ||
+        !CheckCopy<ImageType>(copyFileName, dataSetNames[1], region) ||
+        !CheckCopy<ImageType>(copyFileName, dataSetNames[2], alignedRegion) ||
+        !CheckCopy<ImageType>(copyFileName, dataSetNames[3], straddlingRegion))
+      return EXIT_FAILURE;
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOCopyTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // A crop straddling the chunks of a sparse dataset leaves the chunks
+  // over its unallocated chunks unallocated, only the first chunk of the
+  // dataset holds anything but the fill value
+  const char *          sparseFileName("CopySparse.hdf5");
+  ImageType::RegionType foreground;
+  foreground.SetSize(0, 16);
+  foreground.SetSize(1, 16);
+  foreground.SetSize(2, 8);
+  image->FillBuffer(7);
+  itk::ImageRegionIteratorWithIndex<ImageType> fit(image, foreground);
+  for (fit.GoToBegin(); !fit.IsAtEnd(); ++fit)
+  {
+    fit.Set(itk::HDF5ContainerTestHelper::Value(fit.GetIndex()));
+  }
+  image->Modified();
+
+  itksys::SystemTools::RemoveFile(sparseFileName);
+  itksys::SystemTools::RemoveFile(copyFileName);
+  std::vector<bool>  allocated;
+  ImageType::Pointer sparseCopy;
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseSparseOn();
+    io->SetFillValue(7);
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 8 };
+    itk::HDF5ContainerTestHelper::WriteImage(image.GetPointer(), io, sparseFileName);
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer source = itk::HDF5ContainerImageIO::New();
+    source->SetFileName(sparseFileName);
+    source->ReadImageInformation();
+
+    itk::HDF5ContainerImageIO::Pointer destination = itk::HDF5ContainerImageIO::New();
+    destination->SetFileName(copyFileName);
+    itk::ImageIORegion ioRegion(3);
+    for (unsigned int j = 0; j < 3; j++)
+    {
+      ioRegion.SetIndex(j, straddlingRegion.GetIndex(j));
+      ioRegion.SetSize(j, straddlingRegion.GetSize(j));
+    }
+    source->CopyRegion(ioRegion, destination);
+    source = itk::HDF5ContainerImageIO::Pointer();
+
+    destination = itk::HDF5ContainerImageIO::New();
+    destination->SetFileName(copyFileName);
+    destination->ReadImageInformation();
+    allocated = destination->GetAllocatedChunkMap();
+    destination = itk::HDF5ContainerImageIO::Pointer();
+
+    using ReaderType = itk::ImageFileReader<ImageType>;
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(copyFileName);
+    reader->Update();
+    sparseCopy = reader->GetOutput();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOCopyTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The copy is 2x2x2 chunks, of which only the first lies over the
+  // foreground
+  const size_t numAllocated(std::count(allocated.begin(), allocated.end(), true));
+  if (allocated.size() != 8 || numAllocated != 1 || !allocated[0])
+  {
+    std::cout << "The sparse copy allocated " << numAllocated << " of " << allocated.size()
+              << " chunks, expected the first of 8" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> sit(sparseCopy, sparseCopy->GetLargestPossibleRegion());
+  for (sit.GoToBegin(); !sit.IsAtEnd(); ++sit)
+  {
+    ImageType::IndexType index(sit.GetIndex());
+    for (unsigned int i = 0; i < 3; i++)
+      index[i] += straddlingRegion.GetIndex(i);
+    if (sit.Get() != image->GetPixel(index))
+    {
+      std::cout << "Sparse copy pixel " << sit.GetIndex() << " is " << sit.Get() << ", expected "
+                << image->GetPixel(index) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  sparseCopy = ImageType::Pointer();
+
+  itk::IOTestHelper::Remove(fileName);
+  itk::IOTestHelper::Remove(sparseFileName);
+  itk::IOTestHelper::Remove(copyFileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+
+int
+itkHDF5ContainerImageIODirectIOTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("DirectIO.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+
+  itksys::SystemTools::RemoveFile(fileName);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    // Slabs of whole chunks streamed through the direct driver where
+    // libhdf5 has it, otherwise dropped from the page cache afterwards
+    std::cout << "UseDirectIO "
+              << (itk::HDF5ContainerImageIO::IsDirectIOAvailable() ? "opens files with the direct driver"
+                                                                    : "drops the page cache after I/O")
+              << std::endl;
+
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseDirectIOOn();
+    io->UseCompressionOn();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 64, 48, 4 };
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetNumberOfStreamDivisions(5);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer readIO = itk::HDF5ContainerImageIO::New();
+    readIO->UseDirectIOOn();
+    reader->SetImageIO(readIO);
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIODirectIOTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
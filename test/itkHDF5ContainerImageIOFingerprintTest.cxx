@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileWriter.h"
+
+int
+itkHDF5ContainerImageIOFingerprintTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+
+  // The same image chunked and compressed at two levels, contiguous, and
+  // changed by one pixel
+  const char * fileNames[] = { "FingerprintA.hdf5", "FingerprintB.hdf5", "FingerprintC.hdf5", "FingerprintD.hdf5" };
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  std::vector<itk::HDF5ContainerImageIO::Pointer> ios;
+  try
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      if (i == 3)
+      {
+        ImageType::IndexType index = { { 20, 3, 9 } };
+        image->SetPixel(index, 7);
+        image->Modified();
+      }
+
+      itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+      if (i != 2)
+      {
+        io->UseCompressionOn();
+        io->SetCompressionLevel(i == 1 ? 1 : 6);
+        io->UseChunkingOn();
+        io->UseChunkSizeOn();
+        io->GetChunkSize() = { 16, 16, 8 };
+      }
+
+      itksys::SystemTools::RemoveFile(fileNames[i]);
+      WriterType::Pointer writer = WriterType::New();
+      writer->SetImageIO(io);
+      writer->SetFileName(fileNames[i]);
+      writer->SetInput(image);
+      writer->Write();
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+      itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+      io->SetFileName(fileNames[i]);
+      io->ReadImageInformation();
+      ios.push_back(io);
+    }
+
+    const itk::HDF5ContainerImageIO::Pointer original(ios[0]);
+    const uint64_t                           fingerprint(original->ComputeFingerprint());
+    for (int i = 0; i < 4; i++)
+    {
+      const bool expected(i != 3);
+      if (original->CompareDataSets(ios[i]) != expected || (ios[i]->ComputeFingerprint() == fingerprint) != expected)
+      {
+        std::cout << fileNames[i] << " does not compare " << (expected ? "equal" : "different") << " to "
+                  << fileNames[0] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // The fingerprint cached is returned again
+    if (original->ComputeFingerprint() != fingerprint)
+    {
+      std::cout << "Cached fingerprint differs" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // A chunk rewritten in place changes the fingerprint cached and the
+    // comparison with the copies
+    std::vector<unsigned short> chunk(16 * 16 * 8, 100);
+    original->OpenForUpdate();
+    original->WriteChunk(0, chunk.data());
+    original->ReadImageInformation();
+    if (original->ComputeFingerprint() == fingerprint || original->CompareDataSets(ios[1]))
+    {
+      std::cout << "Rewriting a chunk of " << fileNames[0] << " does not change its fingerprint" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOFingerprintTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ios.clear();
+  for (auto fileName : fileNames)
+  {
+    itk::IOTestHelper::Remove(fileName);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+
+#include <filesystem>
+
+namespace
+{
+void
+LocalChunkCacheTestSize(const std::string & directory, size_t & entries, uintmax_t & bytes)
+{
+  entries = 0;
+  bytes = 0;
+  for (const auto & item : std::filesystem::directory_iterator(directory))
+  {
+    if (item.path().extension() == ".chunk")
+    {
+      entries++;
+      bytes += item.file_size();
+    }
+  }
+}
+} // namespace
+
+int
+itkHDF5ContainerImageIOLocalChunkCacheTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char *      fileName("LocalChunkCache.hdf5");
+  const std::string cacheDirectory("LocalChunkCache");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  std::filesystem::remove_all(cacheDirectory);
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 32);
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkingOn();
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 8 };
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+
+  // The first read fills the cache directory, the second is served from
+  // it, and the third with a small capacity evicts most of it
+  size_t    entries[3];
+  uintmax_t bytes[3];
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  for (int i = -1; i < 3; i++)
+  {
+    try
+    {
+      if (i < 0)
+      {
+        writer->Write();
+        writer = WriterType::Pointer();
+        io = itk::HDF5ContainerImageIO::Pointer();
+        continue;
+      }
+
+      itk::HDF5ContainerImageIO::Pointer readerIO = itk::HDF5ContainerImageIO::New();
+      readerIO->SetLocalChunkCacheDirectory(cacheDirectory);
+      if (i == 2)
+        readerIO->SetLocalChunkCacheCapacity(bytes[1] / 4);
+
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetImageIO(readerIO);
+      reader->SetFileName(fileName);
+      reader->Update();
+      LocalChunkCacheTestSize(cacheDirectory, entries[i], bytes[i]);
+
+      if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+      {
+        std::cout << "Read " << i << " differs from the image written" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    catch (const itk::ExceptionObject & err)
+    {
+      std::cout << "itkHDF5ContainerImageIOLocalChunkCacheTest" << std::endl
+                << "Exception Object caught: " << std::endl
+                << err << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The image is 4x3x4 chunks
+  if (entries[0] != 48 || entries[1] != 48 || bytes[1] != bytes[0])
+  {
+    std::cout << "Local chunk cache holds " << entries[0] << " and " << entries[1]
+              << " chunks after the first and second reads, expected 48" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (bytes[2] > bytes[1] / 4)
+  {
+    std::cout << "Local chunk cache holds " << bytes[2] << " bytes, over its capacity of " << bytes[1] / 4
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::filesystem::remove_all(cacheDirectory);
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
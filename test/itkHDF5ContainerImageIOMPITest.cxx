@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+
+#include <mpi.h>
+
+namespace
+{
+itk::HDF5ContainerImageIO::Pointer
+MPITestImageIO(const char * fileName, itk::SizeValueType depth)
+{
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->SetFileName(fileName);
+  itk::HDF5ContainerTestHelper::SetImageInformation(io, 64, 48, depth);
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 8 };
+  io->UseMPIIOOn();
+  return io;
+}
+
+// Each process writes its own slab, then reads the slab of the next
+int
+MPITestRank(const char * fileName, int rank, int size)
+{
+  constexpr itk::SizeValueType slabDepth = 8;
+  const itk::SizeValueType     slabPixels = 64 * 48 * slabDepth;
+
+  std::vector<unsigned short> slab(slabPixels);
+  auto                        pixel(slab.begin());
+  for (itk::IndexValueType z = rank * slabDepth; z < static_cast<itk::IndexValueType>((rank + 1) * slabDepth); z++)
+    for (itk::IndexValueType y = 0; y < 48; y++)
+      for (itk::IndexValueType x = 0; x < 64; x++)
+        *pixel++ = itk::HDF5ContainerTestHelper::Value(x, y, z);
+
+  // Options gathering state from every region written are refused
+  itk::HDF5ContainerImageIO::Pointer sparseIO = MPITestImageIO(fileName, size * slabDepth);
+  sparseIO->UseSparseOn();
+  try
+  {
+    sparseIO->WriteImageInformation();
+    std::cout << "Rank " << rank << ": UseSparse with UseMPIIO did not throw" << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const itk::ExceptionObject &)
+  {
+  }
+
+  itk::HDF5ContainerImageIO::Pointer io = MPITestImageIO(fileName, size * slabDepth);
+  io->WriteImageInformation();
+  io->SetIORegion(itk::HDF5ContainerTestHelper::Slab(rank * slabDepth, slabDepth));
+  io->Write(slab.data());
+  io = itk::HDF5ContainerImageIO::Pointer();
+
+  const int                          next((rank + 1) % size);
+  itk::HDF5ContainerImageIO::Pointer reader = itk::HDF5ContainerImageIO::New();
+  reader->SetFileName(fileName);
+  reader->UseMPIIOOn();
+  reader->ReadImageInformation();
+  if (reader->GetDimensions(2) != size * slabDepth)
+  {
+    std::cout << "Rank " << rank << ": the dataset has depth " << reader->GetDimensions(2) << ", expected "
+              << size * slabDepth << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  reader->SetIORegion(itk::HDF5ContainerTestHelper::Slab(next * slabDepth, slabDepth));
+  reader->Read(slab.data());
+
+  pixel = slab.begin();
+  for (itk::IndexValueType z = next * slabDepth; z < static_cast<itk::IndexValueType>((next + 1) * slabDepth); z++)
+    for (itk::IndexValueType y = 0; y < 48; y++)
+      for (itk::IndexValueType x = 0; x < 64; x++, ++pixel)
+        if (*pixel != itk::HDF5ContainerTestHelper::Value(x, y, z))
+        {
+          std::cout << "Rank " << rank << ": pixel [" << x << ", " << y << ", " << z << "] is " << *pixel
+                    << ", expected " << itk::HDF5ContainerTestHelper::Value(x, y, z) << std::endl;
+          return EXIT_FAILURE;
+        }
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkHDF5ContainerImageIOMPITest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  MPI_Init(&ac, &av);
+
+  int rank(0), size(1);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  const char * fileName("MPI.hdf5");
+  if (rank == 0)
+    itksys::SystemTools::RemoveFile(fileName);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  int result(EXIT_SUCCESS);
+  try
+  {
+    result = MPITestRank(fileName, rank, size);
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOMPITest rank " << rank << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    result = EXIT_FAILURE;
+  }
+
+  // The test fails if any process does
+  int failed(result != EXIT_SUCCESS ? 1 : 0), anyFailed(0);
+  MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+  if (rank == 0 && !anyFailed)
+    itk::IOTestHelper::Remove(fileName);
+
+  MPI_Finalize();
+
+  return anyFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMath.h"
+
+#include <algorithm>
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+ReadProjection(const char * fileName, const std::string & dataSetName)
+{
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->SetDataSetName(dataSetName);
+
+  using ReaderType = itk::ImageFileReader<TImage>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->SetFileName(fileName);
+  reader->Update();
+  return reader->GetOutput();
+}
+} // namespace
+
+template <typename TPixel>
+int
+HDF5ContainerProjectionsTest(const char * fileName)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  using ProjectionType = itk::Image<TPixel, 2>;
+  using MeanProjectionType = itk::Image<float, 2>;
+
+  typename ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage<ImageType>(40, 30, 20);
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseProjectionsOn();
+  io->UseMeanProjectionsOn();
+  io->SetThumbnailSize(16);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetNumberOfStreamDivisions(7);
+
+  typename ProjectionType::Pointer     maximumZ, maximumX, thumbnail;
+  typename MeanProjectionType::Pointer meanY;
+  try
+  {
+    writer->Write();
+    writer = typename WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    maximumZ = ReadProjection<ProjectionType>(fileName, "/data_MaximumProjection2");
+    maximumX = ReadProjection<ProjectionType>(fileName, "/data_MaximumProjection0");
+    meanY = ReadProjection<MeanProjectionType>(fileName, "/data_MeanProjection1");
+    thumbnail = ReadProjection<ProjectionType>(fileName, "/data_Thumbnail");
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOProjectionsTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typename ImageType::IndexType idx;
+  for (idx[1] = 0; idx[1] < 30; idx[1]++)
+  {
+    for (idx[0] = 0; idx[0] < 40; idx[0]++)
+    {
+      TPixel maximum(0);
+      for (idx[2] = 0; idx[2] < 20; idx[2]++)
+        maximum = std::max(maximum, itk::HDF5ContainerTestHelper::Value<TPixel>(idx));
+      if (maximumZ->GetPixel({ { idx[0], idx[1] } }) != maximum)
+      {
+        std::cout << "Maximum projection along z differs at " << idx[0] << "," << idx[1] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  for (idx[2] = 0; idx[2] < 20; idx[2]++)
+  {
+    for (idx[1] = 0; idx[1] < 30; idx[1]++)
+    {
+      TPixel maximum(0);
+      for (idx[0] = 0; idx[0] < 40; idx[0]++)
+        maximum = std::max(maximum, itk::HDF5ContainerTestHelper::Value<TPixel>(idx));
+      if (maximumX->GetPixel({ { idx[1], idx[2] } }) != maximum)
+      {
+        std::cout << "Maximum projection along x differs at " << idx[1] << "," << idx[2] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  for (idx[2] = 0; idx[2] < 20; idx[2]++)
+  {
+    for (idx[0] = 0; idx[0] < 40; idx[0]++)
+    {
+      double sum(0.0);
+      for (idx[1] = 0; idx[1] < 30; idx[1]++)
+        sum += itk::HDF5ContainerTestHelper::Value<TPixel>(idx);
+      if (itk::Math::abs(meanY->GetPixel({ { idx[0], idx[2] } }) - sum / 30.0) > 1e-3)
+      {
+        std::cout << "Mean projection along y differs at " << idx[0] << "," << idx[2] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The 40x30 central slice is averaged over 3x3 boxes
+  const typename ProjectionType::SizeType thumbnailSize(thumbnail->GetLargestPossibleRegion().GetSize());
+  if (thumbnailSize[0] != 14 || thumbnailSize[1] != 10 || itk::Math::NotExactlyEquals(thumbnail->GetSpacing()[0], 3.0))
+  {
+    std::cout << "Thumbnail is " << thumbnailSize << " with spacing " << thumbnail->GetSpacing()
+              << ", expected 14x10 with spacing 3" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
+
+int
+itkHDF5ContainerImageIOProjectionsTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  int result(0);
+  result += HDF5ContainerProjectionsTest<unsigned short>("ProjectionsUShortImage.hdf5");
+  result += HDF5ContainerProjectionsTest<float>("ProjectionsFloatImage.hdf5");
+  return result != 0;
+}
@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+
+int
+itkHDF5ContainerImageIOSharedChunkCacheTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("SharedChunkCache.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 32);
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkingOn();
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 8 };
+
+  // Two readers of the same file, the second finds the chunks decoded by
+  // the first in the shared cache
+  itk::HDF5ContainerImageIO::ClearSharedChunkCache();
+  itk::HDF5ContainerImageIO::SharedChunkCacheStatisticsType first, second;
+  ImageType::Pointer                                         output;
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  try
+  {
+    itk::HDF5ContainerTestHelper::WriteImage(image.GetPointer(), io, fileName);
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    for (int i = 0; i < 2; i++)
+    {
+      itk::HDF5ContainerImageIO::Pointer readerIO = itk::HDF5ContainerImageIO::New();
+      readerIO->UseSharedChunkCacheOn();
+
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetImageIO(readerIO);
+      reader->SetFileName(fileName);
+      reader->Update();
+      output = reader->GetOutput();
+
+      (i == 0 ? first : second) = itk::HDF5ContainerImageIO::GetSharedChunkCacheStatistics();
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOSharedChunkCacheTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The image is 4x3x4 chunks
+  if (first.Misses != 48 || first.Hits != 0 || second.Misses != 48 || second.Hits + second.CompressedHits != 48)
+  {
+    std::cout << "Shared chunk cache counted " << first.Hits << " hits and " << first.Misses
+              << " misses for the first read, " << second.Hits << " hits, " << second.CompressedHits
+              << " compressed hits and " << second.Misses << " misses after the second, expected 0/48 and 48/48"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(output.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+// Foreground block in the corner of a volume of the fill value
+template <typename TPixel, typename TIndex>
+TPixel
+SparseTestValue(const TIndex & idx)
+{
+  if (idx[0] < 20 && idx[1] < 20 && idx[2] < 10)
+    return static_cast<TPixel>(idx[0] + idx[1] + idx[2] + 100);
+  return static_cast<TPixel>(7);
+}
+} // namespace
+
+template <typename TPixel>
+int
+HDF5ContainerSparseTest(const char * fileName)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+
+  typename ImageType::RegionType region;
+  region.SetSize(0, 64);
+  region.SetSize(1, 64);
+  region.SetSize(2, 32);
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    it.Set(SparseTestValue<TPixel>(it.GetIndex()));
+  }
+
+  // Stream in slabs that do not line up with the chunks, so partly
+  // covered chunks are written
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseSparseOn();
+  io->SetFillValue(7);
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetNumberOfStreamDivisions(6);
+
+  std::vector<bool> allocated;
+  try
+  {
+    writer->Write();
+    allocated = io->GetAllocatedChunkMap();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOSparseTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Only the 2x2x1 chunks holding the foreground block are allocated
+  const size_t numAllocated(std::count(allocated.begin(), allocated.end(), true));
+  if (allocated.size() != 32 || numAllocated != 4)
+  {
+    std::cout << "Allocated " << numAllocated << " of " << allocated.size() << " chunks, expected 4 of 32"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  writer = typename WriterType::Pointer();
+  io = itk::HDF5ContainerImageIO::Pointer();
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  try
+  {
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOSparseTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), region);
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    if (rit.Get() != SparseTestValue<TPixel>(rit.GetIndex()))
+    {
+      std::cout << "Pixel " << rit.GetIndex() << " is " << static_cast<double>(rit.Get()) << ", expected "
+                << static_cast<double>(SparseTestValue<TPixel>(rit.GetIndex())) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
+
+// A region partly covering a single chunk, with the rest of the image
+// never written: both the remainder of that chunk and the unallocated
+// chunks must read back as a non-zero fill value
+int
+HDF5ContainerSparsePartialChunkTest(const char * fileName)
+{
+  using ImageType = itk::Image<unsigned short, 3>;
+
+  itk::ImageIORegion written(3);
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    written.SetIndex(i, 4);
+    written.SetSize(i, 8);
+  }
+  const std::vector<unsigned short> buffer(written.GetNumberOfPixels(), 100);
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->SetFileName(fileName);
+  io->SetNumberOfDimensions(3);
+  io->SetDimensions(0, 64);
+  io->SetDimensions(1, 64);
+  io->SetDimensions(2, 32);
+  io->SetComponentType(itk::IOComponentEnum::USHORT);
+  io->SetPixelType(itk::IOPixelEnum::SCALAR);
+  io->SetNumberOfComponents(1);
+  io->UseSparseOn();
+  io->SetFillValue(7);
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+
+  std::vector<bool> allocated;
+  try
+  {
+    io->WriteImageInformation();
+    io->SetIORegion(written);
+    io->Write(buffer.data());
+    allocated = io->GetAllocatedChunkMap();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOSparseTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+  io = itk::HDF5ContainerImageIO::Pointer();
+
+  const size_t numAllocated(std::count(allocated.begin(), allocated.end(), true));
+  if (numAllocated != 1 || !allocated[0])
+  {
+    std::cout << "Allocated " << numAllocated << " chunks after a partial write, expected only chunk 0"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  try
+  {
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOSparseTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), reader->GetOutput()->GetBufferedRegion());
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    const ImageType::IndexType idx(rit.GetIndex());
+    bool                       inside(true);
+    for (unsigned int i = 0; i < 3; i++)
+      inside = inside && idx[i] >= written.GetIndex(i) &&
+               idx[i] < written.GetIndex(i) + static_cast<itk::IndexValueType>(written.GetSize(i));
+    const unsigned short expected(inside ? 100 : 7);
+    if (rit.Get() != expected)
+    {
+      std::cout << "Pixel " << idx << " is " << rit.Get() << " after a partial write, expected " << expected
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  reader = ReaderType::Pointer();
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
+
+int
+itkHDF5ContainerImageIOSparseTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  int result(0);
+  result += HDF5ContainerSparseTest<unsigned short>("SparseUShortImage.hdf5");
+  result += HDF5ContainerSparseTest<float>("SparseFloatImage.hdf5");
+  result += HDF5ContainerSparsePartialChunkTest("SparsePartialChunkImage.hdf5");
+  return result != 0;
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+
+int
+itkHDF5ContainerImageIOSplitTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  // The container is stored in Split.hdf5.meta and Split.hdf5.raw
+  const char * fileName("Split.hdf5");
+  const char * metaDataFileName("Split.hdf5.meta");
+  const char * rawDataFileName("Split.hdf5.raw");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+
+  itksys::SystemTools::RemoveFile(fileName);
+  itksys::SystemTools::RemoveFile(metaDataFileName);
+  itksys::SystemTools::RemoveFile(rawDataFileName);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->SetFileDriver(itk::HDF5ContainerImageIO::FileDriverEnum::Split);
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 64, 48, 4 };
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetNumberOfStreamDivisions(4);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    if (itksys::SystemTools::FileExists(fileName) || !itksys::SystemTools::FileExists(metaDataFileName) ||
+        !itksys::SystemTools::FileExists(rawDataFileName))
+    {
+      std::cout << "The container was not written as metadata and raw data files" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The 240KB of pixels are all in the raw data file
+    if (itksys::SystemTools::FileLength(rawDataFileName) < 64 * 48 * 40 * sizeof(unsigned short) ||
+        itksys::SystemTools::FileLength(metaDataFileName) >= 64 * 48 * 40 * sizeof(unsigned short))
+    {
+      std::cout << "The metadata file holds " << itksys::SystemTools::FileLength(metaDataFileName)
+                << " bytes and the raw data file " << itksys::SystemTools::FileLength(rawDataFileName) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The container is found and opened with the split driver without
+    // being told
+    itk::HDF5ContainerImageIO::Pointer readIO = itk::HDF5ContainerImageIO::New();
+    if (!readIO->CanReadFile(fileName))
+    {
+      std::cout << "CanReadFile() does not recognize the split container" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOSplitTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  itksys::SystemTools::RemoveFile(metaDataFileName);
+  itksys::SystemTools::RemoveFile(rawDataFileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkMetaDataObject.h"
+
+int
+itkHDF5ContainerImageIOUpdateTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("Update.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer          image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 32);
+  const ImageType::RegionType region(image->GetLargestPossibleRegion());
+
+  // The pasted region covers chunks partly
+  ImageType::RegionType pasteRegion;
+  pasteRegion.SetIndex(0, 10);
+  pasteRegion.SetIndex(1, 5);
+  pasteRegion.SetIndex(2, 3);
+  pasteRegion.SetSize(0, 20);
+  pasteRegion.SetSize(1, 20);
+  pasteRegion.SetSize(2, 10);
+
+  itk::ImageIORegion pasteIORegion(3);
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    pasteIORegion.SetIndex(i, pasteRegion.GetIndex(i));
+    pasteIORegion.SetSize(i, pasteRegion.GetSize(i));
+  }
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  uint64_t            fingerprint(0);
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseCompressionOn();
+    io->UseChunkingOn();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 8 };
+    io->UseImageStatisticsOn();
+    io->UseChunkStatisticsOn();
+    io->UseProjectionsOn();
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    // The fingerprint is cached in the file
+    itk::HDF5ContainerImageIO::Pointer fingerprintIO = itk::HDF5ContainerImageIO::New();
+    fingerprintIO->SetFileName(fileName);
+    fingerprintIO->ReadImageInformation();
+    fingerprint = fingerprintIO->ComputeFingerprint();
+    fingerprintIO = itk::HDF5ContainerImageIO::Pointer();
+
+    // Change the pixels of the paste region, and write only that region
+    // into the existing dataset
+    itk::ImageRegionIteratorWithIndex<ImageType> pit(image, pasteRegion);
+    for (pit.GoToBegin(); !pit.IsAtEnd(); ++pit)
+    {
+      pit.Set(1000);
+    }
+    image->Modified();
+
+    itk::HDF5ContainerImageIO::Pointer updateIO = itk::HDF5ContainerImageIO::New();
+    updateIO->UseUpdateOn();
+    updateIO->UseCompressionOn();
+
+    writer = WriterType::New();
+    writer->SetImageIO(updateIO);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetIORegion(pasteIORegion);
+    writer->Write();
+    writer = WriterType::Pointer();
+    updateIO = itk::HDF5ContainerImageIO::Pointer();
+
+    reader->SetFileName(fileName);
+    reader->Update();
+
+    // The statistics, chunk statistics and projections stored with the
+    // dataset described the pixels before the update
+    itk::HDF5ContainerImageIO::Pointer updatedIO = itk::HDF5ContainerImageIO::New();
+    updatedIO->SetFileName(fileName);
+    updatedIO->ReadImageInformation();
+    double maximum(0.0);
+    if (itk::ExposeMetaData(updatedIO->GetMetaDataDictionary(), "Maximum", maximum))
+    {
+      std::cout << "The statistics stored before the update were kept" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    try
+    {
+      updatedIO->GetChunkStatistics();
+      std::cout << "The chunk statistics stored before the update were kept" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch (const itk::ExceptionObject &)
+    {
+    }
+
+    const itk::HDF5ContainerImageIO::ChunkStatisticsType stats(updatedIO->ComputeStatistics());
+    if (itk::Math::NotAlmostEquals(stats.Maximum, 1000.0) || updatedIO->ComputeFingerprint() == fingerprint)
+    {
+      std::cout << "Statistics and fingerprint computed after the update describe the dataset before it, maximum "
+                << stats.Maximum << std::endl;
+      return EXIT_FAILURE;
+    }
+    updatedIO = itk::HDF5ContainerImageIO::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer projectionIO = itk::HDF5ContainerImageIO::New();
+    projectionIO->SetFileName(fileName);
+    projectionIO->SetDataSetName("/data_MaximumProjection2");
+    try
+    {
+      projectionIO->ReadImageInformation();
+      std::cout << "The projections stored before the update were kept" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch (const itk::ExceptionObject &)
+    {
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOUpdateTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), region);
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    const unsigned short expected(pasteRegion.IsInside(rit.GetIndex())
+                                    ? 1000
+                                    : itk::HDF5ContainerTestHelper::Value(rit.GetIndex()));
+    if (rit.Get() != expected)
+    {
+      std::cout << "Pixel " << rit.GetIndex() << " is " << rit.Get() << ", expected " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A dataset of another component type can not be updated
+  using FloatImageType = itk::Image<float, 3>;
+  FloatImageType::Pointer floatImage = FloatImageType::New();
+  floatImage->SetRegions(region);
+  floatImage->Allocate();
+  floatImage->FillBuffer(0.0f);
+
+  itk::HDF5ContainerImageIO::Pointer floatIO = itk::HDF5ContainerImageIO::New();
+  floatIO->UseUpdateOn();
+
+  using FloatWriterType = itk::ImageFileWriter<FloatImageType>;
+  FloatWriterType::Pointer floatWriter = FloatWriterType::New();
+  floatWriter->SetImageIO(floatIO);
+  floatWriter->SetFileName(fileName);
+  floatWriter->SetInput(floatImage);
+  floatWriter->SetIORegion(pasteIORegion);
+  try
+  {
+    floatWriter->Write();
+    std::cout << "Updating a dataset with another component type did not throw" << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const itk::ExceptionObject &)
+  {
+  }
+  floatWriter = FloatWriterType::Pointer();
+  floatIO = itk::HDF5ContainerImageIO::Pointer();
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+
+int
+itkHDF5ContainerImageIOWriteCombiningTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("WriteCombining.hdf5");
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer          image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+  const ImageType::RegionType region(image->GetLargestPossibleRegion());
+
+  // Single slices are streamed into cubic chunks, the last row of chunks
+  // is clipped by the image
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkingOn();
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+  io->UseChunkStatisticsOn();
+  io->UseWriteCombiningOn();
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetNumberOfStreamDivisions(40);
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer                                         reader = ReaderType::New();
+  std::vector<itk::HDF5ContainerImageIO::ChunkStatisticsType> statistics;
+  try
+  {
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer readerIO = itk::HDF5ContainerImageIO::New();
+    reader->SetImageIO(readerIO);
+    reader->SetFileName(fileName);
+    reader->Update();
+    statistics = readerIO->GetChunkStatistics();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageIOWriteCombiningTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Every chunk was written whole, once
+  itk::SizeValueType count(0);
+  for (const auto & chunk : statistics)
+  {
+    count += chunk.Count;
+  }
+  if (statistics.size() != 4 * 3 * 3 || count != region.GetNumberOfPixels())
+  {
+    std::cout << "Chunk statistics of " << statistics.size() << " chunks count " << count << " pixels, expected 36 and "
+              << region.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
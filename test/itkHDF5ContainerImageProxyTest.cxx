@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerImageProxy.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+bool
+InEditedRegion(const itk::Index<3> & idx)
+{
+  return idx[0] >= 10 && idx[0] < 30 && idx[1] >= 5 && idx[1] < 25 && idx[2] >= 3 && idx[2] < 13;
+}
+} // namespace
+
+int
+itkHDF5ContainerImageProxyTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("ImageProxy.hdf5");
+  using ImageType = itk::Image<short, 3>;
+  using ProxyType = itk::HDF5ContainerImageProxy<short, 3>;
+
+  ImageType::Pointer                           image = itk::HDF5ContainerTestHelper::CreateImage<ImageType>(50, 37, 23);
+  const ImageType::RegionType                  region(image->GetLargestPossibleRegion());
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->UseChunkingOn();
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 8 };
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+
+  try
+  {
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    // A budget of three chunks forces evictions, and write backs once
+    // pixels are modified
+    ProxyType::Pointer proxy = ProxyType::New();
+    proxy->GetImageIO()->SetFileName(fileName);
+    proxy->SetMemoryBudget(3 * 16 * 16 * 8 * sizeof(short));
+    proxy->WritableOn();
+    proxy->Open();
+
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      if (proxy->GetPixel(it.GetIndex()) != it.Get())
+      {
+        std::cout << "Proxy pixel " << it.GetIndex() << " is " << proxy->GetPixel(it.GetIndex()) << ", expected "
+                  << it.Get() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (proxy->GetCachedBytes() > proxy->GetMemoryBudget())
+    {
+      std::cout << "Proxy holds " << proxy->GetCachedBytes() << " bytes, over its budget of "
+                << proxy->GetMemoryBudget() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    itk::ImageIORegion edited(3);
+    edited.SetIndex({ 10, 5, 3 });
+    edited.SetSize({ 20, 20, 10 });
+    std::vector<short> buffer(edited.GetNumberOfPixels());
+    proxy->GetRegion(edited, buffer.data());
+    for (auto & value : buffer)
+      value = -value;
+    proxy->SetRegion(edited, buffer.data());
+
+    ImageType::IndexType corner = { { 49, 36, 22 } };
+    proxy->SetPixel(corner, 4242);
+    proxy->Close();
+
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerImageProxyTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), region);
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    const ImageType::IndexType idx(rit.GetIndex());
+    short                      expected(itk::HDF5ContainerTestHelper::Value<short>(idx));
+    if (InEditedRegion(idx))
+      expected = -expected;
+    if (idx[0] == 49 && idx[1] == 36 && idx[2] == 22)
+      expected = 4242;
+
+    if (rit.Get() != expected)
+    {
+      std::cout << "Pixel " << idx << " is " << rit.Get() << ", expected " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerLayoutAdvisor.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileWriter.h"
+
+int
+itkHDF5ContainerLayoutAdvisorTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char * fileName("LayoutAdvisor.hdf5");
+  const char * traceFileName("LayoutAdvisor.trace");
+  using ImageType = itk::Image<unsigned short, 3>;
+
+  ImageType::RegionType region;
+  region.SetSize(0, 64);
+  region.SetSize(1, 48);
+  region.SetSize(2, 40);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(7);
+
+  itksys::SystemTools::RemoveFile(traceFileName);
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseChunkingOn();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 16 };
+
+    using WriterType = itk::ImageFileWriter<ImageType>;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    // The image is read one slice at a time, then one chunk is read after
+    // reopening the file, which appends to the trace
+    std::vector<unsigned short> buffer(16 * 16 * 16);
+    for (int pass = 0; pass < 2; pass++)
+    {
+      itk::HDF5ContainerImageIO::Pointer reader = itk::HDF5ContainerImageIO::New();
+      reader->SetFileName(fileName);
+      reader->SetAccessTraceFileName(traceFileName);
+      reader->ReadImageInformation();
+      if (pass == 1)
+      {
+        reader->ReadChunk(0, buffer.data());
+        continue;
+      }
+
+      for (unsigned int z = 0; z < 40; z++)
+      {
+        itk::ImageIORegion slice(3);
+        slice.SetSize(0, 64);
+        slice.SetSize(1, 48);
+        slice.SetSize(2, 1);
+        slice.SetIndex(2, z);
+        reader->ReadRegion(slice, buffer.data());
+      }
+    }
+
+    // A cache of two cubic chunks is thrashed by every slice
+    itk::HDF5ContainerLayoutAdvisor::Pointer advisor = itk::HDF5ContainerLayoutAdvisor::New();
+    advisor->SetTraceFileName(traceFileName);
+    advisor->AddCandidateChunkSize({ 16, 16, 16 });
+    advisor->AddCandidateChunkSize({ 64, 48, 1 });
+    advisor->AddCandidateChunkSize({ 128, 128, 1 });
+    advisor->AddCandidateCacheSize(16 * 16 * 16 * 2 * 2);
+    advisor->Evaluate();
+
+    if (advisor->GetNumberOfAccesses() != 41)
+    {
+      std::cout << "Trace holds " << advisor->GetNumberOfAccesses() << " accesses, expected 41" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The slab clipped to the image duplicates the other slab
+    const std::vector<unsigned int> slab{ 64, 48, 1 };
+    if (advisor->GetEvaluations().size() != 2 || advisor->GetRecommendedChunkSize() != slab ||
+        itk::HDF5ContainerLayoutAdvisor::FormatChunkSize(slab) != "64,48,1")
+    {
+      std::cout << "Recommended "
+                << itk::HDF5ContainerLayoutAdvisor::FormatChunkSize(advisor->GetRecommendedChunkSize()) << " of "
+                << advisor->GetEvaluations().size() << " layouts, expected 64,48,1" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const itk::HDF5ContainerLayoutAdvisor::LayoutEvaluationType & cube(advisor->GetEvaluations()[1]);
+    if (cube.ChunksTouched != 40 * 12 + 1 || cube.ChunksRead != cube.ChunksTouched)
+    {
+      std::cout << "Cubic chunks touched " << cube.ChunksTouched << ", read " << cube.ChunksRead << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The cache holding every chunk read pays off at the default cost,
+    // the one holding a fraction of a slice at a high cost, or when the
+    // others exceed the memory budget
+    const itk::SizeValueType cacheSizes[] = { itk::SizeValueType(64) << 10, itk::SizeValueType(1) << 20,
+                                              itk::SizeValueType(1) << 30 };
+    advisor->ClearCandidates();
+    advisor->AddCandidateChunkSize({ 16, 16, 16 });
+    for (auto cacheSize : cacheSizes)
+    {
+      advisor->AddCandidateCacheSize(cacheSize);
+    }
+    const double             cacheCosts[] = { 1.0, 100.0, 0.0 };
+    const itk::SizeValueType budgets[] = { 0, 0, itk::SizeValueType(512) << 10 };
+    const itk::SizeValueType expected[] = { cacheSizes[1], cacheSizes[0], cacheSizes[0] };
+    for (int i = 0; i < 3; i++)
+    {
+      advisor->SetCacheCost(cacheCosts[i]);
+      advisor->SetMemoryBudget(budgets[i]);
+      advisor->Evaluate();
+      if (advisor->GetRecommendedCacheSize() != expected[i])
+      {
+        std::cout << "Recommended a cache of " << advisor->GetRecommendedCacheSize() << " bytes with a cache cost of "
+                  << cacheCosts[i] << " and a memory budget of " << budgets[i] << ", expected " << expected[i]
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerLayoutAdvisorTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+  itk::IOTestHelper::Remove(traceFileName);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerRegionWriter.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+
+#include <thread>
+
+int
+itkHDF5ContainerRegionWriterTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char *       fileName("RegionWriter.hdf5");
+  const unsigned int numThreads(4);
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::RegionType region;
+  region.SetSize(0, 50);
+  region.SetSize(1, 37);
+  region.SetSize(2, 40);
+
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->SetFileName(fileName);
+  itk::HDF5ContainerTestHelper::SetImageInformation(io, 50, 37, 40);
+  io->UseCompressionOn();
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+
+  // Each thread produces every numThreads-th slice, a small queue limit
+  // makes the producers wait for the committer
+  itk::HDF5ContainerRegionWriter::Pointer writer = itk::HDF5ContainerRegionWriter::New();
+  writer->SetImageIO(io);
+  writer->SetMaximumQueuedBytes(16 * 16 * 16 * 2);
+
+  std::vector<std::string> errors(numThreads);
+  try
+  {
+    writer->Start();
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < numThreads; t++)
+    {
+      threads.emplace_back([&, t]() {
+        try
+        {
+          for (itk::IndexValueType z = t; z < static_cast<itk::IndexValueType>(region.GetSize(2)); z += numThreads)
+          {
+            ImageType::RegionType slice(region);
+            slice.SetIndex(2, z);
+            slice.SetSize(2, 1);
+
+            std::vector<unsigned short> buffer;
+            buffer.reserve(slice.GetNumberOfPixels());
+            ImageType::IndexType idx{ { 0, 0, z } };
+            for (idx[1] = 0; idx[1] < static_cast<itk::IndexValueType>(region.GetSize(1)); idx[1]++)
+            {
+              for (idx[0] = 0; idx[0] < static_cast<itk::IndexValueType>(region.GetSize(0)); idx[0]++)
+              {
+                buffer.push_back(itk::HDF5ContainerTestHelper::Value(idx));
+              }
+            }
+
+            itk::ImageIORegion ioRegion(3);
+            for (unsigned int i = 0; i < 3; i++)
+            {
+              ioRegion.SetIndex(i, slice.GetIndex(i));
+              ioRegion.SetSize(i, slice.GetSize(i));
+            }
+            writer->WriteRegion(ioRegion, buffer.data());
+          }
+        }
+        catch (const itk::ExceptionObject & err)
+        {
+          errors[t] = err.GetDescription();
+        }
+      });
+    }
+    for (auto & thread : threads)
+    {
+      thread.join();
+    }
+    writer->Finish();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerRegionWriterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (const auto & error : errors)
+  {
+    if (!error.empty())
+    {
+      std::cout << "WriteRegion() failed: " << error << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The image is 4x3x3 chunks
+  if (writer->GetNumberOfChunksWritten() != 36)
+  {
+    std::cout << writer->GetNumberOfChunksWritten() << " chunks were written, expected 36" << std::endl;
+    return EXIT_FAILURE;
+  }
+  writer = itk::HDF5ContainerRegionWriter::Pointer();
+  io = itk::HDF5ContainerImageIO::Pointer();
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  try
+  {
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerRegionWriterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+  reader = ReaderType::Pointer();
+
+  // The chunks left incomplete hold the fill value of the dataset where
+  // they were not written
+  io = itk::HDF5ContainerImageIO::New();
+  io->SetFileName(fileName);
+  io->SetOverwrite(true);
+  itk::HDF5ContainerTestHelper::SetImageInformation(io, 50, 37, 40);
+  io->UseChunkSizeOn();
+  io->GetChunkSize() = { 16, 16, 16 };
+  io->SetFillValue(7.0);
+
+  writer = itk::HDF5ContainerRegionWriter::New();
+  writer->SetImageIO(io);
+
+  ImageType::Pointer partial;
+  try
+  {
+    itk::ImageIORegion slice(3);
+    slice.SetSize({ 50, 37, 1 });
+    const std::vector<unsigned short> buffer(slice.GetNumberOfPixels(), 100);
+
+    writer->Start();
+    writer->WriteRegion(slice, buffer.data());
+    writer->Finish();
+    writer = itk::HDF5ContainerRegionWriter::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+    partial = reader->GetOutput();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerRegionWriterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const ImageType::IndexType written{ { 49, 36, 0 } }, unwritten{ { 49, 36, 1 } };
+  if (partial->GetPixel(written) != 100 || partial->GetPixel(unwritten) != 7)
+  {
+    std::cout << "Pixels " << written << " and " << unwritten << " are " << partial->GetPixel(written) << " and "
+              << partial->GetPixel(unwritten) << ", expected 100 and 7" << std::endl;
+    return EXIT_FAILURE;
+  }
+  reader = ReaderType::Pointer();
+
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
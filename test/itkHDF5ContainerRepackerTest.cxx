@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerRepacker.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+
+int
+itkHDF5ContainerRepackerTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  // A contiguous dataset repacked into chunks, which are repacked again
+  // into another chunk shape
+  const char * fileNames[] = { "RepackerContiguous.hdf5", "RepackerChunked.hdf5", "RepackerRechunked.hdf5" };
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  ImageType::Pointer image = itk::HDF5ContainerTestHelper::CreateImage(64, 48, 40);
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.75;
+  spacing[2] = 2.0;
+  image->SetSpacing(spacing);
+  ImageType::PointType origin;
+  origin[0] = 10.0;
+  origin[1] = -4.0;
+  origin[2] = 3.5;
+  image->SetOrigin(origin);
+
+  for (auto fileName : fileNames)
+  {
+    itksys::SystemTools::RemoveFile(fileName);
+  }
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    WriterType::Pointer                writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileNames[0]);
+    writer->SetInput(image);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    const std::vector<unsigned int> chunkSizes[] = { { 16, 16, 8 }, { 32, 12, 10 } };
+    for (int i = 0; i < 2; i++)
+    {
+      itk::HDF5ContainerImageIO::Pointer input = itk::HDF5ContainerImageIO::New();
+      input->SetFileName(fileNames[i]);
+
+      itk::HDF5ContainerImageIO::Pointer output = itk::HDF5ContainerImageIO::New();
+      output->SetFileName(fileNames[i + 1]);
+      output->UseCompressionOn();
+      output->SetCompressionLevel(i == 0 ? 6 : 1);
+      output->SetUseShuffle(i == 0);
+      output->UseChunkSizeOn();
+      output->GetChunkSize() = chunkSizes[i];
+
+      itk::HDF5ContainerRepacker::Pointer repacker = itk::HDF5ContainerRepacker::New();
+      repacker->SetInputImageIO(input);
+      repacker->SetOutputImageIO(output);
+      repacker->SetNumberOfWorkUnits(4);
+      repacker->SetMaximumQueuedBytes(16 * 16 * 8 * 2);
+      repacker->Repack();
+    }
+
+    // Each repacked dataset holds the chunks asked for
+    for (int i = 0; i < 2; i++)
+    {
+      itk::HDF5ContainerImageIO::Pointer repacked = itk::HDF5ContainerImageIO::New();
+      repacked->SetFileName(fileNames[i + 1]);
+      repacked->ReadImageInformation();
+      const itk::ImageIORegion chunkRegion(repacked->GetChunkRegion(0));
+      for (unsigned int j = 0; j < 3; j++)
+      {
+        if (chunkRegion.GetSize(j) != chunkSizes[i][j])
+        {
+          std::cout << fileNames[i + 1] << " has chunks of " << chunkRegion << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    reader->SetFileName(fileNames[2]);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerRepackerTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const ImageType::Pointer output(reader->GetOutput());
+  if (output->GetSpacing() != spacing || output->GetOrigin() != origin)
+  {
+    std::cout << "Geometry not preserved, spacing " << output->GetSpacing() << ", origin " << output->GetOrigin()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(output.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  reader = ReaderType::Pointer();
+  for (auto fileName : fileNames)
+  {
+    itk::IOTestHelper::Remove(fileName);
+  }
+
+  return EXIT_SUCCESS;
+}
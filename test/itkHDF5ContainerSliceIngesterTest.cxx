@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerSliceIngester.h"
+#include "itkHDF5ContainerTestHelper.h"
+#include "itkHDF5ContainerZstdFilter.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+int
+itkHDF5ContainerSliceIngesterTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  const char *  fileName("SliceIngester.hdf5");
+  constexpr int numSlices(23);
+  using SliceType = itk::Image<unsigned short, 2>;
+  using ImageType = itk::HDF5ContainerTestHelper::ImageType;
+
+  SliceType::RegionType sliceRegion;
+  sliceRegion.SetSize(0, 40);
+  sliceRegion.SetSize(1, 30);
+
+  SliceType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.25;
+
+  // The slices are written as TIFF files, the last one differs in size
+  std::vector<std::string> sliceFileNames;
+  using SliceWriterType = itk::ImageFileWriter<SliceType>;
+  try
+  {
+    for (int z = 0; z <= numSlices; z++)
+    {
+      SliceType::Pointer    slice = SliceType::New();
+      SliceType::RegionType region(sliceRegion);
+      if (z == numSlices)
+        region.SetSize(0, 41);
+      slice->SetRegions(region);
+      slice->SetSpacing(spacing);
+      slice->Allocate();
+
+      itk::ImageRegionIteratorWithIndex<SliceType> it(slice, region);
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+        it.Set(itk::HDF5ContainerTestHelper::Value(it.GetIndex()[0], it.GetIndex()[1], z));
+      }
+
+      sliceFileNames.push_back("SliceIngester" + std::to_string(z) + ".tif");
+      SliceWriterType::Pointer writer = SliceWriterType::New();
+      writer->SetFileName(sliceFileNames.back());
+      writer->SetInput(slice);
+      writer->Write();
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerSliceIngesterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<std::string> fileNames(sliceFileNames.begin(), sliceFileNames.begin() + numSlices);
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    itksys::SystemTools::RemoveFile(fileName);
+
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->SetFileName(fileName);
+    io->UseCompressionOn();
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 16, 16, 4 };
+
+    // Batches of slices hold whole chunk slabs, the last slab is partial
+    itk::HDF5ContainerSliceIngester::Pointer ingester = itk::HDF5ContainerSliceIngester::New();
+    ingester->SetFileNames(fileNames);
+    ingester->SetOutputImageIO(io);
+    ingester->SetSliceSpacing(2.0);
+    ingester->SetNumberOfWorkUnits(3);
+    ingester->Ingest();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerSliceIngesterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const ImageType::Pointer  volume(reader->GetOutput());
+  const ImageType::SizeType expectedSize{ { 40, 30, numSlices } };
+  if (volume->GetLargestPossibleRegion().GetSize() != expectedSize || volume->GetSpacing()[0] != 0.5 ||
+      volume->GetSpacing()[1] != 0.25 || volume->GetSpacing()[2] != 2.0)
+  {
+    std::cout << "Volume has size " << volume->GetLargestPossibleRegion().GetSize() << " and spacing "
+              << volume->GetSpacing() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!itk::HDF5ContainerTestHelper::CheckImage(volume.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+  reader = ReaderType::Pointer();
+
+  // A slice of other dimensions is refused
+  itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+  io->SetFileName(fileName);
+  io->SetOverwrite(true);
+
+  itk::HDF5ContainerSliceIngester::Pointer ingester = itk::HDF5ContainerSliceIngester::New();
+  ingester->SetFileNames(sliceFileNames);
+  ingester->SetOutputImageIO(io);
+  try
+  {
+    ingester->Ingest();
+    std::cout << "Ingesting slices of other dimensions did not throw" << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const itk::ExceptionObject &)
+  {
+  }
+  ingester = itk::HDF5ContainerSliceIngester::Pointer();
+  io = itk::HDF5ContainerImageIO::Pointer();
+
+  // The dictionary is trained from the first slab of chunks, read before
+  // the region writer creates the dataset
+  if (itk::HDF5ContainerZstdFilter::IsAvailable())
+  {
+    try
+    {
+      io = itk::HDF5ContainerImageIO::New();
+      io->SetFileName(fileName);
+      io->SetOverwrite(true);
+      io->UseCompressionOn();
+      io->UseZstdDictionaryOn();
+      io->SetZstdDictionaryCapacity(1024);
+      io->UseChunkSizeOn();
+      io->GetChunkSize() = { 8, 8, 8 };
+
+      ingester = itk::HDF5ContainerSliceIngester::New();
+      ingester->SetFileNames(fileNames);
+      ingester->SetOutputImageIO(io);
+      ingester->Ingest();
+      ingester = itk::HDF5ContainerSliceIngester::Pointer();
+
+      itk::HDF5ContainerImageIO::Pointer dictionaryIO = itk::HDF5ContainerImageIO::New();
+      dictionaryIO->SetFileName(fileName);
+      dictionaryIO->SetDataSetName((std::string(io->GetDataSetName()) + "_ZstdDictionary").c_str());
+      if (!dictionaryIO->DataSetExists())
+      {
+        std::cout << "The slices were ingested without a Zstandard dictionary" << std::endl;
+        return EXIT_FAILURE;
+      }
+      io = itk::HDF5ContainerImageIO::Pointer();
+
+      reader = ReaderType::New();
+      reader->SetFileName(fileName);
+      reader->Update();
+    }
+    catch (const itk::ExceptionObject & err)
+    {
+      std::cout << "itkHDF5ContainerSliceIngesterTest" << std::endl
+                << "Exception Object caught: " << std::endl
+                << err << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (!itk::HDF5ContainerTestHelper::CheckImage(reader->GetOutput()))
+    {
+      return EXIT_FAILURE;
+    }
+    reader = ReaderType::Pointer();
+  }
+
+  itk::IOTestHelper::Remove(fileName);
+  for (const auto & sliceFileName : sliceFileNames)
+  {
+    itk::IOTestHelper::Remove(sliceFileName.c_str());
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHDF5ContainerTestHelper_h
+#define itkHDF5ContainerTestHelper_h
+
+#include "itkHDF5ContainerImageIO.h"
+#include "itkImage.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <iostream>
+
+namespace itk
+{
+/** \class HDF5ContainerTestHelper
+ *
+ * Fixtures shared by the HDF5Container tests: a test pattern, images
+ * filled with it, and the checks of what was read back against it.
+ */
+class HDF5ContainerTestHelper
+{
+public:
+  using ImageType = Image<unsigned short, 3>;
+
+  /** The test pattern, which differs along every axis so that misplaced
+   * chunks or transposed regions are caught. */
+  template <typename TPixel = unsigned short>
+  static TPixel
+  Value(IndexValueType x, IndexValueType y, IndexValueType z)
+  {
+    return static_cast<TPixel>(x + 2 * y + 3 * z + (x * y * z) % 7);
+  }
+
+  template <typename TPixel = unsigned short, typename TIndex>
+  static TPixel
+  Value(const TIndex & idx)
+  {
+    return Value<TPixel>(idx[0], idx[1], idx[2]);
+  }
+
+  /** An image of the given size, filled with the test pattern. */
+  template <typename TImage = ImageType>
+  static typename TImage::Pointer
+  CreateImage(SizeValueType x, SizeValueType y, SizeValueType z)
+  {
+    typename TImage::RegionType region;
+    region.SetSize(0, x);
+    region.SetSize(1, y);
+    region.SetSize(2, z);
+
+    typename TImage::Pointer image = TImage::New();
+    image->SetRegions(region);
+    image->Allocate();
+
+    ImageRegionIteratorWithIndex<TImage> it(image, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      it.Set(Value<typename TImage::PixelType>(it.GetIndex()));
+    }
+    return image;
+  }
+
+  /** Compares the buffered region of an image with the test pattern and
+   * prints the first pixel which differs. */
+  template <typename TImage>
+  static bool
+  CheckImage(const TImage * image)
+  {
+    ImageRegionConstIteratorWithIndex<TImage> it(image, image->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const typename TImage::PixelType expected(Value<typename TImage::PixelType>(it.GetIndex()));
+      if (it.Get() != expected)
+      {
+        std::cout << "Pixel " << it.GetIndex() << " is " << it.Get() << ", expected " << expected << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Writes an image through the given image IO in streamed divisions. */
+  template <typename TImage>
+  static void
+  WriteImage(const TImage * image, ImageIOBase * io, const char * fileName, unsigned int divisions = 1)
+  {
+    using WriterType = ImageFileWriter<TImage>;
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetNumberOfStreamDivisions(divisions);
+    writer->Write();
+  }
+
+  /** Describes an image of the given size and of the pixel type of
+   * ImageType to an image IO, for tests writing without an image. */
+  static void
+  SetImageInformation(ImageIOBase * io, SizeValueType x, SizeValueType y, SizeValueType z)
+  {
+    io->SetNumberOfDimensions(3);
+    io->SetDimensions(0, x);
+    io->SetDimensions(1, y);
+    io->SetDimensions(2, z);
+    io->SetComponentType(IOComponentEnum::USHORT);
+    io->SetPixelType(IOPixelEnum::SCALAR);
+    io->SetNumberOfComponents(1);
+  }
+
+  /** The slab of depth slices starting at slice z of a 64x48 image. */
+  static ImageIORegion
+  Slab(IndexValueType z, SizeValueType depth)
+  {
+    ImageIORegion region(3);
+    region.SetIndex(0, 0);
+    region.SetIndex(1, 0);
+    region.SetIndex(2, z);
+    region.SetSize(0, 64);
+    region.SetSize(1, 48);
+    region.SetSize(2, depth);
+    return region;
+  }
+};
+} // end namespace itk
+
+#endif // itkHDF5ContainerTestHelper_h
@@ -0,0 +1,253 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ContainerImageIO.h"
+#include "itkHDF5ContainerImageIOFactory.h"
+#include "itkHDF5ContainerRepacker.h"
+#include "itkHDF5ContainerZstdFilter.h"
+#include "itkIOTestHelper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+// Small samples sharing most of their content, as neighbouring chunks do
+std::vector<unsigned char>
+ZstdTestSample(unsigned int index)
+{
+  std::vector<unsigned char> sample(512);
+  for (size_t i = 0; i < sample.size(); i++)
+    sample[i] = static_cast<unsigned char>((i % 64) * 3 + (i * index) % 5);
+  return sample;
+}
+
+bool
+ZstdTestRoundTrip(const std::vector<unsigned char> & data, int level, unsigned int dictionaryId)
+{
+  std::vector<unsigned char> compressed;
+  itk::HDF5ContainerZstdFilter::Compress(data.data(), data.size(), level, dictionaryId, compressed);
+
+  std::vector<unsigned char> decompressed(
+    itk::HDF5ContainerZstdFilter::GetDecompressedSize(compressed.data(), compressed.size()));
+  decompressed.resize(itk::HDF5ContainerZstdFilter::Decompress(
+    compressed.data(), compressed.size(), dictionaryId, decompressed.data(), decompressed.size()));
+  return decompressed == data;
+}
+} // namespace
+
+int
+itkHDF5ContainerZstdFilterTest(int ac, char * av[])
+{
+  std::string prefix("");
+  if (ac > 1)
+  {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+  }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ContainerImageIOFactory::New());
+
+  if (!itk::HDF5ContainerZstdFilter::IsAvailable())
+  {
+    std::cout << "HDF5Container was built without Zstandard support, nothing to test" << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  const char * fileName("ZstdFilter.hdf5");
+  using ImageType = itk::Image<unsigned short, 3>;
+
+  try
+  {
+    // Without a dictionary, at a level deflate does not have
+    const std::vector<unsigned char> data(ZstdTestSample(1000));
+    if (!ZstdTestRoundTrip(data, 19, 0))
+    {
+      std::cout << "Round trip without a dictionary failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::vector<unsigned char> samples;
+    std::vector<size_t>        sampleSizes;
+    for (unsigned int i = 0; i < 200; i++)
+    {
+      const std::vector<unsigned char> sample(ZstdTestSample(i));
+      samples.insert(samples.end(), sample.begin(), sample.end());
+      sampleSizes.push_back(sample.size());
+    }
+    const std::vector<unsigned char> dictionary(
+      itk::HDF5ContainerZstdFilter::TrainDictionary(samples, sampleSizes, 4096));
+    const unsigned int dictionaryId(itk::HDF5ContainerZstdFilter::GetDictionaryId(dictionary));
+    if (dictionaryId == 0)
+    {
+      std::cout << "Unable to train a dictionary" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Two references, the dictionary is only freed with the last one
+    itk::HDF5ContainerZstdFilter::AddDictionary(dictionary);
+    if (!itk::HDF5ContainerZstdFilter::AcquireDictionary(dictionaryId) || !ZstdTestRoundTrip(data, 3, dictionaryId))
+    {
+      std::cout << "Round trip with a dictionary failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    itk::HDF5ContainerZstdFilter::ReleaseDictionary(dictionaryId);
+    if (!itk::HDF5ContainerZstdFilter::HasDictionary(dictionaryId))
+    {
+      std::cout << "The dictionary was freed while still referenced" << std::endl;
+      return EXIT_FAILURE;
+    }
+    itk::HDF5ContainerZstdFilter::ReleaseDictionary(dictionaryId);
+    if (itk::HDF5ContainerZstdFilter::HasDictionary(dictionaryId))
+    {
+      std::cout << "The dictionary was not freed with its last reference" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerZstdFilterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ImageType::RegionType region;
+  region.SetSize(0, 64);
+  region.SetSize(1, 48);
+  region.SetSize(2, 40);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType idx(it.GetIndex());
+    it.Set(static_cast<unsigned short>((idx[0] % 16) * 100 + idx[2]));
+  }
+
+  // The dataset is written and read back through the dictionary filter
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer io = itk::HDF5ContainerImageIO::New();
+    io->UseCompressionOn();
+    io->SetCompressionLevel(12);
+    io->UseZstdDictionaryOn();
+    io->SetZstdDictionaryCapacity(4096);
+    io->UseChunkSizeOn();
+    io->GetChunkSize() = { 8, 8, 8 };
+    if (io->GetCompressionLevel() != 12)
+    {
+      std::cout << "Compression level " << io->GetCompressionLevel() << " was set, expected 12" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->Write();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ContainerImageIO::Pointer();
+
+    reader->SetFileName(fileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerZstdFilterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rit(reader->GetOutput(), region);
+  for (rit.GoToBegin(); !rit.IsAtEnd(); ++rit)
+  {
+    if (rit.Get() != image->GetPixel(rit.GetIndex()))
+    {
+      std::cout << "Pixel " << rit.GetIndex() << " is " << rit.Get() << ", expected "
+                << image->GetPixel(rit.GetIndex()) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The repacker creates the dataset before any region reaches it, the
+  // dictionary is trained from its first layer of tiles beforehand
+  const char * repackedFileName("ZstdFilterRepacked.hdf5");
+  itksys::SystemTools::RemoveFile(repackedFileName);
+  try
+  {
+    itk::HDF5ContainerImageIO::Pointer input = itk::HDF5ContainerImageIO::New();
+    input->SetFileName(fileName);
+
+    itk::HDF5ContainerImageIO::Pointer output = itk::HDF5ContainerImageIO::New();
+    output->SetFileName(repackedFileName);
+    output->UseCompressionOn();
+    output->UseZstdDictionaryOn();
+    output->SetZstdDictionaryCapacity(4096);
+    output->UseChunkSizeOn();
+    output->GetChunkSize() = { 8, 8, 8 };
+
+    itk::HDF5ContainerRepacker::Pointer repacker = itk::HDF5ContainerRepacker::New();
+    repacker->SetInputImageIO(input);
+    repacker->SetOutputImageIO(output);
+    repacker->Repack();
+    repacker = itk::HDF5ContainerRepacker::Pointer();
+
+    itk::HDF5ContainerImageIO::Pointer dictionaryIO = itk::HDF5ContainerImageIO::New();
+    dictionaryIO->SetFileName(repackedFileName);
+    dictionaryIO->SetDataSetName((std::string(output->GetDataSetName()) + "_ZstdDictionary").c_str());
+    if (!dictionaryIO->DataSetExists())
+    {
+      std::cout << "The repacked dataset was written without a Zstandard dictionary" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    reader = ReaderType::New();
+    reader->SetFileName(repackedFileName);
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ContainerZstdFilterTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIteratorWithIndex<ImageType> pit(reader->GetOutput(), region);
+  for (pit.GoToBegin(); !pit.IsAtEnd(); ++pit)
+  {
+    if (pit.Get() != image->GetPixel(pit.GetIndex()))
+    {
+      std::cout << "Repacked pixel " << pit.GetIndex() << " is " << pit.Get() << ", expected "
+                << image->GetPixel(pit.GetIndex()) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  reader = ReaderType::Pointer();
+
+  itk::IOTestHelper::Remove(fileName);
+  itk::IOTestHelper::Remove(repackedFileName);
+  return EXIT_SUCCESS;
+}